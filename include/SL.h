@@ -72,6 +72,7 @@ enum ConfigFile {
 /*! defines for the preference and config files */
 #define CONFIG   "config/"
 #define TERRAINS "terrain/"
+#define MESHES   "meshes/"
 #define PREFS    "prefs/"
 
 /*! defines that are used to parse the config and prefs files */
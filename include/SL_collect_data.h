@@ -29,6 +29,10 @@
 extern "C" {
 #endif
   
+  /* shared variables */
+
+  extern int save_data_flag;
+
   /* shared functions */
   
   void addVarToCollect(char *ptr, const char *name, const char *units, int type, int flag);
@@ -39,6 +39,15 @@ enum RBDParms {
 
 #define N_RBD_PARMS (N_RBDParms-1)
 
+enum ForDynMethods {  //!< forward dynamics methods for SL_ForDynDerivatives
+  FOR_DYN_DEFAULT = 0,
+  FOR_DYN_ART,
+  FOR_DYN_COMP
+};
+
+#define FOR_DYN_DERIV_EPS_FORWARD 1.e-7  //!< default step for forward differences
+#define FOR_DYN_DERIV_EPS_CENTRAL 1.e-5  //!< default step for central differences
+
 /* shared functions */
 
 #ifdef __cplusplus
@@ -57,6 +66,10 @@ extern "C" {
 		     Matrix rbdM, Vector rbdCG);
   void SL_ForwardDynamics(SL_Jstate *lstate,SL_Cstate *cbase,
 			  SL_quat *obase, SL_uext *ux, SL_endeff *leff);
+  int  SL_ForDynDerivatives(SL_Jstate *state, SL_Cstate *cbase, SL_quat *obase, 
+			    SL_uext *ux, SL_endeff *leff, int method, int central, 
+			    double eps, int n_threads, Vector qdd, Matrix dqdd_dq, 
+			    Matrix dqdd_dqd, Matrix dqdd_du);
   void SL_InverseDynamics(SL_Jstate *cstate,SL_DJstate *state,SL_endeff *endeff);
   void SL_InverseDynamicsArt(SL_Jstate *cstate, SL_DJstate *lstate, SL_Cstate *cbase,
 			     SL_quat *obase, SL_uext *ux, SL_endeff *leff);
@@ -71,8 +84,12 @@ extern "C" {
 		    SL_Cstate *cbase, SL_quat *obase);
   void SL_InvDynNEBase(SL_Jstate *cstate, SL_DJstate *lstate, SL_endeff *leff,
 		       SL_Cstate *cbase, SL_quat *obase, double *fbase);
+  void SL_InvDynBatch(int n_states, SL_Jstate **cstates, SL_DJstate **lstates, 
+		      SL_endeff *leff, SL_Cstate *cbases, SL_quat *obases, 
+		      int n_threads);
   void test_NEvsForComp( void );
   void test_ForArtvsForComp( void );
+  int  test_DynamicsTiming(int n_states, char *fname);
   double compute_independent_joint_forces(SL_Jstate state, SL_link li);
 
 
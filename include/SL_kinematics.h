@@ -16,15 +16,18 @@
 #ifndef _SL_kinematics_
 #define _SL_kinematics_
 
-/* external variables */
-
-
-/* shared functions */
-
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+  /* external variables */
+  extern iVector n_link_dofs;    // number of DOFs that move each link
+  extern iMatrix link_dofs;      // the IDs of these DOFs
+  extern iVector n_endeff_dofs;  // number of DOFs that move each endeffector
+  extern iMatrix endeff_dofs;    // the IDs of these DOFs
+
+  /* shared functions */
+
   void   init_kinematics(void);
   void   genJacobian(Vector point, int link, Matrix jop, Matrix jap, Matrix J);
   void   jacobian(Matrix lp, Matrix jop, Matrix jap, Matrix J);
@@ -34,6 +37,9 @@ extern "C" {
   double inverseKinematicsClip(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
 			       Vector cart, iVector status, double dt, double max_rev,
 			       double max_pris);
+  double inverseKinematicsJac(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
+			      Vector cart, iVector status, double dt, double max_rev,
+			      double max_pris, Matrix Jac);
 
   void   linkInformation(SL_Jstate *state,SL_Cstate *basec,
 			 SL_quat *baseo, SL_endeff *eff, 
@@ -51,6 +57,17 @@ extern "C" {
   computeLinkVelocityPoint(int lID, double *point, Matrix lp, Matrix jop, Matrix jap, 
 			   SL_Jstate *js, double *v);
 
+  void 
+  computeLinkVelocities(Matrix lp, Matrix jop, Matrix jap, SL_Jstate *js, 
+			Matrix lw, Matrix lv);
+
+  void 
+  computeLinkPointVelocity(int lID, double *point, Matrix lw, Matrix lv, double *v);
+
+  void 
+  jacobianTimeDerivative(Matrix lp, Matrix jop, Matrix jap, SL_Jstate *js,
+			 Matrix dJ, Matrix dJb);
+
   void 
   computeConstraintJacobian(SL_Jstate *state,SL_Cstate *basec,
 			    SL_quat *baseo, SL_endeff *eff, 
@@ -0,0 +1,67 @@
+/*!=============================================================================
+  ==============================================================================
+
+  \file    SL_meshes.h
+
+  \author
+  \date    Oct 2026
+
+  ==============================================================================
+  \remarks
+
+  declarations needed by SL_meshes.c
+
+  ============================================================================*/
+
+#ifndef _SL_meshes_
+#define _SL_meshes_
+
+#define MESH_LEAF_SIZE 4   //!< max. number of triangles in a leaf of the BVH
+
+typedef struct {         //!< node of the bounding volume hierarchy
+  double    min[3];      //!< lower corner of bounding box
+  double    max[3];      //!< upper corner of bounding box
+  int       left;        //!< index of left child node (-1 for leaves)
+  int       right;       //!< index of right child node (-1 for leaves)
+  int       start;       //!< first triangle of a leaf in the tri array
+  int       count;       //!< number of triangles of a leaf
+} MeshNode;
+
+typedef struct Mesh {    //!< triangle mesh structure
+  char      fname[100];  //!< OBJ file associated with this mesh
+  int       n_v;         //!< number of vertices
+  int       n_f;         //!< number of triangles
+  double   *v;           //!< vertices (x,y,z for each vertex, 0-based)
+  int      *f;           //!< triangles (3 vertex indices each, 0-based)
+  double   *fn;          //!< outward unit normal of each triangle
+  double    radius;      //!< max. distance of a vertex from the mesh origin
+  int       n_nodes;     //!< number of nodes in the BVH
+  MeshNode *nodes;       //!< the BVH, the root is node 0
+  int      *tri;         //!< triangle indices in the order of the BVH leaves
+} Mesh, *MeshPtr;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// global functions
+MeshPtr
+readMesh(char *fname, double *scale);
+void
+freeMesh(MeshPtr mesh);
+int
+checkInsideMesh(MeshPtr mesh, double *x);
+double
+getClosestPointMesh(MeshPtr mesh, double *x, double *c, double *n);
+int
+readObjFile(char *fname, Matrix *v, int *n_v, Matrix *vn, int *n_vn,
+	    iMatrix *f, int *n_f);
+
+// external variables
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SL_meshes_
@@ -32,13 +32,22 @@ typedef struct Object {
   double  *contact_parms;                /*!< contact parameters */
   double  *object_parms;                 /*!< object parameters */
   char   *nptr;                          /*!< pointer to next object */
+  char   *pptr;                          /*!< pointer to previous object */
+  int     handle;                        /*!< handle of object in the object store */
   double  f[N_CART+1];                   /*!< forces acting on object in world coordinates */
   double  t[N_CART+1];                   /*!< torques acting on object in world coordinates */
   int     display_list_active;           /*!< display list for open GL (only for terrains) */
   int     hide;                          /*!< allows hiding the object in the display */
+  double  R[N_CART+1][N_CART+1];         /*!< rotation matrix from global to object coordinates */
+  double  RT[N_CART+1][N_CART+1];        /*!< rotation matrix from object to global coordinates */
+  double  radius;                        /*!< radius of bounding sphere (<0: unbounded) */
+  struct Mesh *mesh;                     /*!< triangle mesh (only for meshes) */
+  int     terrain;                       /*!< handle of the terrain board (only for terrains) */
 } Object, *ObjectPtr;
 
 
+#define NO_OBJECT_HANDLE -1
+
 #define MAX_CONNECTED 25
 
 /*! structure to deal with contact forces */
@@ -99,6 +108,7 @@ extern "C" {
 		       double *scale, Vector cspecs, Vector ospecs);
 
   void       checkContacts(void);
+  int        checkContactsImminent(double dt, double margin);
   void       readObjects(char *fname);
 
   int        changeObjPosByName(char *name, double *pos, double *rot);
@@ -107,9 +117,17 @@ extern "C" {
   int        getObjForcesByName(char *name, double *f, double *t);
 
   void       changeObjPosByPtr(ObjectPtr ptr, double *pos, double *rot);
+  void       updateObjectGeometry(ObjectPtr optr);
   int        getObjForcesByPtr(ObjectPtr ptr, double *f, double *t);
   ObjectPtr  getObjPtrByName(char *name);
 
+  int        getObjHandleByName(char *name);
+  ObjectPtr  getObjPtrByHandle(int handle);
+  int        changeObjPosByHandle(int handle, double *pos, double *rot);
+  int        deleteObjByHandle(int handle);
+  int        changeHideObjByHandle(int handle, int hide);
+  int        getObjForcesByHandle(int handle, double *f, double *t);
+
   int        read_extra_contact_points(char *fname);
   void       computeContactPoint(ContactPtr cptr, double **lp, double ***al, double *x);
 
@@ -21,11 +21,13 @@
 #define SPHERE       2
 #define TERRAIN      3
 #define CYLINDER     4
+#define MESH         5
 
 #define N_CUBE_PARMS         0
 #define N_SPHERE_PARMS       1
 #define N_TERRAIN_PARMS      0
 #define N_CYLINDER_PARMS     1
+#define N_MESH_PARMS         0
 
 /*! possible contact models */
 #define NO_CONTACT                       0
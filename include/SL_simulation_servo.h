@@ -33,6 +33,8 @@ extern "C" {
   extern int     n_integration;
   extern int     integrate_method;
   extern int     real_time;
+  extern int     n_integration_coarse;
+  extern double  multi_rate_dist_margin;
 
   // shared functions
   int  init_simulation_servo(void);
@@ -24,6 +24,17 @@
 #define INVDYNSERVO 2
 #define CARTSERVO   3
 
+/* kinematic variables computed by update_kinematics() */
+#define KIN_STATE         1   //!< link information, cart_state.x, cart_orient.q
+#define KIN_DES_STATE     2   //!< link information, cart_des_state.x, cart_des_orient.q
+#define KIN_COG           4   //!< cog and cog_des positions
+#define KIN_JACOBIAN      8   //!< J and Jbase
+#define KIN_DES_JACOBIAN  16  //!< Jdes and Jbasedes
+#define KIN_JACOBIAN_DT   32  //!< dJdt and dJbasedt
+#define KIN_CART_VEL      64  //!< velocities and accelerations of cart_state/orient
+#define KIN_DES_CART_VEL  128 //!< velocities of cart_des_state/orient
+#define KIN_ALL           255
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -77,6 +88,8 @@ extern "C" {
   void scdMotor(void);
   void toggleShowAxes(int status);
   void broadcastEndeffector(SL_endeff *eff);
+  void update_kinematics(int flags);
+  void lazyKinematics(int flag);
 
   
 #ifdef __cplusplus
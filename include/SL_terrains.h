@@ -16,11 +16,122 @@
 #ifndef _SL_terrains_
 #define _SL_terrains_
 
-#define MAX_TERRAINS 5
+// terrain boards are allocated in blocks as needed, up to MAX_TERRAINS boards
+#define TERRAIN_BLOCK_SIZE 16
+#define MAX_TERRAIN_BLOCKS 256
+#define MAX_TERRAINS (TERRAIN_BLOCK_SIZE*MAX_TERRAIN_BLOCKS)
+#define NO_TERRAIN_HANDLE 0
+
+// cell size of the spatial index over the terrain boards (can grow for large boards)
+#define TERRAIN_INDEX_CELL_SIZE 0.25
+
+// binary terrain grid files: a TerrainGridHeader followed by the layers, 
+// each stored as nx*ny floats with the y index running fastest
+#define TERRAIN_GRID_EXT     ".grid"
+#define TERRAIN_GRID_MAGIC   "SLTGRID"
+#define TERRAIN_GRID_VERSION 1
+#define TERRAIN_GRID_ALIGN   64   //!< alignment of the layers in the file
+
+enum TerrainGridLayers {
+  TG_Z = 0,                //!< height in local board coordinates
+  TG_NO_GO,                //!< go/no-go information
+  TG_CN_X,                 //!< x component of contact normal
+  TG_CN_Y,                 //!< y component of contact normal
+  TG_CN_Z,                 //!< z component of contact normal
+  TG_FZ,                   //!< foot placement height
+  TG_PZ,                   //!< predicted height from regression
+  TG_N_X,                  //!< x component of normal
+  TG_N_Y,                  //!< y component of normal
+  TG_N_Z,                  //!< z component of normal
+  TG_N_NMSE,               //!< nMSE of normals
+  TERRAIN_GRID_N_LAYERS
+};
+
+typedef struct {         //!< header of a binary terrain grid file
+  char      magic[8];    //!< TERRAIN_GRID_MAGIC
+  int       version;     //!< TERRAIN_GRID_VERSION
+  int       byte_order;  //!< 0x01020304 in the byte order of the writer
+  int       header_size; //!< size of the header in bytes
+  int       nx;          //!< number of states in x direction
+  int       ny;          //!< number of states in y direction
+  int       reg_rad;     //!< regression radius of the foothold layers
+  int       reg_down;    //!< down sampling of the foothold layers
+  int       reg_crad;    //!< regression radius of the contact normal layers
+  double    dx;          //!< delta x of terrain grid
+  double    dy;          //!< delta y of terrain grid
+  double    dxorg;       //!< x-offset of Z(1,1) relative to local origin on board
+  double    dyorg;       //!< y-offset of Z(1,1) relative to local origin on board
+  long long offset[TERRAIN_GRID_N_LAYERS]; //!< file offset of each layer (0: missing)
+} TerrainGridHeader;
+
+// tiled terrain files for streaming: a TerrainTilesHeader followed by the tiles
+// of the terrain grid in world orientation and the tiles of the contact grid. 
+// Each tile has TERRAIN_STREAM_TILE x TERRAIN_STREAM_TILE cells of all layers,
+// with the y index running fastest, and the tiles are ordered with the x tile 
+// index running fastest.
+#define TERRAIN_TILES_EXT      ".tiles"
+#define TERRAIN_TILES_MAGIC    "SLTTILE"
+#define TERRAIN_TILES_VERSION  1
+#define TERRAIN_TILES_ALIGN    4096 //!< alignment of the tiles in the file
+#define TERRAIN_STREAM_TILE    64   //!< cells per tile side
+#define TERRAIN_TILE_CACHE_MB  256  //!< default memory budget of the tile cache
+
+enum TerrainTileLayers {
+  TT_Z = 0,                //!< height relative to the board origin
+  TT_NO_GO,                //!< go/no-go information
+  TT_FZ,                   //!< foot placement height relative to the board origin
+  TT_PZ,                   //!< predicted height relative to the board origin
+  TT_N_X,                  //!< x component of normal
+  TT_N_Y,                  //!< y component of normal
+  TT_N_Z,                  //!< z component of normal
+  TT_N_NMSE,               //!< nMSE of normals
+  TERRAIN_TILE_N_LAYERS
+};
+
+enum TerrainContactTileLayers {
+  TT_C_Z = 0,              //!< height in local board coordinates
+  TT_C_NO_GO,              //!< go/no-go information
+  TT_CN_X,                 //!< x component of contact normal
+  TT_CN_Y,                 //!< y component of contact normal
+  TT_CN_Z,                 //!< z component of contact normal
+  TERRAIN_CTILE_N_LAYERS
+};
+
+typedef struct {         //!< header of a tiled terrain file
+  char      magic[8];    //!< TERRAIN_TILES_MAGIC
+  int       version;     //!< TERRAIN_TILES_VERSION
+  int       byte_order;  //!< 0x01020304 in the byte order of the writer
+  int       header_size; //!< size of the header in bytes
+  int       tile_size;   //!< TERRAIN_STREAM_TILE of the writer
+  int       nx;          //!< number of states in x direction
+  int       ny;          //!< number of states in y direction
+  int       padx;        //!< amount of padding in x
+  int       pady;        //!< amount of padding in y
+  int       c_nx;        //!< number of states in x direction for contact checking
+  int       c_ny;        //!< number of states in y direction for contact checking
+  int       c_padx;      //!< amount of padding in x for contacts
+  int       c_pady;      //!< amount of padding in y for contacts
+  int       reg_rad;     //!< radius used for regression on terrain
+  int       reg_down;    //!< down sampling for computing the regression
+  int       reg_crad;    //!< regression radius used for contact checking
+  double    dx;          //!< delta x of terrain grid
+  double    dy;          //!< delta y of terrain grid
+  double    xorg;        //!< x origin of the terrain grid relative to the board origin
+  double    yorg;        //!< y origin of the terrain grid relative to the board origin
+  double    c_dxorg;     //!< x-offset of the contact grid relative to the board origin
+  double    c_dyorg;     //!< y-offset of the contact grid relative to the board origin
+  double    min_z;       //!< min z on terrain relative to the board origin
+  double    max_z;       //!< max z on terrain relative to the board origin
+  double    c_max_z;     //!< max z of the contact grid without padding
+  double    ground_z;    //!< ground height relative to the board origin of the padding
+  long long offset;      //!< file offset of the tiles of the terrain grid
+  long long c_offset;    //!< file offset of the tiles of the contact grid
+} TerrainTilesHeader;
 
 typedef struct {         //!< terrain board structure
   int       status;      //!< TRUE or FALSE for active or inactive
   int       ID;          //!< terrain identifier
+  int       gen;         //!< generation of the slot, which invalidates old handles
   char      tfname[100]; //!< terrain file associated with this terrain
   char      tfnasc[100]; //!< terrain file name with .asc appended
   SL_Cstate pos;         //!< origin of terrain in world coordinates (from Vicon)
@@ -35,6 +146,7 @@ typedef struct {         //!< terrain board structure
   double    dy;          //!< delta y of terrain grid
   double    min_z;       //!< min z on terrain
   double    max_z;       //!< max z on terrain
+  double    c_max_z;     //!< max z of terrain for contact checking
   int       nx_local;    //!< number of states in x direction local board
   int       ny_local;    //!< number of states in y direction local board
   int       c_nx;        //!< number of states in x direction for contact checking
@@ -66,6 +178,18 @@ typedef struct {         //!< terrain board structure
   fMatrix   no_go;       //!< matrix of go/no-go information
   iMatrix   cached;      //!< indicator matrix with TRUE/FALSE whether terrain info is cached
   iMatrix   ccached;     //!< indicator matrix with TRUE/FALSE whether terrain contact info is cached
+  int       n_tx;        //!< number of cache tiles in x direction
+  int       n_ty;        //!< number of cache tiles in y direction
+  int       c_n_tx;      //!< number of cache tiles in x direction for contacts
+  int       c_n_ty;      //!< number of cache tiles in y direction for contacts
+  int      *tiles;       //!< caching state of each tile of the terrain grid
+  int      *ctiles;      //!< caching state of each tile of the contact grid
+  int       n_tiles_done;//!< number of tiles that are cached
+  struct TerrainSAT *sat;   //!< summed-area tables for the regression on z
+  struct TerrainSAT *c_sat; //!< summed-area tables for the regression on c_z
+  struct TerrainGrid *grid; //!< memory mapped terrain grid file (NULL if none)
+  struct TerrainStream *stream; //!< streamed tiled terrain file (NULL if none)
+  struct TerrainCompact *compact; //!< compact layers (NULL if none)
 } Terrain;
 
 // a useful structure for terrain information
@@ -82,6 +206,23 @@ typedef struct {        //!< terrain board structure
   int       in_padding; //!< TRUE/FALSE for in padding
 } TerrainInfo;
 
+// terrain information of a batch of query points as struct of arrays, indexed
+// from 1 to the number of points. Arrays that are NULL are not filled in.
+typedef struct {
+  double   *z;          //!< height above ground at query points
+  double   *pz;         //!< predicted height above ground from regression
+  double   *fz;         //!< height used for foot placement
+  double   *n_x;        //!< x component of normal at query points
+  double   *n_y;        //!< y component of normal at query points
+  double   *n_z;        //!< z component of normal at query points
+  double   *n_nMSE;     //!< nMSE of normal fitting
+  double   *slope;      //!< the slope as absolute angle relative to horizontal
+  double   *no_go;      //!< in [1,0], where 1 is bad, 0 is fine.
+  int      *ID;         //!< terrain ID
+  int      *in_padding; //!< TRUE/FALSE for in padding
+  int      *found;      //!< TRUE/FALSE for data found in terrains
+} TerrainInfoBatch;
+
 
 
 #ifdef __cplusplus
@@ -99,13 +240,26 @@ getTerrainInfo(double x, double y, TerrainInfo *tinfo);
 int
 getTerrainInfoZOnly(double x, double y, TerrainInfo *tinfo);
 int
+getTerrainInfoBatch(int n_points, double *x, double *y, int n_threads,
+		    TerrainInfoBatch *tinfo);
+int
 getNextTerrainID(void);
 int
 getContactTerrainInfo(double x, double y, char *tfname, double *z, double *n, double *no_go);
+int
+getContactTerrainHandle(char *tfname);
+int
+getContactTerrainInfoByHandle(int h, double x, double y, double *z, double *n, double *no_go);
+void
+loadContactTerrainTiles(int h, double x_min, double x_max, double y_min, double y_max);
 void
 setTerrainGroundZ(double z);
 void
 cacheTerrainInfo(void);
+int
+getTerrainCacheProgress(int ID, double *progress);
+int
+waitForTerrainCache(double x_min, double x_max, double y_min, double y_max);
 void
 fillTerrainPadding(void);
 int
@@ -127,11 +281,34 @@ getTerrainWorldCoordinatesID(double xl, double yl, double zl, int tID,
 int
 getContactTerrainMinMax(char *tfname,
 			double *x_min, double *x_max, double *y_min, double *y_max);
+int
+getContactTerrainMaxZ(char *tfname, double *z_max);
+int
+getContactTerrainMaxZByHandle(int h, double *z_max);
+int
+convertTerrainBoard(char *tfname, int reg_rad, int reg_down, int reg_crad);
+int
+addTerrainBoard(char *tfname, double *pos, double *orient,
+		int reg_rad, int reg_down, int reg_crad);
+int
+removeTerrainBoard(int ID);
+int
+removeTerrainBoardByHandle(int h);
+Terrain *
+getTerrainPtr(int ID);
+int
+convertTerrainTiles(char *tfname, int reg_rad, int reg_down, int reg_crad);
+void
+setTerrainTileCacheSize(double mbytes);
+int
+compactTerrainBoard(int ID);
 
 // external variables
+// Note: the array terrains[MAX_TERRAINS+1] was removed, as the terrain boards
+// are allocated in blocks. Use getTerrainPtr(ID) instead of &terrains[ID],
+// which returns NULL for indices without an allocated board.
 extern double terrain_bounding_box_max[];
 extern double terrain_bounding_box_min[];
-extern Terrain terrains[MAX_TERRAINS+1];
 
 #ifdef __cplusplus
 }
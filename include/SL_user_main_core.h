@@ -3,6 +3,7 @@ char argv_array[100][50];
 char *argv_ptr[100];
 char start_task[50];
 int  graphics_flag = TRUE;
+int  headless_flag = FALSE;
 int  hold_flag = FALSE;
 int  ros_flag = FALSE;
 char string[100];
@@ -27,16 +28,39 @@ int  display_height;
 // init the parameter pool
 init_parameter_pool();
 
-// connect to X server using the DISPLAY environment variable
-if ( (display=XOpenDisplay(NULL)) == NULL ) {
-  printf("Cannot connect to X servo %s\n",XDisplayName(NULL));
-  exit(-1);
- }
+// check for no-graphics flag
+for (i=1; i<argc; ++i)
+  if (strcmp(argv[i],"-ng")==0 ||  strcmp(argv[i],"-no-graphics")==0)
+    graphics_flag = FALSE;
+
+// check for headless flag: no graphics, no X server, and no xterms, e.g.,
+// for batch simulations on compute nodes
+for (i=1; i<argc; ++i)
+  if (strcmp(argv[i],"-headless")==0) {
+    headless_flag = TRUE;
+    graphics_flag = FALSE;
+  }
+
+if (!headless_flag) {
+
+  // connect to X server using the DISPLAY environment variable
+  if ( (display=XOpenDisplay(NULL)) == NULL ) {
+    printf("Cannot connect to X servo %s\n",XDisplayName(NULL));
+    exit(-1);
+  }
+
+  // get screen size from display structure macro 
+  screen_num = DefaultScreen(display);
+  display_width = DisplayWidth(display, screen_num);
+  display_height = DisplayHeight(display, screen_num);
+
+} else {
 
-// get screen size from display structure macro 
-screen_num = DefaultScreen(display);
-display_width = DisplayWidth(display, screen_num);
-display_height = DisplayHeight(display, screen_num);
+  display = NULL;
+  display_width = 1920;
+  display_height = 1080;
+
+}
 
 // assign the servo_name variable with the calling program as default
 sprintf(servo_name,"%s",argv[0]);
@@ -44,11 +68,6 @@ sprintf(servo_name,"%s",argv[0]);
 // NOTE: the sequence of initialization of the servos
 //       is important for the initial semaphore synchronization
 
-// check for no-graphics flag
-for (i=1; i<argc; ++i)
-  if (strcmp(argv[i],"-ng")==0 ||  strcmp(argv[i],"-no-graphics")==0)
-    graphics_flag = FALSE;
-
 // check if starting task flag
 // i.e. task that must start along with SL
 strcmp(start_task,"");
@@ -84,23 +103,29 @@ parent_process_id = getpid();
 setRealRobotOptions() ;
 
 // build the command array
-sprintf(argv_array[c++],"xterm");
-sprintf(argv_array[c++],"-wf");
-sprintf(argv_array[c++],"-leftbar");
-sprintf(argv_array[c++],"-geometry");
-geometry_argv = c;
-sprintf(argv_array[c++],"90x10+0+0");
-sprintf(argv_array[c++],"-bg");
-background_argv = c;
-sprintf(argv_array[c++],"red");
-sprintf(argv_array[c++],"-fg");
-sprintf(argv_array[c++],"black");
-if (hold_flag)
-  sprintf(argv_array[c++],"-hold");
-sprintf(argv_array[c++],"-title");
-title_argv = c;
-sprintf(argv_array[c++],"%s",argv[0]);
-sprintf(argv_array[c++],"-e");
+if (!headless_flag) {
+  sprintf(argv_array[c++],"xterm");
+  sprintf(argv_array[c++],"-wf");
+  sprintf(argv_array[c++],"-leftbar");
+  sprintf(argv_array[c++],"-geometry");
+  geometry_argv = c;
+  sprintf(argv_array[c++],"90x10+0+0");
+  sprintf(argv_array[c++],"-bg");
+  background_argv = c;
+  sprintf(argv_array[c++],"red");
+  sprintf(argv_array[c++],"-fg");
+  sprintf(argv_array[c++],"black");
+  if (hold_flag)
+    sprintf(argv_array[c++],"-hold");
+  sprintf(argv_array[c++],"-title");
+  title_argv = c;
+  sprintf(argv_array[c++],"%s",argv[0]);
+  sprintf(argv_array[c++],"-e");
+} else {
+  // the servos are started without xterm -- the xterm specific
+  // arguments point to an unused scratch entry of the array
+  geometry_argv = background_argv = title_argv = 99;
+}
 sprintf(argv_array[c++],"env");
 sprintf(argv_array[c++],"LD_LIBRARY_PATH=%s",getenv("LD_LIBRARY_PATH"));
 sprintf(argv_array[c++],"nice");
@@ -111,7 +136,9 @@ servo_argv = c;
 sprintf(argv_array[c++],"xdummy");
 sprintf(argv_array[c++],"-pid");
 sprintf(argv_array[c++],"%d",parent_process_id);
-if (!graphics_flag) 
+if (headless_flag) 
+  sprintf(argv_array[c++],"-headless");
+else if (!graphics_flag) 
   sprintf(argv_array[c++],"-ng");
 if (strcmp(start_task,"")!=0){
   sprintf(argv_array[c++],"-task");
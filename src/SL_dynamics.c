@@ -17,11 +17,17 @@
 
 // SL general includes of system headers
 #include "SL_system_headers.h"
+#include <time.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAS_MALLINFO2
+#endif
 
 /* private includes */
 #include "SL.h"
 #include "SL_common.h"
 #include "SL_dynamics.h"
+#include "SL_kinematics.h"
 #include "utility.h"
 #include "utility_macros.h"
 
@@ -31,9 +37,71 @@ double freeze_base_pos[N_CART+1] = {0.0,0.0,0.0,0.0};
 double freeze_base_quat[N_QUAT+1] = {0.0,1.0,0.0,0.0,0.0};
 double coulomb_slope = 10.0;
 
+// local types
+typedef struct {          //!< a part of the states of SL_InvDynBatch for a thread
+  int          n_states;  //!< number of states of the part
+  SL_Jstate  **cstates;   //!< current states of the part (1 to n_states, or NULL)
+  SL_DJstate **lstates;   //!< desired states of the part (1 to n_states)
+  SL_endeff   *leff;      //!< the endeffector parameters
+  SL_Cstate   *cbases;    //!< base positions of the part (1 to n_states)
+  SL_quat     *obases;    //!< base orientations of the part (1 to n_states)
+} InvDynBatch;
+
+typedef struct {          //!< a part of the columns of SL_ForDynDerivatives for a thread
+  int          method;    //!< FOR_DYN_ART or FOR_DYN_COMP
+  int          central;   //!< TRUE for central differences
+  double       eps;       //!< finite difference step
+  int          n_q;       //!< number of columns of dqdd_dq (0 if not requested)
+  int          n_qd;      //!< number of columns of dqdd_dqd (0 if not requested)
+  SL_Jstate   *state;     //!< the state around which the derivatives are taken
+  SL_Cstate   *cbase;     //!< the base position state
+  SL_quat     *obase;     //!< the base orientation state
+  SL_uext     *ux;        //!< the external forces
+  SL_endeff   *leff;      //!< the endeffector parameters
+  double      *qdd0;      //!< the accelerations at the state (1 to n_q)
+  Matrix       dqdd_dq;   //!< output derivatives w.r.t. positions
+  Matrix       dqdd_dqd;  //!< output derivatives w.r.t. velocities
+  Matrix       dqdd_du;   //!< output derivatives w.r.t. joint commands
+  int          start;     //!< first column of the part
+  int          end;       //!< last column of the part plus one
+} ForDynDerivBatch;
+
 // local variables
 static int forward_dynamics_comp_flag = FALSE;
 
+// the methods timed by test_DynamicsTiming
+enum DynTimingMethods {
+  TIME_FOR_DYN_ART = 1,
+  TIME_FOR_DYN_COMP,
+  TIME_INV_DYN_NE,
+  TIME_INV_DYN_ART,
+  TIME_LINK_INFORMATION,
+  TIME_JACOBIAN,
+
+  N_DYN_TIMING_METHODS
+};
+
+static char dyn_timing_names[][30] = {
+  "dummy",
+  "SL_ForDynArt",
+  "SL_ForDynComp",
+  "SL_InvDynNE",
+  "SL_InvDynArt",
+  "linkInformation",
+  "jacobian"
+};
+
+// local functions
+static void *invDynBatchThread(void *dptr);
+static void *forDynDerivThread(void *dptr);
+static void  forDynAccelerations(int method, SL_Jstate *js, SL_Cstate *bs, SL_quat *bo,
+				 SL_uext *ux, SL_endeff *leff, double *qdd);
+static void  perturbForDynState(int block, int j, double delta, SL_Jstate *js, 
+				SL_Cstate *bs, SL_quat *bo);
+static int   compareDoubles(const void *a, const void *b);
+static long  timeStampNs(void);
+static long  heapBytesInUse(void);
+
 
 /*!*****************************************************************************
 *******************************************************************************
@@ -146,6 +214,117 @@ SL_InvDyn(SL_Jstate *cstate, SL_DJstate *lstate, SL_endeff *leff,
     SL_InvDynNE(cstate, lstate, leff, cbase, obase);
 }
 
+/*!*****************************************************************************
+*******************************************************************************
+\note  SL_InvDynBatch
+\date  Oct 2026
+
+\remarks 
+
+Inverse dynamics for a sequence of states, e.g., all rows of a trajectory,
+with the same results as SL_InvDyn for every state. The states are split 
+into equal parts for n_threads threads, and every thread calls SL_InvDyn
+for the states of its part. SL_InvDyn creates its inverse dynamics instance
+on the stack of every call, such that the threads share no temporaries.
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+\param[in]     n_states  : number of states
+\param[in]     cstates   : the current states (1 to n_states, or NULL to use
+                            only the desired states)
+\param[in,out] lstates   : the desired states (1 to n_states)
+\param[in]     endeff    : the endeffector parameters
+\param[in,out] cbases    : the position states of the base (1 to n_states)
+\param[in,out] obases    : the orientational states of the base (1 to n_states)
+\param[in]     n_threads : number of threads (1: calling thread only)
+
+Returns:
+The appropriate feedforward torques are added in the uff component of the 
+lstates structures.
+
+******************************************************************************/
+void 
+SL_InvDynBatch(int n_states, SL_Jstate **cstates, SL_DJstate **lstates, 
+	       SL_endeff *leff, SL_Cstate *cbases, SL_quat *obases, int n_threads)
+{
+  int          i,start;
+  InvDynBatch *batch;
+  pthread_t   *threads;
+  int         *started;
+
+  if (n_states < 1)
+    return;
+
+  if (n_threads > n_states)
+    n_threads = n_states;
+  if (n_threads < 1)
+    n_threads = 1;
+
+  batch   = (InvDynBatch *)my_calloc(n_threads,sizeof(InvDynBatch),MY_STOP);
+  threads = (pthread_t *)my_calloc(n_threads,sizeof(pthread_t),MY_STOP);
+  started = (int *)my_calloc(n_threads,sizeof(int),MY_STOP);
+
+  // the arrays of every part are shifted such that they start at index 1
+  for (i=0; i<n_threads; ++i) {
+    start = (int)(((long long)i*n_states)/n_threads);
+    batch[i].n_states = (int)(((long long)(i+1)*n_states)/n_threads) - start;
+    batch[i].cstates  = (cstates != NULL) ? cstates+start : NULL;
+    batch[i].lstates  = lstates+start;
+    batch[i].leff     = leff;
+    batch[i].cbases   = cbases+start;
+    batch[i].obases   = obases+start;
+  }
+
+  for (i=1; i<n_threads; ++i)
+    started[i] = (pthread_create(&threads[i],NULL,invDynBatchThread,
+				 (void *)&batch[i]) == 0);
+
+  // the calling thread processes the first part, and the parts of threads
+  // that could not be started
+  invDynBatchThread((void *)&batch[0]);
+  for (i=1; i<n_threads; ++i)
+    if (!started[i])
+      invDynBatchThread((void *)&batch[i]);
+
+  for (i=1; i<n_threads; ++i)
+    if (started[i])
+      pthread_join(threads[i],NULL);
+
+  free(batch);
+  free(threads);
+  free(started);
+
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  invDynBatchThread
+\date  Oct 2026
+
+\remarks 
+
+computes the inverse dynamics of a part of the states of SL_InvDynBatch
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+\param[in,out] dptr    : the InvDynBatch with the part of the states
+
+******************************************************************************/
+static void *
+invDynBatchThread(void *dptr)
+{
+  InvDynBatch *b = (InvDynBatch *)dptr;
+  int          k;
+
+  for (k=1; k<=b->n_states; ++k)
+    SL_InvDyn((b->cstates != NULL) ? b->cstates[k] : NULL, b->lstates[k], 
+	      b->leff, &(b->cbases[k]), &(b->obases[k]));
+
+  return NULL;
+}
+
 /*!*****************************************************************************
 *******************************************************************************
 \note  SL_InverseDynamics
@@ -256,6 +435,339 @@ SL_ForDyn(SL_Jstate *lstate,SL_Cstate *cbase,
 
 }
 
+/*!*****************************************************************************
+ *******************************************************************************
+\note  SL_ForDynDerivatives
+\date  Oct 2026
+   
+\remarks 
+
+computes the derivatives of the forward dynamics accelerations with respect
+to positions, velocities, and joint commands by finite differences, e.g., for
+model predictive control. The generalized coordinates are the DOFs, followed
+for floating base robots by the base position and the base orientation. The
+orientation is perturbed by small rotations about the world axes, such that
+its derivatives match the angular velocities and accelerations of the base
+in world coordinates. The perturbed forward dynamics are split over
+n_threads threads (the calling thread included), each with its own copy of
+the state and its own instances of the forward dynamics. No memory is 
+allocated besides the thread stacks. The given state is not changed.
+
+With n = n_dofs (+6 for a floating base), the outputs are
+
+dqdd_dq[1..n][1..n], dqdd_dqd[1..n][1..n], dqdd_du[1..n][1..n_dofs]
+
+where every output can be NULL if it is not needed.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     state    : the joint state with th, thd, and u
+ \param[in]     cbase    : the position state of the base
+ \param[in]     obase    : the orientational state of the base
+ \param[in]     ux       : the external forces acting on each joint (NULL: none)
+ \param[in]     endeff   : the endeffector parameters
+ \param[in]     method   : FOR_DYN_ART, FOR_DYN_COMP, or FOR_DYN_DEFAULT for
+                           the method of SL_ForDyn
+ \param[in]     central  : TRUE for central, FALSE for forward differences
+ \param[in]     eps      : finite difference step (<= 0: default step)
+ \param[in]     n_threads: number of threads (1: calling thread only)
+ \param[out]    qdd      : the accelerations at the state (1..n, or NULL)
+ \param[out]    dqdd_dq  : derivatives w.r.t. positions (or NULL)
+ \param[out]    dqdd_dqd : derivatives w.r.t. velocities (or NULL)
+ \param[out]    dqdd_du  : derivatives w.r.t. joint commands (or NULL)
+
+ returns TRUE on success, FALSE otherwise
+
+ ******************************************************************************/
+int
+SL_ForDynDerivatives(SL_Jstate *state, SL_Cstate *cbase, SL_quat *obase, 
+		     SL_uext *ux, SL_endeff *leff, int method, int central, 
+		     double eps, int n_threads, Vector qdd, Matrix dqdd_dq, 
+		     Matrix dqdd_dqd, Matrix dqdd_du)
+{
+  int          i;
+  int          n = n_dofs + (floating_base_flag ? 2*N_CART : 0);
+  int          n_q, n_qd, n_u, n_cols;
+  double       qdd0[n+1];
+  SL_Jstate    js[n_dofs+1];
+  SL_Cstate    bs;
+  SL_quat      bo;
+  SL_uext      ux0[n_dofs+1];
+
+  if (method == FOR_DYN_DEFAULT)
+    method = forward_dynamics_comp_flag ? FOR_DYN_COMP : FOR_DYN_ART;
+
+  if (method != FOR_DYN_ART && method != FOR_DYN_COMP) {
+    printf("Unknown forward dynamics method %d\n",method);
+    return FALSE;
+  }
+
+  if (eps <= 0)
+    eps = central ? FOR_DYN_DERIV_EPS_CENTRAL : FOR_DYN_DERIV_EPS_FORWARD;
+
+  if (ux == NULL) {
+    bzero((void *)ux0,sizeof(ux0));
+    ux = ux0;
+  }
+
+  // the accelerations at the state
+  for (i=1; i<=n_dofs; ++i)
+    js[i] = state[i];
+  bs = *cbase;
+  bo = *obase;
+  forDynAccelerations(method,js,&bs,&bo,ux,leff,qdd0);
+
+  if (qdd != NULL)
+    for (i=1; i<=n; ++i)
+      qdd[i] = qdd0[i];
+
+  // the columns of all requested outputs
+  n_q    = (dqdd_dq  != NULL) ? n : 0;
+  n_qd   = (dqdd_dqd != NULL) ? n : 0;
+  n_u    = (dqdd_du  != NULL) ? n_dofs : 0;
+  n_cols = n_q + n_qd + n_u;
+
+  if (n_cols == 0)
+    return TRUE;
+
+  if (n_threads > n_cols)
+    n_threads = n_cols;
+  if (n_threads < 1)
+    n_threads = 1;
+
+  {
+    ForDynDerivBatch batch[n_threads];
+    pthread_t        threads[n_threads];
+    int              started[n_threads];
+
+    for (i=0; i<n_threads; ++i) {
+      batch[i].method   = method;
+      batch[i].central  = central;
+      batch[i].eps      = eps;
+      batch[i].n_q      = n_q;
+      batch[i].n_qd     = n_qd;
+      batch[i].state    = state;
+      batch[i].cbase    = cbase;
+      batch[i].obase    = obase;
+      batch[i].ux       = ux;
+      batch[i].leff     = leff;
+      batch[i].qdd0     = qdd0;
+      batch[i].dqdd_dq  = dqdd_dq;
+      batch[i].dqdd_dqd = dqdd_dqd;
+      batch[i].dqdd_du  = dqdd_du;
+      batch[i].start    = (i*n_cols)/n_threads;
+      batch[i].end      = ((i+1)*n_cols)/n_threads;
+      started[i]        = FALSE;
+    }
+
+    for (i=1; i<n_threads; ++i)
+      started[i] = (pthread_create(&threads[i],NULL,forDynDerivThread,
+				   (void *)&batch[i]) == 0);
+
+    // the calling thread processes the first part, and the parts of threads
+    // that could not be started
+    forDynDerivThread((void *)&batch[0]);
+    for (i=1; i<n_threads; ++i)
+      if (!started[i])
+	forDynDerivThread((void *)&batch[i]);
+
+    for (i=1; i<n_threads; ++i)
+      if (started[i])
+	pthread_join(threads[i],NULL);
+  }
+
+  return TRUE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  forDynDerivThread
+\date  Oct 2026
+   
+\remarks 
+
+computes a part of the columns of SL_ForDynDerivatives. The columns are
+numbered over all requested outputs, i.e., first the columns of dqdd_dq,
+then the columns of dqdd_dqd, and then the columns of dqdd_du.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out] dptr    : the ForDynDerivBatch with the part of the columns
+
+ ******************************************************************************/
+static void *
+forDynDerivThread(void *dptr)
+{
+  ForDynDerivBatch *b = (ForDynDerivBatch *)dptr;
+  int          i,c,j;
+  int          block;
+  int          n = n_dofs + (floating_base_flag ? 2*N_CART : 0);
+  double       qddp[n+1];
+  double       qddm[n+1];
+  SL_Jstate    js[n_dofs+1];
+  SL_Cstate    bs;
+  SL_quat      bo;
+  Matrix       D;
+
+  for (c=b->start; c<b->end; ++c) {
+
+    // the output and the column of this column number
+    if (c < b->n_q) {
+      block = 1;
+      j     = c+1;
+      D     = b->dqdd_dq;
+    } else if (c < b->n_q + b->n_qd) {
+      block = 2;
+      j     = c+1-b->n_q;
+      D     = b->dqdd_dqd;
+    } else {
+      block = 3;
+      j     = c+1-b->n_q-b->n_qd;
+      D     = b->dqdd_du;
+    }
+
+    for (i=1; i<=n_dofs; ++i)
+      js[i] = b->state[i];
+    bs = *b->cbase;
+    bo = *b->obase;
+    perturbForDynState(block,j,b->eps,js,&bs,&bo);
+    forDynAccelerations(b->method,js,&bs,&bo,b->ux,b->leff,qddp);
+
+    if (b->central) {
+      for (i=1; i<=n_dofs; ++i)
+	js[i] = b->state[i];
+      bs = *b->cbase;
+      bo = *b->obase;
+      perturbForDynState(block,j,-b->eps,js,&bs,&bo);
+      forDynAccelerations(b->method,js,&bs,&bo,b->ux,b->leff,qddm);
+
+      for (i=1; i<=n; ++i)
+	D[i][j] = (qddp[i]-qddm[i])/(2.0*b->eps);
+    } else {
+      for (i=1; i<=n; ++i)
+	D[i][j] = (qddp[i]-b->qdd0[i])/b->eps;
+    }
+
+  }
+
+  return NULL;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  forDynAccelerations
+\date  Oct 2026
+   
+\remarks 
+
+computes the forward dynamics with the given method and returns the 
+accelerations of the DOFs, followed by the base accelerations for floating
+base robots. The state and the base are overwritten with the results.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     method  : FOR_DYN_ART or FOR_DYN_COMP
+ \param[in,out] js      : the joint state
+ \param[in,out] bs      : the position state of the base
+ \param[in,out] bo      : the orientational state of the base
+ \param[in]     ux      : the external forces acting on each joint
+ \param[in]     endeff  : the endeffector parameters
+ \param[out]    qdd     : the accelerations
+
+ ******************************************************************************/
+static void
+forDynAccelerations(int method, SL_Jstate *js, SL_Cstate *bs, SL_quat *bo,
+		    SL_uext *ux, SL_endeff *leff, double *qdd)
+{
+  int i;
+
+  if (method == FOR_DYN_COMP)
+    SL_ForDynComp(js, bs, bo, ux, leff, NULL, NULL);
+  else
+    SL_ForDynArt(js, bs, bo, ux, leff);
+
+  for (i=1; i<=n_dofs; ++i)
+    qdd[i] = js[i].thdd;
+
+  if (floating_base_flag) {
+    for (i=1; i<=N_CART; ++i) {
+      qdd[n_dofs+i]        = bs->xdd[i];
+      qdd[n_dofs+N_CART+i] = bo->add[i];
+    }
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  perturbForDynState
+\date  Oct 2026
+   
+\remarks 
+
+adds delta to one generalized position, velocity, or joint command. The
+base orientation is rotated by delta about the world axis j-n_dofs-N_CART.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     block   : 1=positions, 2=velocities, 3=joint commands
+ \param[in]     j       : the generalized coordinate
+ \param[in]     delta   : the perturbation
+ \param[in,out] js      : the joint state
+ \param[in,out] bs      : the position state of the base
+ \param[in,out] bo      : the orientational state of the base
+
+ ******************************************************************************/
+static void
+perturbForDynState(int block, int j, double delta, SL_Jstate *js, 
+		   SL_Cstate *bs, SL_quat *bo)
+{
+  int    i;
+  double dq[N_QUAT+1];
+  double q[N_QUAT+1];
+
+  switch (block) {
+
+  case 1:
+    if (j <= n_dofs) {
+      js[j].th += delta;
+    } else if (j <= n_dofs+N_CART) {
+      bs->x[j-n_dofs] += delta;
+    } else {
+      // q = dq * q, with dq the rotation about the world axis (quatExp() is 
+      // not accurate enough for the small rotations of finite differences)
+      for (i=1; i<=N_QUAT; ++i)
+	dq[i] = 0.0;
+      dq[_Q0_] = cos(delta/2.0);
+      dq[_Q1_+j-n_dofs-N_CART-1] = sin(delta/2.0);
+      for (i=1; i<=N_QUAT; ++i)
+	q[i] = bo->q[i];
+      quatMult(q,dq,bo->q);
+    }
+    break;
+
+  case 2:
+    if (j <= n_dofs)
+      js[j].thd += delta;
+    else if (j <= n_dofs+N_CART)
+      bs->xd[j-n_dofs] += delta;
+    else
+      bo->ad[j-n_dofs-N_CART] += delta;
+    break;
+
+  case 3:
+    js[j].u += delta;
+    break;
+
+  }
+
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  compute_independent_joint_forces
@@ -473,3 +985,319 @@ test_ForArtvsForComp( void )
     printf("%d: Art=% 6.3f Comp=% 6.3f (% 6.3f)\n",i+N_CART+n_dofs,bo.add[i],bo2.add[i],bo.add[i]-bo2.add[i]);
 
 }
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  test_DynamicsTiming
+\date  Oct 2026
+\remarks 
+
+a micro-benchmark of the forward dynamics, inverse dynamics, and kinematics
+functions of this robot. Every function is called for n_states random states,
+first once for all states to warm up the caches, and then once more for all
+states with every call timed individually. The states are copied into the
+arguments outside of the timed interval, and the overhead of the timer is
+subtracted. For every function, the min, percentiles, max, and mean of the
+ns/call are printed, together with the heap memory that remained allocated
+per call (glibc only, -1 otherwise), which is zero for the generated
+dynamics code. The results are also written to fname as one line per 
+function with white space separated columns, e.g., to compare methods and
+robots or to detect changes of the generated math.
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+\param[in]     n_states : number of random states
+\param[in]     fname    : file for the results (NULL: print only)
+
+Returns TRUE on success, FALSE otherwise
+
+******************************************************************************/
+int
+test_DynamicsTiming(int n_states, char *fname)
+{
+  int         i,j,k,m;
+  int         pass;
+  long        t0,t1;
+  long        heap0;
+  double      overhead;
+  double      mean;
+  double      heap_per_call;
+  double     *ns;
+  double      p[5+1];
+  SL_Jstate  *jts;
+  SL_Cstate  *bss;
+  SL_quat    *bos;
+  SL_Jstate   js[n_dofs+1];
+  SL_DJstate  djs[n_dofs+1];
+  SL_Cstate   bs;
+  SL_quat     bo;
+  SL_uext     ux[n_dofs+1];
+  double      aux;
+  Matrix      lp, jcog, jop, jap, J;
+  Matrix      Alink[n_links+1];
+  Matrix      Adof[n_dofs+1];
+  FILE       *fp = NULL;
+
+  if (n_states < 1)
+    return FALSE;
+
+  if (fname != NULL) {
+    fp = fopen(fname,"w");
+    if (fp == NULL) {
+      printf("Cannot open file >%s<\n",fname);
+      return FALSE;
+    }
+  }
+
+  // all memory is allocated before any timing
+  ns   = my_vector(1,n_states);
+  jts  = (SL_Jstate *)my_calloc(n_states*(n_dofs+1),sizeof(SL_Jstate),MY_STOP);
+  bss  = (SL_Cstate *)my_calloc(n_states+1,sizeof(SL_Cstate),MY_STOP);
+  bos  = (SL_quat *)my_calloc(n_states+1,sizeof(SL_quat),MY_STOP);
+  lp   = my_matrix(0,n_links,1,3);
+  jcog = my_matrix(0,n_dofs,1,3);
+  jop  = my_matrix(0,n_dofs,1,3);
+  jap  = my_matrix(0,n_dofs,1,3);
+  J    = my_matrix(1,n_endeffs*6,1,n_dofs);
+  for (i=0; i<=n_links; ++i)
+    Alink[i] = my_matrix(1,4,1,4);
+  for (i=0; i<=n_dofs; ++i)
+    Adof[i] = my_matrix(1,4,1,4);
+
+  // the random states: state k has the joint states jts[k*(n_dofs+1)+i]
+  for (k=0; k<n_states; ++k) {
+    for (i=1; i<=n_dofs; ++i) {
+      jts[k*(n_dofs+1)+i].th   = gaussian(0,1.0);
+      jts[k*(n_dofs+1)+i].thd  = gaussian(0,1.0);
+      jts[k*(n_dofs+1)+i].thdd = gaussian(0,1.0);
+      jts[k*(n_dofs+1)+i].u    = gaussian(0,1.0);
+    }
+
+    for (i=1; i<=N_CART; ++i) {
+      bss[k].x[i]   = gaussian(0,1.0);
+      bss[k].xd[i]  = gaussian(0,1.0);
+      bss[k].xdd[i] = gaussian(0,1.0);
+      bos[k].ad[i]  = gaussian(0,1.0);
+      bos[k].add[i] = gaussian(0,1.0);
+    }
+
+    aux = 0.0;
+    for (i=1; i<=N_QUAT; ++i) {
+      bos[k].q[i] = gaussian(0,1.0);
+      aux += sqr(bos[k].q[i]);
+    }
+    aux = sqrt(aux);
+
+    for (i=1; i<=N_QUAT; ++i)
+      bos[k].q[i] /= aux;
+  }
+
+  bzero((void *)ux,sizeof(ux));
+  bzero((void *)djs,sizeof(djs));
+
+  // the overhead of the timer
+  for (k=1; k<=n_states; ++k) {
+    t0 = timeStampNs();
+    t1 = timeStampNs();
+    ns[k] = t1-t0;
+  }
+  qsort(&ns[1],n_states,sizeof(double),compareDoubles);
+  overhead = ns[(n_states+1)/2];
+
+  printf("%-16s %8s %10s %10s %10s %10s %10s %10s %12s\n","function","calls",
+	 "min[ns]","p50[ns]","p90[ns]","p99[ns]","max[ns]","mean[ns]","heap[B/call]");
+  if (fp != NULL)
+    fprintf(fp,"# function calls min_ns p50_ns p90_ns p99_ns max_ns mean_ns heap_bytes_per_call\n");
+
+  for (m=1; m<N_DYN_TIMING_METHODS; ++m) {
+
+    heap0 = 0;
+
+    // pass 1 warms up the caches, pass 2 is timed
+    for (pass=1; pass<=2; ++pass) {
+
+      if (pass == 2)
+	heap0 = heapBytesInUse();
+
+      for (k=1; k<=n_states; ++k) {
+
+	for (i=1; i<=n_dofs; ++i) {
+	  js[i]       = jts[(k-1)*(n_dofs+1)+i];
+	  djs[i].th   = js[i].th;
+	  djs[i].thd  = js[i].thd;
+	  djs[i].thdd = js[i].thdd;
+	  djs[i].uff  = 0.0;
+	}
+	bs = bss[k-1];
+	bo = bos[k-1];
+
+	// the Jacobian needs the link information of the state
+	if (m == TIME_JACOBIAN)
+	  linkInformation(js,&bs,&bo,endeff,jcog,jap,jop,lp,Alink,Adof);
+
+	t0 = timeStampNs();
+
+	switch (m) {
+
+	case TIME_FOR_DYN_ART:
+	  SL_ForDynArt(js,&bs,&bo,ux,endeff);
+	  break;
+
+	case TIME_FOR_DYN_COMP:
+	  SL_ForDynComp(js,&bs,&bo,ux,endeff,NULL,NULL);
+	  break;
+
+	case TIME_INV_DYN_NE:
+	  SL_InvDynNE(NULL,djs,endeff,&bs,&bo);
+	  break;
+
+	case TIME_INV_DYN_ART:
+	  SL_InvDynArt(NULL,djs,endeff,&bs,&bo);
+	  break;
+
+	case TIME_LINK_INFORMATION:
+	  linkInformation(js,&bs,&bo,endeff,jcog,jap,jop,lp,Alink,Adof);
+	  break;
+
+	case TIME_JACOBIAN:
+	  jacobian(lp,jop,jap,J);
+	  break;
+
+	}
+
+	t1 = timeStampNs();
+	ns[k] = t1-t0-overhead;
+
+      }
+
+    }
+
+    heap_per_call = (heap0 < 0) ? -1.0 : (heapBytesInUse()-heap0)/(double)n_states;
+
+    mean = 0.0;
+    for (k=1; k<=n_states; ++k)
+      mean += ns[k];
+    mean /= (double)n_states;
+
+    // min, p50, p90, p99, max
+    qsort(&ns[1],n_states,sizeof(double),compareDoubles);
+    p[1] = ns[1];
+    p[2] = ns[1+(int)(0.50*(n_states-1))];
+    p[3] = ns[1+(int)(0.90*(n_states-1))];
+    p[4] = ns[1+(int)(0.99*(n_states-1))];
+    p[5] = ns[n_states];
+
+    printf("%-16s %8d",dyn_timing_names[m],n_states);
+    for (j=1; j<=5; ++j)
+      printf(" %10.1f",p[j]);
+    printf(" %10.1f %12.1f\n",mean,heap_per_call);
+
+    if (fp != NULL) {
+      fprintf(fp,"%s %d",dyn_timing_names[m],n_states);
+      for (j=1; j<=5; ++j)
+	fprintf(fp," %.1f",p[j]);
+      fprintf(fp," %.1f %.1f\n",mean,heap_per_call);
+    }
+
+  }
+
+  if (fp != NULL)
+    fclose(fp);
+
+  my_free_vector(ns,1,n_states);
+  free(jts);
+  free(bss);
+  free(bos);
+  my_free_matrix(lp,0,n_links,1,3);
+  my_free_matrix(jcog,0,n_dofs,1,3);
+  my_free_matrix(jop,0,n_dofs,1,3);
+  my_free_matrix(jap,0,n_dofs,1,3);
+  my_free_matrix(J,1,n_endeffs*6,1,n_dofs);
+  for (i=0; i<=n_links; ++i)
+    my_free_matrix(Alink[i],1,4,1,4);
+  for (i=0; i<=n_dofs; ++i)
+    my_free_matrix(Adof[i],1,4,1,4);
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  compareDoubles
+\date  Oct 2026
+\remarks 
+
+qsort() comparison of doubles in ascending order
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+\param[in]     a       : pointer to first double
+\param[in]     b       : pointer to second double
+
+******************************************************************************/
+static int
+compareDoubles(const void *a, const void *b)
+{
+  double da = *((const double *)a);
+  double db = *((const double *)b);
+
+  if (da < db)
+    return -1;
+  if (da > db)
+    return 1;
+
+  return 0;
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  timeStampNs
+\date  Oct 2026
+\remarks 
+
+returns a monotonic time stamp in nano seconds
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+none
+
+******************************************************************************/
+static long
+timeStampNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return (long)ts.tv_sec*1000000000L + (long)ts.tv_nsec;
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  heapBytesInUse
+\date  Oct 2026
+\remarks 
+
+returns the number of bytes allocated on the heap, or -1 if this is not
+available
+
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+
+none
+
+******************************************************************************/
+static long
+heapBytesInUse(void)
+{
+#ifdef HAS_MALLINFO2
+  struct mallinfo2 mi = mallinfo2();
+
+  return (long)(mi.uordblks + mi.hblkhd);
+#else
+  return -1;
+#endif
+}
@@ -0,0 +1,94 @@
+/*!=============================================================================
+  ==============================================================================
+
+  \ingroup SLskeletons
+
+  \file    SL_dynamics_timing.c
+
+  \author  Stefan Schaal
+  \date    Oct 2026
+
+  ==============================================================================
+  \remarks
+
+  standalone benchmark of the dynamics and kinematics functions of a robot,
+  which runs test_DynamicsTiming(). Like the parameter estimation, this
+  program is a skeleton that needs to be linked with the robot specific
+  kinematics and dynamics in the robot directory.
+
+  usage: xdyntiming [n_states] [file for the results]
+
+  ============================================================================*/
+
+/* system headers */
+#include "SL_system_headers.h"
+
+/* private includes */
+#include "SL.h"
+#include "SL_user.h"
+#include "SL_common.h"
+#include "utility.h"
+#include "SL_dynamics.h"
+#include "SL_kinematics.h"
+
+#define N_STATES_DEFAULT  10000
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  main
+\date  Oct 2026
+
+\remarks
+
+        initializes the dynamics and kinematics with the parameter files of
+        the simulation, and runs the timing benchmark
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     argc : number of states and file name as optional arguments
+ \param[in]     argv : s.o.
+
+ ******************************************************************************/
+int
+main(int argc, char **argv)
+{
+  int   n_states = N_STATES_DEFAULT;
+  char  fname[100] = "dynamics_timing.txt";
+
+  /* copy the input arguments */
+  argc_global    = argc;
+  argv_global    = argv;
+  argv_prog_name = argv[0];
+
+  /* subtract 1 from argv to get rid of the 0-th argument which is the
+     function name itself */
+  argc_global -= 1;
+
+  if (argc > 1)
+    n_states = atoi(argv[1]);
+  if (argc > 2) {
+    strncpy(fname,argv[2],sizeof(fname)-1);
+    fname[sizeof(fname)-1] = '\0';
+  }
+
+  if (n_states < 1) {
+    printf("usage: %s [n_states] [file for the results]\n",argv[0]);
+    return -1;
+  }
+
+  /* the parameter files of the simulation */
+  real_robot_flag = FALSE;
+  setRealRobotOptions();
+
+  /* initialize the dynamics and kinematics calculations */
+  if (!init_dynamics())
+    return -1;
+
+  init_kinematics();
+
+  if (!test_DynamicsTiming(n_states,fname))
+    return -1;
+
+  return 0;
+}
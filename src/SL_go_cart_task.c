@@ -158,6 +158,8 @@ init_goto_cart_task(void)
       movement_time = 0.2;
     tau = movement_time;
 
+    /* the desired cartesian state is the default goal */
+    update_kinematics(KIN_DES_STATE);
     
     /* input the cartesian goal */
     for (i=1; i<=n_endeffs; ++i) {
@@ -223,6 +225,7 @@ init_goto_cart_task(void)
   }
 
   /* the cnext state is the desired state as seen form this program */
+  update_kinematics(KIN_DES_STATE | KIN_DES_CART_VEL);
   for (i=1; i<=n_endeffs;++i) {
     cnext[i] = cart_des_state[i];
   }
@@ -290,6 +293,9 @@ run_goto_cart_task(void)
     return TRUE; 
   }
 
+  /* the desired cartesian state and Jacobian of this servo tick */
+  update_kinematics(KIN_DES_STATE | KIN_DES_JACOBIAN);
+
   /* progress by min jerk in cartesian space */
   calculate_min_jerk_next_step(cnext,ctarget,tau,time_step,cnext);
   tau -= time_step;
@@ -303,12 +309,13 @@ run_goto_cart_task(void)
     }
   }
 
-  /* inverse kinematics */
+  /* inverse kinematics: the target is the desired state, such that the
+     Jacobian of the task servo can be used */
   for (i=1; i<=n_dofs; ++i) {
     target[i].th = joint_des_state[i].th;
   }
-  if (!inverseKinematics(target,endeff,joint_opt_state,
-			 cart,cstatus,time_step)) {
+  if (!inverseKinematicsJac(target,endeff,joint_opt_state,
+			    cart,cstatus,time_step,0.0,0.0,Jdes)) {
     freeze();
     return FALSE;
   }
@@ -32,12 +32,44 @@
 #include "utility_macros.h"
 
 /* global variables */
+iVector n_link_dofs;        // number of DOFs that move each link
+iMatrix link_dofs;          // the IDs of these DOFs in ascending order
+iVector n_endeff_dofs;      // number of DOFs that move each endeffector
+iMatrix endeff_dofs;        // the IDs of these DOFs in ascending order
 
 /* local variables */
+static iVector n_dof_ancestors;  // number of DOFs between a DOF and the base
+static iMatrix dof_ancestors;    // the IDs of these DOFs
+
+// preallocated memory for the inverse kinematics
+static Matrix  ik_Jac;
+static Matrix  ik_link_pos;
+static Matrix  ik_joint_cog_mpos;
+static Matrix  ik_joint_origin_pos;
+static Matrix  ik_joint_axis_pos;
+static Matrix  ik_Alink[N_LINKS+1];
+static Matrix  ik_Adof[N_DOFS+1];
+static Matrix  ik_A;                      // J*J' of the constrained rows
+static Matrix  ik_L;                      // Cholesky factor of ik_A
+static Matrix  ik_U;                      // SVD of the constrained rows
+static Matrix  ik_V;
+static double  ik_s[N_DOFS+1];
+static double  ik_si[N_DOFS+1];
+static int     ik_ind[6*N_ENDEFFS+1];     // the constrained rows
+static int     ik_eff[6*N_ENDEFFS+1];     // the endeffector of each row
+static double  ik_b[6*N_ENDEFFS+1];
+static double  ik_y[6*N_ENDEFFS+1];
+static double  ik_v[6*N_ENDEFFS+1];
+static double  ik_w[6*N_ENDEFFS+1];
+static double  ik_z[N_DOFS+1];            // the null space motion
 
 /* global functions */
 
 /* local functions */
+static void initKinematicSparsity(void);
+static int  choleskyDecomposition(Matrix A, Matrix L, int n);
+static void choleskySolve(Matrix L, int n, Vector b, Vector x);
+static double choleskyConditionNumber(Matrix A, Matrix L, int n);
 
 /* external variables */
 
@@ -99,12 +131,110 @@ init_kinematics(void)
     Adof_sim[i] = my_matrix(1,4,1,4);
   }
 
+  ik_Jac              = my_matrix(1,N_ENDEFFS*6,1,N_DOFS);
+  ik_link_pos         = my_matrix(0,N_LINKS,1,3);
+  ik_joint_cog_mpos   = my_matrix(0,N_DOFS,1,3);
+  ik_joint_origin_pos = my_matrix(0,N_DOFS,1,3);
+  ik_joint_axis_pos   = my_matrix(0,N_DOFS,1,3);
+  ik_A                = my_matrix(1,N_ENDEFFS*6,1,N_ENDEFFS*6);
+  ik_L                = my_matrix(1,N_ENDEFFS*6,1,N_ENDEFFS*6);
+  ik_U                = my_matrix(1,N_ENDEFFS*6,1,N_DOFS);
+  ik_V                = my_matrix(1,N_DOFS,1,N_DOFS);
+
+  for (i=0; i<=N_LINKS; ++i)
+    ik_Alink[i] = my_matrix(1,4,1,4);
+
+  for (i=0; i<=N_DOFS; ++i)
+    ik_Adof[i] = my_matrix(1,4,1,4);
+
   // initialize indicators for prismatic joints
   for (i=0; i<=N_DOFS; ++i)
     prismatic_joint_flag[i] = FALSE;
 
 #include "Prismatic_Joints.h"  
 
+  // the structurally non-zero columns of all Jacobians
+  initKinematicSparsity();
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  initKinematicSparsity
+\date  Oct 2026
+   
+\remarks 
+
+        extracts the sparsity pattern of the kinematic tree from the Jlist
+        of the contact jacobian: which DOFs move each link and endeffector,
+        and which DOFs lie between each DOF and the base. All DOFs that move
+        a superset of the links moved by a DOF are its ancestors, and DOFs
+        that move the same links (e.g., the DOFs of a spherical joint) are
+        ordered by their index. Only the DOFs in these lists contribute 
+        non-zero columns to the Jacobians. This is called by 
+        init_kinematics(), or by the first function that needs the lists.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+none
+
+ ******************************************************************************/
+static void
+initKinematicSparsity(void)
+{
+  int i,j,k,l;
+  int subset;
+
+#include "Contact_GJac_declare.h"
+#include "Contact_GJac_math.h"
+
+  if (link_dofs != NULL)
+    return;
+
+  n_link_dofs     = my_ivector(0,N_LINKS);
+  link_dofs       = my_imatrix(0,N_LINKS,1,N_DOFS);
+  n_endeff_dofs   = my_ivector(1,N_ENDEFFS);
+  endeff_dofs     = my_imatrix(1,N_ENDEFFS,1,N_DOFS);
+  n_dof_ancestors = my_ivector(1,N_DOFS);
+  dof_ancestors   = my_imatrix(1,N_DOFS,1,N_DOFS);
+
+  for (l=0; l<=n_links; ++l) {
+    n_link_dofs[l] = 0;
+    for (j=1; j<=n_dofs; ++j)
+      if ( Jlist[l][j] != 0 )
+	link_dofs[l][++n_link_dofs[l]] = j;
+  }
+
+  for (i=1; i<=n_endeffs; ++i) {
+    l = link2endeffmap[i];
+    n_endeff_dofs[i] = n_link_dofs[l];
+    for (j=1; j<=n_link_dofs[l]; ++j)
+      endeff_dofs[i][j] = link_dofs[l][j];
+  }
+
+  for (k=1; k<=n_dofs; ++k) {
+    n_dof_ancestors[k] = 0;
+    for (j=1; j<=n_dofs; ++j) {
+      if (j == k)
+	continue;
+      subset = TRUE;
+      for (l=0; l<=n_links; ++l) {
+	if (Jlist[l][k] != 0 && Jlist[l][j] == 0) {
+	  subset = FALSE;
+	  break;
+	}
+      }
+      if (!subset)
+	continue;
+      for (l=0; l<=n_links; ++l)
+	if (Jlist[l][j] != 0 && Jlist[l][k] == 0)
+	  break;
+      if (l <= n_links || j < k)
+	dof_ancestors[k][++n_dof_ancestors[k]] = j;
+    }
+  }
+
 }
 
 /*!*****************************************************************************
@@ -213,34 +343,33 @@ void
 jacobian(Matrix lp, Matrix jop, Matrix jap, Matrix Jac)
 
 {
-  int i,j,r;
+  int i,j,k,r;
   double c[2*N_CART+1];
-#include "GJac_declare.h"
 
-#include "GJac_math.h"
+  // the DOF lists are created by init_kinematics(), or here on first use
+  if (link_dofs == NULL)
+    initKinematicSparsity();
 
-  /* the Jlist variable generated by the math files contains the 
-     the indicators which joints contribute to each endeffector of
-     the jacobian. Now, this information is used to compute the
-     geometric jacobian */
+  /* the endeff_dofs lists contain the joints that contribute to each 
+     endeffector of the jacobian, i.e., all other columns of the
+     jacobian are zero. Only these columns are computed */
 
   for (i=1; i<=n_endeffs; ++i) {
-    for (j=1; j<=n_dofs; ++j) {
-      if ( Jlist[i][j] != 0 ) {
-	if (prismatic_joint_flag[j]) {
-	  prismaticGJacColumn( lp[link2endeffmap[i]],
-			      jop[j],
-			      jap[j],
-			      c );
-	} else {
-	  revoluteGJacColumn( lp[link2endeffmap[i]],
-			      jop[j],
-			      jap[j],
-			      c );
-	}
-	for (r=1; r<=2*N_CART; ++r) 
-	  Jac[(i-1)*6+r][j] = c[r];
+    for (k=1; k<=n_endeff_dofs[i]; ++k) {
+      j = endeff_dofs[i][k];
+      if (prismatic_joint_flag[j]) {
+	prismaticGJacColumn( lp[link2endeffmap[i]],
+			     jop[j],
+			     jap[j],
+			     c );
+      } else {
+	revoluteGJacColumn( lp[link2endeffmap[i]],
+			    jop[j],
+			    jap[j],
+			    c );
       }
+      for (r=1; r<=2*N_CART; ++r) 
+	Jac[(i-1)*6+r][j] = c[r];
     }
   }
 
@@ -268,33 +397,32 @@ jacobian(Matrix lp, Matrix jop, Matrix jap, Matrix Jac)
 void 
 genJacobian(Vector point, int link, Matrix jop, Matrix jap, Matrix J)
 {
-  int i,j,r;
+  int j,k,r;
   double c[2*N_CART+1];
 
-#include "Contact_GJac_declare.h"
-#include "Contact_GJac_math.h"
-
-  /* the Jlist variable generated by the math files contains the 
-     the indicators which joints contribute to each link position
-     in the jacobian. Now, this information is used to compute the
-     geometric jacobian */
-
-  for (j=1; j<=n_dofs; ++j) {
-    if ( Jlist[link][j] != 0 ) {
-      if (prismatic_joint_flag[j]) {
-        prismaticGJacColumn( point,
-                            jop[j],
-                            jap[j],
-                            c );
-      } else {
-        revoluteGJacColumn( point,
-                            jop[j],
-                            jap[j],
-                            c );
-      }
-      for (r=1; r<=2*N_CART; ++r) 
-        J[r][j] = c[r];
+  // the DOF lists are created by init_kinematics(), or here on first use
+  if (link_dofs == NULL)
+    initKinematicSparsity();
+
+  /* the link_dofs lists contain the joints that contribute to each 
+     link position in the jacobian. Only these columns of the
+     geometric jacobian are non-zero */
+
+  for (k=1; k<=n_link_dofs[link]; ++k) {
+    j = link_dofs[link][k];
+    if (prismatic_joint_flag[j]) {
+      prismaticGJacColumn( point,
+                           jop[j],
+                           jap[j],
+                           c );
+    } else {
+      revoluteGJacColumn( point,
+                          jop[j],
+                          jap[j],
+                          c );
     }
+    for (r=1; r<=2*N_CART; ++r) 
+      J[r][j] = c[r];
   }
 }
 
@@ -320,26 +448,25 @@ void
 baseJacobian(Matrix lp, Matrix jop, Matrix jap, Matrix Jb)
 
 {
-  int i,j,r;
-  double c[2*N_CART+1];
+  int i,r;
+  double d[N_CART+1];
   
   // the base Jacobian is almost an identity matrix, except for the
-  // upper right quadrant
+  // upper right quadrant, which is the cross product matrix of the
+  // endeffector-base vector. Only the non-zero elements are assigned.
   
   for (i=1; i<=n_endeffs; ++i) {
     for (r=1; r<=N_CART; ++r) {
       Jb[(i-1)*6+r][r]        = 1.0;
       Jb[(i-1)*6+r+3][r+3]    = 1.0;
+      d[r] = lp[link2endeffmap[i]][r] - base_state.x[r];
     }
-    for (j=1; j<=N_CART; ++j) {
-      revoluteGJacColumn( lp[link2endeffmap[i]],
-			  base_state.x,
-			  Jb[j], // this is a equivalent to a unit vector
-			  c );
-      for (r=1; r<=N_CART; ++r) {
-	Jb[(i-1)*6+r][N_CART+j] = c[r];
-      }
-    }
+    Jb[(i-1)*6+_Y_][N_CART+_X_] = -d[_Z_];
+    Jb[(i-1)*6+_Z_][N_CART+_X_] =  d[_Y_];
+    Jb[(i-1)*6+_X_][N_CART+_Y_] =  d[_Z_];
+    Jb[(i-1)*6+_Z_][N_CART+_Y_] = -d[_X_];
+    Jb[(i-1)*6+_X_][N_CART+_Z_] = -d[_Y_];
+    Jb[(i-1)*6+_Y_][N_CART+_Z_] =  d[_X_];
   }
   
 }
@@ -412,142 +539,185 @@ inverseKinematicsClip(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
 		      Vector cart, iVector status, double dt, double max_rev,
 		      double max_pris)
 {
+  return inverseKinematicsJac(state, eff, rest, cart, status, dt, max_rev, max_pris, NULL);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  inverseKinematicsJac
+\date  Oct 2026
+   
+\remarks 
+
+       the same as inverseKinematicsClip, but the Jacobian of the state can 
+       be provided, e.g., Jdes from the task servo if the state is the
+       current desired state. The damped least squares problem is solved 
+       with a Cholesky decomposition of J*J' of the constrained rows, 
+       and only close to singularities with the regularized SVD. All 
+       temporary memory is preallocated in init_kinematics(), such that
+       this function is not reentrant.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out] state    : the state of the robot (given as a desired state)
+ \param[in]     endeff   : the endeffector parameters
+ \param[in]     rest     : the optimization posture
+ \param[in]     cart     : the cartesian state (pos & orientations in a matrix)
+ \param[in]     status   : which rows to use from the Jacobian
+ \param[in]     dt       : the integration time step     
+ \param[in]     max_rev  : max velocity for revolute joints  (0.0 to ignore)
+ \param[in]     max_pris : max velocity for prismatic joints (0.0 to ignore)
+ \param[in]     Jac      : Jacobian of state, or NULL to compute it
+
+ for return values, see inverseKinematics()
+
+ ******************************************************************************/
+double
+inverseKinematicsJac(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
+		     Vector cart, iVector status, double dt, double max_rev,
+		     double max_pris, Matrix Jac)
+{
   
-  int            i,j,n;
+  int            i,j,k,n;
   int            count;
-  MY_MATRIX(Jac,1,6*N_ENDEFFS,1,N_DOFS);
-  MY_MATRIX(Jreal,1,6*N_ENDEFFS,1,N_DOFS);
-  MY_IVECTOR(ind,1,6*N_ENDEFFS);
-  MY_MATRIX(B,1,N_DOFS,1,6*N_ENDEFFS);
-  MY_MATRIX(O,1,N_DOFS,1,N_DOFS);
-  MY_MATRIX(local_link_pos_des,0,N_LINKS,1,3);
-  MY_MATRIX(local_joint_cog_mpos_des,0,N_DOFS,1,3);
-  MY_MATRIX(local_joint_origin_pos_des,0,N_DOFS,1,3);
-  MY_MATRIX(local_joint_axis_pos_des,0,N_DOFS,1,3);
-  MY_MATRIX_ARRAY(local_Alink_des,1,4,1,4,N_LINKS+1);
-  MY_MATRIX_ARRAY(local_Adof_des,1,4,1,4,N_DOFS+1);
   double         ralpha = 2.0;
   double         condnr;
   double         condnr_cutoff = 1500.0; 
+  int            use_cholesky;
 
   /* compute the Jacobian */
-  linkInformationDes(state,&base_state,&base_orient,eff,
-		     local_joint_cog_mpos_des,
-		     local_joint_axis_pos_des,
-		     local_joint_origin_pos_des,
-		     local_link_pos_des,
-		     local_Alink_des,
-		     local_Adof_des);
-
-  jacobian(local_link_pos_des,local_joint_origin_pos_des,local_joint_axis_pos_des,Jac);
+  if (Jac == NULL) {
+    linkInformationDes(state,&base_state,&base_orient,eff,
+		       ik_joint_cog_mpos,
+		       ik_joint_axis_pos,
+		       ik_joint_origin_pos,
+		       ik_link_pos,
+		       ik_Alink,
+		       ik_Adof);
+
+    jacobian(ik_link_pos,ik_joint_origin_pos,ik_joint_axis_pos,ik_Jac);
+    Jac = ik_Jac;
+  }
 
   /* how many contrained cartesian DOFs do we have? */
   count = 0;
   for (i=1; i<=6*N_ENDEFFS; ++i) {
     if (status[i]) {
       ++count;
-      ind[count] = i;
+      ik_ind[count] = i;
+      ik_eff[count] = (i-1)/6+1;
     }
   }
 
-  /* build the pseudo-inverse according to the status information using SVD */
+  /* the null space motion towards the optimization posture */
+  for (i=1; i<=N_DOFS; ++i)
+    ik_z[i] = ralpha * rest[i].w * (rest[i].th - state[i].th);
 
-  // the Jacobian that is actually needed, i.e., only the constraint rows
-  mat_zero(Jreal);
-  for (i=1; i<=count; ++i)
-    for (j=1; j<=N_DOFS; ++j)
-      Jreal[i][j] = Jac[ind[i]][j];
-
-
-  // inversion with SVD with damping
-  MY_MATRIX(M,1,count,1,count);
-  MY_MATRIX(P,1,count,1,count);
-  MY_MATRIX(U,1,count,1,N_DOFS);
-  MY_MATRIX(V,1,N_DOFS,1,N_DOFS);
-  MY_VECTOR(s,1,N_DOFS);
-  MY_VECTOR(si,1,N_DOFS);
-
-  mat_equal_size(Jreal,count,N_DOFS,U); 
-  my_svdcmp(U,count,N_DOFS,s,V);
-
-  //printf("count=%d\n",count);
-  //print_mat("V",V);getchar();
-
-  // regularize if the condition number gets too large -- after the cutoff, we decay
-  // the inverse of the singular value in a smooth way to zero
+  /* the joint velocities are thd = z + J'*inv(J*J')*(cart - J*z), such
+     that only a count x count system needs to be solved. The sums only
+     run over the DOFs in the chain of the endeffector of each row */
   for (i=1; i<=count; ++i) {
-    double condnr_i = sqr(s[1])/(sqr(s[i])+1.e-10);
-    if ( condnr_i > condnr_cutoff) {
-      double lambda = sqr(1.0 - sqr(condnr_cutoff/condnr_i)) * 1.e6;
-      //si[i] = -2./(sqr(sc)*sc)*sqr(s[i])+3./sqr(sc)*s[i];
-      si[i] = sqr(s[i])/(sqr(sqr(s[i]))+lambda);
-    } else {
-      si[i] = 1./sqr(s[i]);
+    ik_b[i] = cart[ik_ind[i]];
+    for (k=1; k<=n_endeff_dofs[ik_eff[i]]; ++k) {
+      j = endeff_dofs[ik_eff[i]][k];
+      ik_b[i] -= Jac[ik_ind[i]][j] * ik_z[j];
     }
   }
 
-  condnr = sqr(s[1])/(sqr(s[count])+1.e-10);
-
-  //  P=inv(U*S*V'*V*S'*U')=U*inv(S*S')*U' is the inverse
-  for (i=1; i<=count; ++i) 
-    for (j=1; j<=count; ++j)
-      M[i][j] = U[j][i]*si[i];
-
-  mat_mult_size(U,count,count,M,count,count,P);
-  
-  /* build the B matrix, i.e., the pseudo-inverse */
-  for (i=1; i<=N_DOFS; ++i) {
-    for (j=1; j<=count; ++j) {
-      B[i][j]=0.0;
-      for (n=1; n<=count; ++n) {
-	B[i][j] += Jac[ind[n]][i] * P[n][j];
+  for (i=1; i<=count; ++i) {
+    for (j=i; j<=count; ++j) {
+      ik_A[i][j] = 0.0;
+      if (ik_eff[i] == ik_eff[j]) {
+	for (k=1; k<=n_endeff_dofs[ik_eff[i]]; ++k) {
+	  n = endeff_dofs[ik_eff[i]][k];
+	  ik_A[i][j] += Jac[ik_ind[i]][n] * Jac[ik_ind[j]][n];
+	}
+      } else {
+	for (n=1; n<=N_DOFS; ++n)
+	  ik_A[i][j] += Jac[ik_ind[i]][n] * Jac[ik_ind[j]][n];
       }
+      ik_A[j][i] = ik_A[i][j];
     }
   }
 
-  /* this provides the first part of the optimized pseudo inverse */
-  for (i=1; i<=N_DOFS; ++i) {
-    state[i].thd = 0;
-    for (j=1; j<=count; ++j) {
-      state[i].thd += B[i][j] * cart[ind[j]];
+  /* the Cholesky solution is only used if no regularization is needed. Both
+     the squared ratio of the largest to the smallest Cholesky pivot and the
+     iterative estimate can only underestimate the condition number, such
+     that the SVD is used if either of them exceeds half the cutoff. The
+     pivot ratio is cheap and catches near singular rows for which the
+     iteration has not converged. Note that callers like go_cart pass
+     max_rev=0.0, such that nothing else clips the joint velocities. */
+  use_cholesky = choleskyDecomposition(ik_A,ik_L,count);
+  if (use_cholesky) {
+    double lmax = 0.0;
+    double lmin = 0.0;
+
+    for (i=1; i<=count; ++i) {
+      if (i == 1 || ik_L[i][i] > lmax)
+	lmax = ik_L[i][i];
+      if (i == 1 || ik_L[i][i] < lmin)
+	lmin = ik_L[i][i];
     }
+    condnr = (count > 0) ? sqr(lmax/lmin) : 1.0;
+
+    if (condnr < 0.5*condnr_cutoff)
+      condnr = max(condnr,choleskyConditionNumber(ik_A,ik_L,count));
+
+    use_cholesky = (condnr < 0.5*condnr_cutoff);
   }
 
-  /* the optimization part using the regularized pseudo inverse */
-  for (i=1; i<=N_DOFS; ++i) {
-    for (j=i; j<=N_DOFS; ++j) {
-      
-      if (i==j) 
-	O[i][j] = 1.0;
-      else
-	O[i][j] = 0.0;
-      
-      for (n=1; n<=count; ++n) {
-	O[i][j] -= B[i][n] * Jreal[n][j];
+  if (use_cholesky) {
+
+    choleskySolve(ik_L,count,ik_b,ik_y);
+
+  } else {
+
+    // inversion with SVD with damping
+    for (i=1; i<=count; ++i)
+      for (j=1; j<=N_DOFS; ++j)
+	ik_U[i][j] = Jac[ik_ind[i]][j];
+
+    my_svdcmp(ik_U,count,N_DOFS,ik_s,ik_V);
+
+    // regularize if the condition number gets too large -- after the cutoff, we decay
+    // the inverse of the singular value in a smooth way to zero
+    for (i=1; i<=count; ++i) {
+      double condnr_i = sqr(ik_s[1])/(sqr(ik_s[i])+1.e-10);
+      if ( condnr_i > condnr_cutoff) {
+	double lambda = sqr(1.0 - sqr(condnr_cutoff/condnr_i)) * 1.e6;
+	ik_si[i] = sqr(ik_s[i])/(sqr(sqr(ik_s[i]))+lambda);
+      } else {
+	ik_si[i] = 1./sqr(ik_s[i]);
       }
-      
-      if (i!=j)
-	O[j][i] = O[i][j];
     }
-  }
 
-  /* the optimization part: we use the unregularized Null space such that we don't
-     suddently pop up new null space dimensions when the inversion is ill conditioned */
-  /* does not work correctly
-  for (i=1; i<=N_DOFS; ++i) {
-    for (j=i; j<=N_DOFS; ++j) {
-      O[i][j] = 0.0;
-      for (n=count+1; n<=N_DOFS; ++n)
-	O[i][j] += V[i][n] * V[j][n];
-      O[j][i] = O[i][j];
+    condnr = sqr(ik_s[1])/(sqr(ik_s[count])+1.e-10);
+
+    //  y = U*inv(S*S')*U'*b is the regularized solution
+    for (i=1; i<=count; ++i) {
+      ik_v[i] = 0.0;
+      for (j=1; j<=count; ++j)
+	ik_v[i] += ik_U[j][i] * ik_b[j];
+      ik_v[i] *= ik_si[i];
+    }
+
+    for (i=1; i<=count; ++i) {
+      ik_y[i] = 0.0;
+      for (j=1; j<=count; ++j)
+	ik_y[i] += ik_U[i][j] * ik_v[j];
     }
+
   }
-  */
 
-  /* add the optimization part to the velocities */
-  for (i=1; i<=N_DOFS; ++i) {
-    for (j=1; j<=N_DOFS; ++j) {
-      state[i].thd += ralpha* rest[j].w * (rest[j].th - state[j].th) * O[i][j];
+  /* the joint velocities */
+  for (i=1; i<=N_DOFS; ++i)
+    state[i].thd = ik_z[i];
+
+  for (i=1; i<=count; ++i) {
+    for (k=1; k<=n_endeff_dofs[ik_eff[i]]; ++k) {
+      j = endeff_dofs[ik_eff[i]][k];
+      state[j].thd += Jac[ik_ind[i]][j] * ik_y[i];
     }
   }
 
@@ -555,8 +725,6 @@ inverseKinematicsClip(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
      motion of a DOF */
   for (i=1; i<=N_DOFS; ++i) {
     double max_thd, min_thd;
-    double max_thd_now;
-    double min_thd_now;
 
     if (prismatic_joint_flag[i] && max_pris == 0.0)
       continue;
@@ -593,6 +761,164 @@ inverseKinematicsClip(SL_DJstate *state, SL_endeff *eff, SL_OJstate *rest,
 
 }
 
+/*!*****************************************************************************
+ *******************************************************************************
+\note  choleskyDecomposition
+\date  Oct 2026
+   
+\remarks 
+
+       Cholesky decomposition A = L*L' of a symmetric positive definite
+       matrix. Returns FALSE if A is not numerically positive definite.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     A      : the matrix
+ \param[out]    L      : the lower triangular factor
+ \param[in]     n      : size of A
+
+ ******************************************************************************/
+static int
+choleskyDecomposition(Matrix A, Matrix L, int n)
+{
+  int    i,j,k;
+  double sum;
+
+  for (i=1; i<=n; ++i) {
+    for (j=1; j<=i; ++j) {
+      sum = A[i][j];
+      for (k=1; k<j; ++k)
+	sum -= L[i][k]*L[j][k];
+      if (i == j) {
+	if (sum <= 1.e-10*A[i][i] || sum <= 0.0)
+	  return FALSE;
+	L[i][i] = sqrt(sum);
+      } else {
+	L[i][j] = sum/L[j][j];
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  choleskySolve
+\date  Oct 2026
+   
+\remarks 
+
+       solves L*L'*x = b with a Cholesky factor L
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     L      : the lower triangular factor
+ \param[in]     n      : size of L
+ \param[in]     b      : right hand side
+ \param[out]    x      : solution (may be the same as b)
+
+ ******************************************************************************/
+static void
+choleskySolve(Matrix L, int n, Vector b, Vector x)
+{
+  int    i,k;
+  double sum;
+
+  for (i=1; i<=n; ++i) {
+    sum = b[i];
+    for (k=1; k<i; ++k)
+      sum -= L[i][k]*x[k];
+    x[i] = sum/L[i][i];
+  }
+
+  for (i=n; i>=1; --i) {
+    sum = x[i];
+    for (k=i+1; k<=n; ++k)
+      sum -= L[k][i]*x[k];
+    x[i] = sum/L[i][i];
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  choleskyConditionNumber
+\date  Oct 2026
+   
+\remarks 
+
+       estimates the condition number of a symmetric positive definite
+       matrix from its largest eigenvalue by power iteration and its
+       smallest eigenvalue by inverse iteration with the Cholesky factor.
+       The estimate is a lower bound, which becomes quickly accurate.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     A      : the matrix
+ \param[in]     L      : its Cholesky factor
+ \param[in]     n      : size of A
+
+ ******************************************************************************/
+#define IK_EIG_ITER 8
+static double
+choleskyConditionNumber(Matrix A, Matrix L, int n)
+{
+  int    i,j,iter;
+  double aux;
+  double lmax = 0.0;
+  double lmin_inv = 0.0;
+
+  if (n == 0)
+    return 1.0;
+
+  // power iteration for the largest eigenvalue
+  for (i=1; i<=n; ++i)
+    ik_v[i] = 1.0 + 0.1*i;
+
+  for (iter=1; iter<=IK_EIG_ITER; ++iter) {
+    aux = 0.0;
+    for (i=1; i<=n; ++i)
+      aux += sqr(ik_v[i]);
+    aux = 1./sqrt(aux);
+    for (i=1; i<=n; ++i)
+      ik_v[i] *= aux;
+    lmax = 0.0;
+    for (i=1; i<=n; ++i) {
+      ik_w[i] = 0.0;
+      for (j=1; j<=n; ++j)
+	ik_w[i] += A[i][j]*ik_v[j];
+      lmax += ik_v[i]*ik_w[i];
+    }
+    for (i=1; i<=n; ++i)
+      ik_v[i] = ik_w[i];
+  }
+
+  // inverse iteration for the smallest eigenvalue
+  for (i=1; i<=n; ++i)
+    ik_v[i] = 1.0 + 0.1*i;
+
+  for (iter=1; iter<=IK_EIG_ITER; ++iter) {
+    aux = 0.0;
+    for (i=1; i<=n; ++i)
+      aux += sqr(ik_v[i]);
+    aux = 1./sqrt(aux);
+    for (i=1; i<=n; ++i)
+      ik_v[i] *= aux;
+    choleskySolve(L,n,ik_v,ik_w);
+    lmin_inv = 0.0;
+    for (i=1; i<=n; ++i)
+      lmin_inv += ik_v[i]*ik_w[i];
+    for (i=1; i<=n; ++i)
+      ik_v[i] = ik_w[i];
+  }
+
+  return lmax*lmin_inv;
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  computeLinkVelocity
@@ -652,35 +978,34 @@ void
 computeLinkVelocityPoint(int lID, double *point, Matrix lp, Matrix jop, Matrix jap, 
 			 SL_Jstate *js, double *v)
 {
-  int i,j,r;
+  int i,j,k,r;
   double c[2*N_CART+1];
   MY_MATRIX(Jlink,1,N_CART,1,n_dofs);
   MY_MATRIX(Jlinkbase,1,N_CART,1,2*N_CART);
 
-#include "Contact_GJac_declare.h"
-#include "Contact_GJac_math.h"
+  // the DOF lists are created by init_kinematics(), or here on first use
+  if (link_dofs == NULL)
+    initKinematicSparsity();
 
-  /* the Jlist variable generated by the math files contains the 
-     the indicators which joints contribute to each link position
-     in the jacobian. Now, this information is used to compute the
-     geometric jacobian */
+  /* the link_dofs lists contain the joints that contribute to each 
+     link position in the jacobian. Only these columns of the 
+     geometric jacobian are computed */
   
-  for (j=1; j<=n_dofs; ++j) {
-    if ( Jlist[lID][j] != 0 ) {
-      if (prismatic_joint_flag[j]) {
-	prismaticGJacColumn( point,
-			     jop[j],
-			     jap[j],
-			     c );
-      } else {
-	revoluteGJacColumn( point,
-			    jop[j],
-			    jap[j],
-			    c );
-      }
-      for (r=1; r<=N_CART; ++r) 
-	Jlink[r][j] = c[r];
+  for (k=1; k<=n_link_dofs[lID]; ++k) {
+    j = link_dofs[lID][k];
+    if (prismatic_joint_flag[j]) {
+      prismaticGJacColumn( point,
+			   jop[j],
+			   jap[j],
+			   c );
+    } else {
+      revoluteGJacColumn( point,
+			  jop[j],
+			  jap[j],
+			  c );
     }
+    for (r=1; r<=N_CART; ++r) 
+      Jlink[r][j] = c[r];
   }
 
   // next the base Jacobian
@@ -711,9 +1036,9 @@ computeLinkVelocityPoint(int lID, double *point, Matrix lp, Matrix jop, Matrix j
     v[i]     = 0.0;
 
     /* contributations from the joints */
-    for (r=1; r<=n_dofs; ++r) {
-      if ( Jlist[lID][r] != 0 )
-	v[i] += Jlink[i][r] * js[r].thd;
+    for (k=1; k<=n_link_dofs[lID]; ++k) {
+      r = link_dofs[lID][k];
+      v[i] += Jlink[i][r] * js[r].thd;
     }
     //printf("%d: %f  ",i,v[i]);
 
@@ -730,6 +1055,263 @@ computeLinkVelocityPoint(int lID, double *point, Matrix lp, Matrix jop, Matrix j
 
 }
 
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeLinkVelocities
+\date  Oct 2026
+   
+\remarks 
+
+        Computes the velocities of all links in world coordinates, as the
+        angular velocity of each link and the linear velocity of the point of
+        the link that coincides with the world origin. The velocity of any
+        point fixed in a link then only needs one cross product, see
+        computeLinkPointVelocity(). Each DOF contributes the same velocity
+        twist to all links it moves, such that the twists of the DOFs are 
+        only computed once and then summed up for each link.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     lp     : the link positions
+ \param[in]     jop    : joint origin positions
+ \param[in]     jap    : joint axix unit vectors
+ \param[in]     js     : joint state
+ \param[out]    lw     : angular velocity of each link (0:n_links x 1:N_CART)
+ \param[out]    lv     : linear velocity at the world origin of each link
+                          (0:n_links x 1:N_CART)
+
+ ******************************************************************************/
+void 
+computeLinkVelocities(Matrix lp, Matrix jop, Matrix jap, SL_Jstate *js, 
+		      Matrix lw, Matrix lv)
+{
+  int i,j,k,r;
+  double bw[N_CART+1];
+  double bv[N_CART+1];
+  MY_MATRIX(jw,1,n_dofs,1,N_CART);
+  MY_MATRIX(jv,1,n_dofs,1,N_CART);
+
+  // the velocity twist of each DOF: a revolute joint adds the angular
+  // velocity a*thd, and the linear velocity (o x a)*thd at the world origin 
+  for (j=1; j<=n_dofs; ++j) {
+    if (prismatic_joint_flag[j]) {
+      for (r=1; r<=N_CART; ++r) {
+	jw[j][r] = 0.0;
+	jv[j][r] = jap[j][r]*js[j].thd;
+      }
+    } else {
+      jv[j][_X_] = (jop[j][_Y_]*jap[j][_Z_] - jop[j][_Z_]*jap[j][_Y_])*js[j].thd;
+      jv[j][_Y_] = (jop[j][_Z_]*jap[j][_X_] - jop[j][_X_]*jap[j][_Z_])*js[j].thd;
+      jv[j][_Z_] = (jop[j][_X_]*jap[j][_Y_] - jop[j][_Y_]*jap[j][_X_])*js[j].thd;
+      for (r=1; r<=N_CART; ++r)
+	jw[j][r] = jap[j][r]*js[j].thd;
+    }
+  }
+
+  // the velocity twist of the base
+  for (r=1; r<=N_CART; ++r)
+    bw[r] = base_orient.ad[r];
+  bv[_X_] = base_state.xd[_X_] - (bw[_Y_]*base_state.x[_Z_] - bw[_Z_]*base_state.x[_Y_]);
+  bv[_Y_] = base_state.xd[_Y_] - (bw[_Z_]*base_state.x[_X_] - bw[_X_]*base_state.x[_Z_]);
+  bv[_Z_] = base_state.xd[_Z_] - (bw[_X_]*base_state.x[_Y_] - bw[_Y_]*base_state.x[_X_]);
+
+  // the DOF lists are created by init_kinematics(), or here on first use
+  if (link_dofs == NULL)
+    initKinematicSparsity();
+
+  // the link_dofs lists contain the joints that contribute to each link 
+  for (i=0; i<=n_links; ++i) {
+
+    for (r=1; r<=N_CART; ++r) {
+      lw[i][r] = bw[r];
+      lv[i][r] = bv[r];
+    }
+
+    for (k=1; k<=n_link_dofs[i]; ++k) {
+      j = link_dofs[i][k];
+      for (r=1; r<=N_CART; ++r) {
+	lw[i][r] += jw[j][r];
+	lv[i][r] += jv[j][r];
+      }
+    }
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeLinkPointVelocity
+\date  Oct 2026
+   
+\remarks 
+
+        Computes the velocity of a point that is fixed in a particular link
+        in world coordinates, using the link velocities from 
+        computeLinkVelocities(). This gives the same result as
+        computeLinkVelocityPoint().
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     lID    : the ID of the link
+ \param[in]     point  : the point belonging to link lID in world coordinates
+ \param[in]     lw     : angular velocity of each link
+ \param[in]     lv     : linear velocity at the world origin of each link
+ \param[out]    v      : velocity vector
+
+ ******************************************************************************/
+void 
+computeLinkPointVelocity(int lID, double *point, Matrix lw, Matrix lv, double *v)
+{
+
+  v[_X_] = lv[lID][_X_] + lw[lID][_Y_]*point[_Z_] - lw[lID][_Z_]*point[_Y_];
+  v[_Y_] = lv[lID][_Y_] + lw[lID][_Z_]*point[_X_] - lw[lID][_X_]*point[_Z_];
+  v[_Z_] = lv[lID][_Z_] + lw[lID][_X_]*point[_Y_] - lw[lID][_Y_]*point[_X_];
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  jacobianTimeDerivative
+\date  Oct 2026
+   
+\remarks 
+
+        Computes the time derivatives of the endeffector jacobian and of the
+        base jacobian analytically from the link velocities. The axis and
+        origin of a DOF are fixed in the link that precedes the DOF, such that
+        they move with the velocity twist of this parent link, which is
+        the sum of the twists of the base and of the ancestor DOFs from
+        initKinematicSparsity(). All elements of the first 6*n_endeffs rows
+        of dJ and dJb are written, including the structural zeros.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     lp      : the link positions
+ \param[in]     jop     : joint origin positions
+ \param[in]     jap     : joint axix unit vectors
+ \param[in]     js      : joint state
+ \param[out]    dJ      : time derivative of the endeffector jacobian
+ \param[out]    dJb     : time derivative of the base jacobian
+
+ ******************************************************************************/
+void 
+jacobianTimeDerivative(Matrix lp, Matrix jop, Matrix jap, SL_Jstate *js,
+		       Matrix dJ, Matrix dJb)
+{
+  int i,j,k,l,m,n,r;
+  double w[N_CART+1];
+  double v[N_CART+1];
+  double ad[N_CART+1];
+  double od[N_CART+1];
+  double pd[N_CART+1];
+  double d[N_CART+1];
+  double c[2*N_CART+1];
+  MY_MATRIX(lw,0,N_LINKS,1,N_CART);
+  MY_MATRIX(lv,0,N_LINKS,1,N_CART);
+
+  computeLinkVelocities(lp,jop,jap,js,lw,lv);
+
+  // all elements are written, as only the structurally non-zero elements
+  // are computed below
+  for (r=1; r<=6*n_endeffs; ++r) {
+    for (j=1; j<=n_dofs; ++j)
+      dJ[r][j] = 0.0;
+    for (j=1; j<=2*N_CART; ++j)
+      dJb[r][j] = 0.0;
+  }
+
+  for (i=1; i<=n_endeffs; ++i) {
+
+    l = link2endeffmap[i];
+
+    // the velocity of the endeffector
+    computeLinkPointVelocity(l,lp[l],lw,lv,pd);
+
+    // only the structurally non-zero columns of dJ
+    for (m=1; m<=n_endeff_dofs[i]; ++m) {
+
+      j = endeff_dofs[i][m];
+
+      // the velocity twist of the parent link of this DOF, i.e., the twist
+      // of the base plus the twists of all ancestor DOFs
+      for (r=1; r<=N_CART; ++r) {
+	w[r] = base_orient.ad[r];
+	v[r] = base_state.xd[r];
+      }
+      for (r=1; r<=N_CART; ++r)
+	d[r] = jop[j][r] - base_state.x[r];
+      v[_X_] += w[_Y_]*d[_Z_] - w[_Z_]*d[_Y_];
+      v[_Y_] += w[_Z_]*d[_X_] - w[_X_]*d[_Z_];
+      v[_Z_] += w[_X_]*d[_Y_] - w[_Y_]*d[_X_];
+
+      for (n=1; n<=n_dof_ancestors[j]; ++n) {
+	k = dof_ancestors[j][n];
+	if (prismatic_joint_flag[k]) {
+	  for (r=1; r<=N_CART; ++r)
+	    v[r] += jap[k][r]*js[k].thd;
+	} else {
+	  for (r=1; r<=N_CART; ++r)
+	    d[r] = jop[j][r] - jop[k][r];
+	  v[_X_] += (jap[k][_Y_]*d[_Z_] - jap[k][_Z_]*d[_Y_])*js[k].thd;
+	  v[_Y_] += (jap[k][_Z_]*d[_X_] - jap[k][_X_]*d[_Z_])*js[k].thd;
+	  v[_Z_] += (jap[k][_X_]*d[_Y_] - jap[k][_Y_]*d[_X_])*js[k].thd;
+	  for (r=1; r<=N_CART; ++r)
+	    w[r] += jap[k][r]*js[k].thd;
+	}
+      }
+
+      // v is now the velocity of the joint origin; the axis rotates with w
+      for (r=1; r<=N_CART; ++r)
+	od[r] = v[r];
+      ad[_X_] = w[_Y_]*jap[j][_Z_] - w[_Z_]*jap[j][_Y_];
+      ad[_Y_] = w[_Z_]*jap[j][_X_] - w[_X_]*jap[j][_Z_];
+      ad[_Z_] = w[_X_]*jap[j][_Y_] - w[_Y_]*jap[j][_X_];
+
+      if (prismatic_joint_flag[j]) {
+
+	for (r=1; r<=N_CART; ++r) {
+	  dJ[(i-1)*6+r][j]        = ad[r];
+	  dJ[(i-1)*6+N_CART+r][j] = 0.0;
+	}
+
+      } else {
+
+	// d/dt (a x (p-o)) = ad x (p-o) + a x (pd-od)
+	revoluteGJacColumn(lp[l],jop[j],ad,c);
+	for (r=1; r<=N_CART; ++r) {
+	  dJ[(i-1)*6+r][j]        = c[r];
+	  dJ[(i-1)*6+N_CART+r][j] = ad[r];
+	  od[r] -= pd[r];
+	}
+	dJ[(i-1)*6+_X_][j] += jap[j][_Z_]*od[_Y_] - jap[j][_Y_]*od[_Z_];
+	dJ[(i-1)*6+_Y_][j] += jap[j][_X_]*od[_Z_] - jap[j][_Z_]*od[_X_];
+	dJ[(i-1)*6+_Z_][j] += jap[j][_Y_]*od[_X_] - jap[j][_X_]*od[_Y_];
+
+      }
+
+    }
+
+    // the base jacobian only depends on the endeffector position relative
+    // to the base in the columns of the base angular velocity; all other
+    // elements of dJb are zero
+    for (r=1; r<=N_CART; ++r)
+      d[r] = pd[r] - base_state.xd[r];
+
+    dJb[(i-1)*6+_Y_][N_CART+_X_] = -d[_Z_];
+    dJb[(i-1)*6+_Z_][N_CART+_X_] =  d[_Y_];
+    dJb[(i-1)*6+_X_][N_CART+_Y_] =  d[_Z_];
+    dJb[(i-1)*6+_Z_][N_CART+_Y_] = -d[_X_];
+    dJb[(i-1)*6+_X_][N_CART+_Z_] = -d[_Y_];
+    dJb[(i-1)*6+_Y_][N_CART+_Z_] =  d[_X_];
+
+  }
+
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  computeConstraintJacobian
@@ -0,0 +1,1071 @@
+/*!=============================================================================
+  ==============================================================================
+
+  \ingroup SLcommon
+
+  \file    SL_meshes.c
+
+  \author
+  \date    Oct 2026
+
+  ==============================================================================
+  \remarks
+
+      Triangle meshes for contact checking with arbitrary shapes. A mesh
+      is read from an OBJ (WAVEFRONT/MAJA) file with the same parser and
+      binary cache file as displayListFromObjFile(), and a bounding volume
+      hierarchy (BVH) of axis aligned boxes is built once over its
+      triangles. The BVH answers point-inside queries by ray casting and
+      closest-surface queries by branch and bound. Meshes need to be
+      closed for the point-inside query to be meaningful.
+
+  ============================================================================*/
+
+// system includes
+#include "stdio.h"
+#include "math.h"
+#include "string.h"
+#include "strings.h"
+#ifdef UNIX
+#include "sys/stat.h"
+#include "unistd.h"
+#endif
+#ifdef VX
+#include "sys/stat.h"
+#endif
+
+// local includes
+#include "SL.h"
+#include "SL_common.h"
+#include "SL_meshes.h"
+#include "utility.h"
+
+#define MAX_STRING_LEN    1000
+#define MESH_MAX_DEPTH    32    // below this depth, nodes are split in halves
+#define MESH_STACK_SIZE   128   // traversal stack (> MESH_MAX_DEPTH+log2(n_f))
+#define MAX_FACE_VERTICES 100   // max. number of vertices of a face in an OBJ file
+
+// variable declarations
+// local variables
+
+// the direction of the rays for the point-inside query: an arbitrary
+// direction that is unlikely to graze edges of axis aligned meshes
+static double ray_dir[3] = {0.5429, 0.6104, 0.5767};
+
+// global variables
+
+// local functions
+static int
+readObjBinFile(char *fname, Matrix *v, int *n_v, Matrix *vn, int *n_vn,
+	       iMatrix *f, int *n_f);
+static int
+readObjLine(FILE *fp, char *string);
+static int
+parseObjFace(char *string, int fv[][3]);
+static int
+checkObjIndices(iMatrix f, int n_f, int n_v, int n_vn);
+static int
+buildMeshNode(MeshPtr mesh, double *cent, int start, int count, int depth);
+static int
+rayHitsBox(MeshNode *node, double *o, double *inv_d);
+static int
+rayHitsTriangle(MeshPtr mesh, int t, double *o, double *d);
+static double
+closestPointTriangle(MeshPtr mesh, int t, double *p, double *c);
+static double
+boxDistance2(MeshNode *node, double *p);
+
+// extern variables
+
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readMesh
+\date  Oct 2026
+
+\remarks
+
+        Reads a triangle mesh from an OBJ file, scales the vertices, and
+        builds the bounding volume hierarchy
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : OBJ file name
+ \param[in]     scale   : scaling of the mesh in x,y,z
+
+ returns a pointer to the new mesh, or NULL for failure
+
+ ******************************************************************************/
+MeshPtr
+readMesh(char *fname, double *scale)
+{
+  int      i,j;
+  int      n_v,n_vn,n_f;
+  Matrix   v;
+  iMatrix  f;
+  double   aux;
+  double  *cent;
+  double   e1[3],e2[3];
+  MeshPtr  mesh;
+
+  if (!readObjFile(fname,&v,&n_v,NULL,&n_vn,&f,&n_f))
+    return NULL;
+
+  if (n_f == 0) {
+    printf("OBJ file >%s< has no faces\n",fname);
+    my_free_matrix(v,1,n_v,1,3);
+    my_free_imatrix(f,1,n_f,1,9);
+    return NULL;
+  }
+
+  mesh = my_calloc(1,sizeof(Mesh),MY_STOP);
+  strncpy(mesh->fname,fname,sizeof(mesh->fname)-1);
+  mesh->n_v   = n_v;
+  mesh->n_f   = n_f;
+  mesh->v     = my_calloc(3*n_v,sizeof(double),MY_STOP);
+  mesh->f     = my_calloc(3*n_f,sizeof(int),MY_STOP);
+  mesh->fn    = my_calloc(3*n_f,sizeof(double),MY_STOP);
+  mesh->tri   = my_calloc(n_f,sizeof(int),MY_STOP);
+  mesh->nodes = my_calloc(2*n_f,sizeof(MeshNode),MY_STOP);
+  cent        = my_calloc(3*n_f,sizeof(double),MY_STOP);
+
+  // the scaled vertices and the bounding radius
+  mesh->radius = 0.0;
+  for (i=0; i<n_v; ++i) {
+    aux = 0.0;
+    for (j=0; j<3; ++j) {
+      mesh->v[3*i+j] = v[i+1][j+1]*scale[j+1];
+      aux += sqr(mesh->v[3*i+j]);
+    }
+    if (sqrt(aux) > mesh->radius)
+      mesh->radius = sqrt(aux);
+  }
+
+  // the triangles, their normals (counter-clockwise faces point outward),
+  // and their centroids
+  for (i=0; i<n_f; ++i) {
+    for (j=0; j<3; ++j) {
+      if (f[i+1][j+1] < 1 || f[i+1][j+1] > n_v) {
+	printf("Invalid vertex index %d in face %d of >%s<\n",f[i+1][j+1],i+1,fname);
+	my_free_matrix(v,1,n_v,1,3);
+	my_free_imatrix(f,1,n_f,1,9);
+	free(cent);
+	freeMesh(mesh);
+	return NULL;
+      }
+      mesh->f[3*i+j] = f[i+1][j+1]-1;
+    }
+
+    for (j=0; j<3; ++j) {
+      e1[j] = mesh->v[3*mesh->f[3*i+1]+j] - mesh->v[3*mesh->f[3*i]+j];
+      e2[j] = mesh->v[3*mesh->f[3*i+2]+j] - mesh->v[3*mesh->f[3*i]+j];
+      cent[3*i+j] = (mesh->v[3*mesh->f[3*i]+j] + mesh->v[3*mesh->f[3*i+1]+j] +
+		     mesh->v[3*mesh->f[3*i+2]+j])/3.;
+    }
+    mesh->fn[3*i+0] = e1[1]*e2[2]-e1[2]*e2[1];
+    mesh->fn[3*i+1] = e1[2]*e2[0]-e1[0]*e2[2];
+    mesh->fn[3*i+2] = e1[0]*e2[1]-e1[1]*e2[0];
+    aux = sqrt(sqr(mesh->fn[3*i])+sqr(mesh->fn[3*i+1])+sqr(mesh->fn[3*i+2]));
+    if (aux > 0)
+      for (j=0; j<3; ++j)
+	mesh->fn[3*i+j] /= aux;
+
+    mesh->tri[i] = i;
+  }
+
+  // the BVH
+  mesh->n_nodes = 0;
+  buildMeshNode(mesh, cent, 0, n_f, 0);
+
+  printf("Mesh >%s<: %d triangles, %d BVH nodes\n",fname,n_f,mesh->n_nodes);
+
+  // clean up
+  my_free_matrix(v,1,n_v,1,3);
+  my_free_imatrix(f,1,n_f,1,9);
+  free(cent);
+
+  return mesh;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  freeMesh
+\date  Oct 2026
+
+\remarks
+
+        frees all memory of a mesh
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mesh    : pointer to mesh
+
+ ******************************************************************************/
+void
+freeMesh(MeshPtr mesh)
+{
+  if (mesh == NULL)
+    return;
+
+  free(mesh->v);
+  free(mesh->f);
+  free(mesh->fn);
+  free(mesh->tri);
+  free(mesh->nodes);
+  free(mesh);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkInsideMesh
+\date  Oct 2026
+
+\remarks
+
+        checks whether a point is inside a closed mesh, by counting how
+        often a ray from the point crosses the surface
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mesh    : pointer to mesh
+ \param[in]     x       : point in mesh coordinates
+
+ returns TRUE if the point is inside, and FALSE otherwise
+
+ ******************************************************************************/
+int
+checkInsideMesh(MeshPtr mesh, double *x)
+{
+  int       i,j;
+  int       n_stack=0;
+  int       stack[MESH_STACK_SIZE];
+  int       n_hits=0;
+  double    o[3];
+  double    inv_d[3];
+  MeshNode *node;
+
+  for (j=0; j<3; ++j) {
+    o[j] = x[j+1];
+    inv_d[j] = 1./ray_dir[j];
+  }
+
+  stack[n_stack++] = 0;
+  while (n_stack > 0) {
+
+    node = &mesh->nodes[stack[--n_stack]];
+    if (!rayHitsBox(node, o, inv_d))
+      continue;
+
+    if (node->left < 0) {
+      for (i=node->start; i<node->start+node->count; ++i)
+	n_hits += rayHitsTriangle(mesh, mesh->tri[i], o, ray_dir);
+    } else {
+      stack[n_stack++] = node->left;
+      stack[n_stack++] = node->right;
+    }
+
+  }
+
+  return (n_hits%2 == 1);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getClosestPointMesh
+\date  Oct 2026
+
+\remarks
+
+        finds the point on the mesh surface that is closest to a query
+        point. Subtrees of the BVH whose bounding box is further away than
+        the closest triangle so far are skipped, and the nearer child of
+        a node is searched first.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mesh    : pointer to mesh
+ \param[in]     x       : query point in mesh coordinates
+ \param[out]    c       : closest point on the surface in mesh coordinates
+ \param[out]    n       : outward unit normal of the closest triangle
+
+ returns the distance between x and c
+
+ ******************************************************************************/
+double
+getClosestPointMesh(MeshPtr mesh, double *x, double *c, double *n)
+{
+  int       i,j;
+  int       n_stack=0;
+  int       stack[MESH_STACK_SIZE];
+  int       best_t=-1;
+  double    p[3];
+  double    cc[3];
+  double    best_c[3] = {0.0,0.0,0.0};
+  double    d2;
+  double    best_d2=1.e30;
+  double    dl,dr;
+  MeshNode *node;
+
+  for (j=0; j<3; ++j)
+    p[j] = x[j+1];
+
+  stack[n_stack++] = 0;
+  while (n_stack > 0) {
+
+    node = &mesh->nodes[stack[--n_stack]];
+    if (boxDistance2(node, p) >= best_d2)
+      continue;
+
+    if (node->left < 0) {
+
+      for (i=node->start; i<node->start+node->count; ++i) {
+	d2 = closestPointTriangle(mesh, mesh->tri[i], p, cc);
+	if (d2 < best_d2) {
+	  best_d2 = d2;
+	  best_t  = mesh->tri[i];
+	  for (j=0; j<3; ++j)
+	    best_c[j] = cc[j];
+	}
+      }
+
+    } else {
+
+      // push the farther child first, such that the nearer one is popped first
+      dl = boxDistance2(&mesh->nodes[node->left], p);
+      dr = boxDistance2(&mesh->nodes[node->right], p);
+      if (dl < dr) {
+	stack[n_stack++] = node->right;
+	stack[n_stack++] = node->left;
+      } else {
+	stack[n_stack++] = node->left;
+	stack[n_stack++] = node->right;
+      }
+
+    }
+
+  }
+
+  for (j=0; j<3; ++j) {
+    c[j+1] = best_c[j];
+    n[j+1] = mesh->fn[3*best_t+j];
+  }
+
+  return sqrt(best_d2);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  buildMeshNode
+\date  Oct 2026
+
+\remarks
+
+        recursively builds the BVH for a range of the tri array. Nodes are
+        split at the midpoint of the longest axis of the triangle centroids.
+        If this does not separate the triangles, or if the tree gets too
+        deep, the range is split in halves.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out] mesh    : pointer to mesh
+ \param[in]     cent    : centroids of all triangles
+ \param[in]     start   : first element of the tri array
+ \param[in]     count   : number of elements of the tri array
+ \param[in]     depth   : depth of the node in the tree
+
+ returns the index of the new node
+
+ ******************************************************************************/
+static int
+buildMeshNode(MeshPtr mesh, double *cent, int start, int count, int depth)
+{
+  int       i,j,k;
+  int       id;
+  int       axis;
+  int       mid;
+  int       t;
+  double    cmin[3],cmax[3];
+  double    split;
+  MeshNode *node;
+
+  id   = mesh->n_nodes++;
+  node = &mesh->nodes[id];
+
+  // the bounding box of all triangles and of their centroids
+  for (j=0; j<3; ++j) {
+    node->min[j] = cmin[j] = 1.e30;
+    node->max[j] = cmax[j] = -1.e30;
+  }
+  for (i=start; i<start+count; ++i) {
+    t = mesh->tri[i];
+    for (j=0; j<3; ++j) {
+      for (k=0; k<3; ++k) {
+	if (mesh->v[3*mesh->f[3*t+k]+j] < node->min[j])
+	  node->min[j] = mesh->v[3*mesh->f[3*t+k]+j];
+	if (mesh->v[3*mesh->f[3*t+k]+j] > node->max[j])
+	  node->max[j] = mesh->v[3*mesh->f[3*t+k]+j];
+      }
+      if (cent[3*t+j] < cmin[j])
+	cmin[j] = cent[3*t+j];
+      if (cent[3*t+j] > cmax[j])
+	cmax[j] = cent[3*t+j];
+    }
+  }
+
+  node->start = start;
+  node->count = count;
+  node->left  = node->right = -1;
+
+  if (count <= MESH_LEAF_SIZE)
+    return id;
+
+  // partition the triangles at the midpoint of the longest centroid axis
+  axis = 0;
+  for (j=1; j<3; ++j)
+    if (cmax[j]-cmin[j] > cmax[axis]-cmin[axis])
+      axis = j;
+  split = 0.5*(cmin[axis]+cmax[axis]);
+
+  mid = start;
+  if (depth < MESH_MAX_DEPTH) {
+    for (i=start; i<start+count; ++i) {
+      if (cent[3*mesh->tri[i]+axis] < split) {
+	t = mesh->tri[i];
+	mesh->tri[i] = mesh->tri[mid];
+	mesh->tri[mid++] = t;
+      }
+    }
+  }
+  if (mid == start || mid == start+count)
+    mid = start + count/2;
+
+  // the children -- the recursion adds nodes, thus index the nodes by id
+  k = buildMeshNode(mesh, cent, start, mid-start, depth+1);
+  mesh->nodes[id].left  = k;
+  k = buildMeshNode(mesh, cent, mid, start+count-mid, depth+1);
+  mesh->nodes[id].right = k;
+  mesh->nodes[id].count = 0;
+
+  return id;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  rayHitsBox
+\date  Oct 2026
+
+\remarks
+
+        slab test whether a ray intersects the bounding box of a node
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     node    : pointer to node
+ \param[in]     o       : origin of ray
+ \param[in]     inv_d   : inverse of the ray direction per component
+
+ ******************************************************************************/
+static int
+rayHitsBox(MeshNode *node, double *o, double *inv_d)
+{
+  int    j;
+  double t1,t2;
+  double tmin = 0.0;
+  double tmax = 1.e30;
+
+  for (j=0; j<3; ++j) {
+    t1 = (node->min[j]-o[j])*inv_d[j];
+    t2 = (node->max[j]-o[j])*inv_d[j];
+    if (t1 > t2) {
+      double aux = t1; t1 = t2; t2 = aux;
+    }
+    if (t1 > tmin)
+      tmin = t1;
+    if (t2 < tmax)
+      tmax = t2;
+    if (tmin > tmax)
+      return FALSE;
+  }
+
+  return TRUE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  rayHitsTriangle
+\date  Oct 2026
+
+\remarks
+
+        Moeller-Trumbore test whether a ray intersects a triangle
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mesh    : pointer to mesh
+ \param[in]     t       : triangle index
+ \param[in]     o       : origin of ray
+ \param[in]     d       : direction of ray
+
+ returns 1 for an intersection in front of the origin, and 0 otherwise
+
+ ******************************************************************************/
+static int
+rayHitsTriangle(MeshPtr mesh, int t, double *o, double *d)
+{
+  int     j;
+  double *v0 = &mesh->v[3*mesh->f[3*t]];
+  double *v1 = &mesh->v[3*mesh->f[3*t+1]];
+  double *v2 = &mesh->v[3*mesh->f[3*t+2]];
+  double  e1[3],e2[3],p[3],q[3],s[3];
+  double  det,u,v;
+
+  for (j=0; j<3; ++j) {
+    e1[j] = v1[j]-v0[j];
+    e2[j] = v2[j]-v0[j];
+    s[j]  = o[j]-v0[j];
+  }
+
+  p[0] = d[1]*e2[2]-d[2]*e2[1];
+  p[1] = d[2]*e2[0]-d[0]*e2[2];
+  p[2] = d[0]*e2[1]-d[1]*e2[0];
+
+  det = e1[0]*p[0]+e1[1]*p[1]+e1[2]*p[2];
+  if (fabs(det) < 1.e-15)
+    return 0;
+
+  u = (s[0]*p[0]+s[1]*p[1]+s[2]*p[2])/det;
+  if (u < 0.0 || u > 1.0)
+    return 0;
+
+  q[0] = s[1]*e1[2]-s[2]*e1[1];
+  q[1] = s[2]*e1[0]-s[0]*e1[2];
+  q[2] = s[0]*e1[1]-s[1]*e1[0];
+
+  v = (d[0]*q[0]+d[1]*q[1]+d[2]*q[2])/det;
+  if (v < 0.0 || u+v > 1.0)
+    return 0;
+
+  return ((e2[0]*q[0]+e2[1]*q[1]+e2[2]*q[2])/det > 0.0);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  closestPointTriangle
+\date  Oct 2026
+
+\remarks
+
+        computes the point on a triangle closest to a query point, by
+        checking in which Voronoi region of the triangle the point lies
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mesh    : pointer to mesh
+ \param[in]     t       : triangle index
+ \param[in]     p       : query point
+ \param[out]    c       : closest point on triangle
+
+ returns the squared distance between p and c
+
+ ******************************************************************************/
+static double
+closestPointTriangle(MeshPtr mesh, int t, double *p, double *c)
+{
+  int     j;
+  double *a = &mesh->v[3*mesh->f[3*t]];
+  double *b = &mesh->v[3*mesh->f[3*t+1]];
+  double *cv= &mesh->v[3*mesh->f[3*t+2]];
+  double  ab[3],ac[3],ap[3],bp[3],cp[3];
+  double  d1,d2,d3,d4,d5,d6;
+  double  va,vb,vc;
+  double  v,w,denom;
+
+  for (j=0; j<3; ++j) {
+    ab[j] = b[j]-a[j];
+    ac[j] = cv[j]-a[j];
+    ap[j] = p[j]-a[j];
+    bp[j] = p[j]-b[j];
+    cp[j] = p[j]-cv[j];
+  }
+
+  d1 = ab[0]*ap[0]+ab[1]*ap[1]+ab[2]*ap[2];
+  d2 = ac[0]*ap[0]+ac[1]*ap[1]+ac[2]*ap[2];
+  d3 = ab[0]*bp[0]+ab[1]*bp[1]+ab[2]*bp[2];
+  d4 = ac[0]*bp[0]+ac[1]*bp[1]+ac[2]*bp[2];
+  d5 = ab[0]*cp[0]+ab[1]*cp[1]+ab[2]*cp[2];
+  d6 = ac[0]*cp[0]+ac[1]*cp[1]+ac[2]*cp[2];
+
+  vc = d1*d4 - d3*d2;
+  vb = d5*d2 - d1*d6;
+  va = d3*d6 - d5*d4;
+
+  if (d1 <= 0.0 && d2 <= 0.0) {                         // vertex a
+    for (j=0; j<3; ++j) c[j] = a[j];
+  } else if (d3 >= 0.0 && d4 <= d3) {                   // vertex b
+    for (j=0; j<3; ++j) c[j] = b[j];
+  } else if (d6 >= 0.0 && d5 <= d6) {                   // vertex c
+    for (j=0; j<3; ++j) c[j] = cv[j];
+  } else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {     // edge ab
+    v = d1/(d1-d3);
+    for (j=0; j<3; ++j) c[j] = a[j] + v*ab[j];
+  } else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {     // edge ac
+    w = d2/(d2-d6);
+    for (j=0; j<3; ++j) c[j] = a[j] + w*ac[j];
+  } else if (va <= 0.0 && (d4-d3) >= 0.0 && (d5-d6) >= 0.0) { // edge bc
+    w = (d4-d3)/((d4-d3)+(d5-d6));
+    for (j=0; j<3; ++j) c[j] = b[j] + w*(cv[j]-b[j]);
+  } else {                                              // inside the face
+    denom = 1.0/(va+vb+vc);
+    v = vb*denom;
+    w = vc*denom;
+    for (j=0; j<3; ++j) c[j] = a[j] + ab[j]*v + ac[j]*w;
+  }
+
+  return sqr(p[0]-c[0])+sqr(p[1]-c[1])+sqr(p[2]-c[2]);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  boxDistance2
+\date  Oct 2026
+
+\remarks
+
+        squared distance of a point from the bounding box of a node (zero
+        inside the box)
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     node    : pointer to node
+ \param[in]     p       : query point
+
+ ******************************************************************************/
+static double
+boxDistance2(MeshNode *node, double *p)
+{
+  int    j;
+  double d2 = 0.0;
+
+  for (j=0; j<3; ++j) {
+    if (p[j] < node->min[j])
+      d2 += sqr(node->min[j]-p[j]);
+    else if (p[j] > node->max[j])
+      d2 += sqr(p[j]-node->max[j]);
+  }
+
+  return d2;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readObjFile
+\date  Oct 2026
+
+\remarks
+
+        reads the vertices, normals, and faces of an OBJ (WAVEFRONT/MAJA)
+        file. This is the parser for both the meshes of the simulation and
+        the display lists of displayListFromObjFile(). Faces with more than
+        three vertices are triangulated as a fan. A binary version of the
+        file is written next to the OBJ file and used instead as long as it
+        is up to date and passes all checks. The binary file is unscaled
+        and written to a temporary file first, which is then renamed, such
+        that processes reading the file at the same time never see a
+        partial file.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : file name
+ \param[out]    v       : vertices (1..n_v,1..3)
+ \param[out]    n_v     : number of vertices
+ \param[out]    vn      : normals (1..n_vn,1..3), or NULL if not needed
+ \param[out]    n_vn    : number of normals
+ \param[out]    f       : triangles (1..n_f,1..9): vertex,texture,normal indices
+ \param[out]    n_f     : number of triangles
+
+ returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+int
+readObjFile(char *fname, Matrix *v, int *n_v, Matrix *vn, int *n_vn,
+	    iMatrix *f, int *n_f)
+{
+  int     j,k,n;
+  FILE   *fp;
+  char    string[MAX_STRING_LEN+1];
+  char    fnamebin[300];
+  char    fnametmp[320];
+  int     c;
+  char    key[10];
+  char    s[100];
+  int     fv[MAX_FACE_VERTICES+1][3];
+  Matrix  vnl=NULL;
+  struct  stat sfile;
+  struct  stat sfilebin;
+
+  *n_v = *n_vn = *n_f = 0;
+
+  // check whether binary version exists and is up to date
+  sprintf(fnamebin,"%s.bin",fname);
+  if (stat(fnamebin,&sfilebin) == 0) {
+    if (stat(fname,&sfile) == 0 && sfile.st_mtime > sfilebin.st_mtime)
+      remove(fnamebin);
+  }
+
+  if (readObjBinFile(fnamebin,v,n_v,&vnl,n_vn,f,n_f)) {
+    if (vn != NULL)
+      *vn = vnl;
+    else if (*n_vn > 0)
+      my_free_matrix(vnl,1,*n_vn,1,3);
+    return TRUE;
+  }
+
+  // try reading the ascii file
+  fp = fopen(fname,"r");
+  if (fp == NULL) {
+    printf("Cannot read OBJ file >%s<\n",fname);
+    return FALSE;
+  }
+
+  printf("Processing %s ...\n",fname);
+
+  // count the number of triangles, vertices, normals in file
+  while (TRUE) {
+
+    c = readObjLine(fp,string);
+    if (c == FALSE) {
+      printf("ERROR: max. string length exceeded\n");
+      fclose(fp);
+      return FALSE;
+    }
+
+    key[0] = '\0';
+    sscanf(string,"%9s",key);
+    if (strcmp(key,"vn")==0)
+      ++(*n_vn);
+    else if (strcmp(key,"f")==0) {
+      n = parseObjFace(string,fv);
+      if (n < 3) {
+	printf("Couldn't parse face information >%s< in >%s<\n",string,fname);
+	fclose(fp);
+	return FALSE;
+      }
+      *n_f += n-2;
+    } else if (strcmp(key,"v")==0)
+      ++(*n_v);
+
+    if (c == EOF)
+      break;
+
+  }
+
+  rewind(fp);
+
+  *v = my_matrix(1,*n_v,1,3);
+  *f = my_imatrix(1,*n_f,1,9); // first 3 for vertex, next for texture, last 3 for normal
+  if (*n_vn > 0)
+    vnl = my_matrix(1,*n_vn,1,3);
+
+  // get the data
+  *n_v = *n_f = *n_vn = 0;
+  while (TRUE) {
+
+    c = readObjLine(fp,string);
+
+    key[0] = '\0';
+    sscanf(string,"%9s",key);
+    if (strcmp(key,"vn")==0) {
+      ++(*n_vn);
+      sscanf(string,"%s %lf %lf %lf",s,&vnl[*n_vn][1],&vnl[*n_vn][2],&vnl[*n_vn][3]);
+
+    } else if (strcmp(key,"v")==0) {
+      ++(*n_v);
+      sscanf(string,"%s %lf %lf %lf",s,&(*v)[*n_v][1],&(*v)[*n_v][2],&(*v)[*n_v][3]);
+
+    } else if (strcmp(key,"f")==0) {
+
+      // a fan of triangles (1,k-1,k) over the face vertices
+      n = parseObjFace(string,fv);
+      for (k=3; k<=n; ++k) {
+	++(*n_f);
+	for (j=0; j<3; ++j) {
+	  (*f)[*n_f][1+3*j] = fv[1][j];
+	  (*f)[*n_f][2+3*j] = fv[k-1][j];
+	  (*f)[*n_f][3+3*j] = fv[k][j];
+	}
+      }
+
+    }
+
+    if (c == EOF)
+      break;
+  }
+  fclose(fp);
+
+  printf("#faces=%d  #vertices=%d   #normals=%d\n",*n_f,*n_v,*n_vn);
+
+  if (!checkObjIndices(*f,*n_f,*n_v,*n_vn)) {
+    printf("Invalid vertex or normal index in >%s<\n",fname);
+    my_free_matrix(*v,1,*n_v,1,3);
+    my_free_imatrix(*f,1,*n_f,1,9);
+    if (*n_vn > 0)
+      my_free_matrix(vnl,1,*n_vn,1,3);
+    return FALSE;
+  }
+
+  // write the binary file to a temporary file which replaces the binary
+  // file in one step
+#ifdef UNIX
+  sprintf(fnametmp,"%s.%d.tmp",fnamebin,(int)getpid());
+#else
+  sprintf(fnametmp,"%s.tmp",fnamebin);
+#endif
+  fp = fopen(fnametmp,"w");
+  if (fp != NULL) {
+    fprintf(fp,"%d %d %d\n",*n_v,*n_vn,*n_f);
+    fwrite_mat(fp,*v);
+    if (*n_vn > 0)
+      fwrite_mat(fp,vnl);
+    fwrite_imat(fp,*f);
+    if (fclose(fp) != 0 || rename(fnametmp,fnamebin) != 0) {
+      printf("Cannot write binary OBJ file >%s<\n",fnamebin);
+      remove(fnametmp);
+    }
+  }
+
+  if (vn != NULL)
+    *vn = vnl;
+  else if (*n_vn > 0)
+    my_free_matrix(vnl,1,*n_vn,1,3);
+
+  return TRUE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readObjBinFile
+\date  Oct 2026
+
+\remarks
+
+        reads the binary version of an OBJ file as written by readObjFile().
+        The stored counts, the size of the file, and all indices of the
+        triangles are checked, such that a truncated or stale file is 
+        rejected.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : file name of the binary file
+ \param[out]    v       : vertices (1..n_v,1..3)
+ \param[out]    n_v     : number of vertices
+ \param[out]    vn      : normals (1..n_vn,1..3)
+ \param[out]    n_vn    : number of normals
+ \param[out]    f       : triangles (1..n_f,1..9)
+ \param[out]    n_f     : number of triangles
+
+ returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+static int
+readObjBinFile(char *fname, Matrix *v, int *n_v, Matrix *vn, int *n_vn,
+	       iMatrix *f, int *n_f)
+{
+  FILE   *fp;
+  int     rc;
+  int     ok;
+
+  *n_v = *n_vn = *n_f = 0;
+
+  fp = fopen(fname,"r");
+  if (fp == NULL)
+    return FALSE;
+
+  rc = fscanf(fp,"%d %d %d",n_v,n_vn,n_f);
+  if (rc != 3 || fgetc(fp) != '\n' || *n_v < 1 || *n_vn < 0 || *n_f < 1) {
+    printf("Invalid binary OBJ file >%s< -- reading the OBJ file\n",fname);
+    fclose(fp);
+    *n_v = *n_vn = *n_f = 0;
+    return FALSE;
+  }
+
+  *v = my_matrix(1,*n_v,1,3);
+  *f = my_imatrix(1,*n_f,1,9);
+  if (*n_vn > 0)
+    *vn = my_matrix(1,*n_vn,1,3);
+
+  ok = fread_mat(fp,*v);
+  if (ok && *n_vn > 0)
+    ok = fread_mat(fp,*vn);
+  if (ok)
+    ok = fread_imat(fp,*f);
+  if (ok)
+    ok = (fgetc(fp) == EOF);
+  if (ok)
+    ok = checkObjIndices(*f,*n_f,*n_v,*n_vn);
+  fclose(fp);
+
+  if (!ok) {
+    printf("Invalid binary OBJ file >%s< -- reading the OBJ file\n",fname);
+    my_free_matrix(*v,1,*n_v,1,3);
+    my_free_imatrix(*f,1,*n_f,1,9);
+    if (*n_vn > 0)
+      my_free_matrix(*vn,1,*n_vn,1,3);
+    *n_v = *n_vn = *n_f = 0;
+    return FALSE;
+  }
+
+  return TRUE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readObjLine
+\date  Oct 2026
+
+\remarks
+
+        reads the next line of an OBJ file
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fp      : the file
+ \param[out]    string  : the line (MAX_STRING_LEN+1 characters)
+
+ returns '\n' or EOF for the end of the line, and FALSE if the line is
+ too long
+
+ ******************************************************************************/
+static int
+readObjLine(FILE *fp, char *string)
+{
+  int i=0;
+  int c;
+
+  while ((c=fgetc(fp)) != '\n' && c != EOF) {
+    string[i++] = c;
+    if ( i >= MAX_STRING_LEN ) {
+      string[i] = '\0';
+      return FALSE;
+    }
+  }
+  string[i] = '\0';
+
+  return c;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  parseObjFace
+\date  Oct 2026
+
+\remarks
+
+        parses the vertex, texture, and normal indices of a face line of an
+        OBJ file. Missing texture or normal indices are returned as zero.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     string  : the face line
+ \param[out]    fv      : vertex,texture,normal indices of the face vertices
+                          (1..n)
+
+ returns the number of face vertices n, or 0 for failure
+
+ ******************************************************************************/
+static int
+parseObjFace(char *string, int fv[][3])
+{
+  int   n=0;
+  int   pos;
+  char  s[100];
+  char *str;
+
+  // skip the key
+  if (sscanf(string,"%99s%n",s,&pos) != 1)
+    return 0;
+  str = string+pos;
+
+  while (sscanf(str,"%99s%n",s,&pos) == 1) {
+    str += pos;
+    if (++n > MAX_FACE_VERTICES) {
+      printf("More than %d vertices in a face\n",MAX_FACE_VERTICES);
+      return 0;
+    }
+    fv[n][0] = fv[n][1] = fv[n][2] = 0;
+    if (sscanf(s,"%d/%d/%d",&fv[n][0],&fv[n][1],&fv[n][2]) == 3) {
+      ; // vertex, texture, and normal info
+    } else if (sscanf(s,"%d//%d",&fv[n][0],&fv[n][2]) == 2) {
+      ; // texture info is missing
+    } else if (sscanf(s,"%d/%d",&fv[n][0],&fv[n][1]) == 2) {
+      ; // normal info is missing
+    } else if (sscanf(s,"%d",&fv[n][0]) != 1) {
+      return 0;
+    }
+  }
+
+  return n;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkObjIndices
+\date  Oct 2026
+
+\remarks
+
+        checks that all vertex and normal indices of the triangles are
+        valid
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     f       : triangles (1..n_f,1..9)
+ \param[in]     n_f     : number of triangles
+ \param[in]     n_v     : number of vertices
+ \param[in]     n_vn    : number of normals
+
+ returns TRUE if all indices are valid, and FALSE otherwise
+
+ ******************************************************************************/
+static int
+checkObjIndices(iMatrix f, int n_f, int n_v, int n_vn)
+{
+  int i,j;
+
+  for (i=1; i<=n_f; ++i) {
+    for (j=1; j<=3; ++j) {
+      if (f[i][j] < 1 || f[i][j] > n_v)
+	return FALSE;
+      if (f[i][j+6] < 0 || f[i][j+6] > n_vn)
+	return FALSE;
+    }
+  }
+
+  return TRUE;
+
+}
@@ -639,10 +639,10 @@ triggerSynchronization(void)
     semGive(sm_vision_servo_sem);
 
 #ifdef VX
-  if (motor_servo_calls%iaux==1)
+  if (motor_servo_calls%iaux==1 && !no_graphics_flag)
     semFlush(sm_openGL_servo_sem);
 #else
-  {
+  if (!no_graphics_flag) {
 #ifdef __XENO__
     RTIME t = rt_timer_read();
     current_time = (double)t / 1.e9;
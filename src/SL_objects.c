@@ -17,11 +17,15 @@
 
 // SL general includes of system headers
 #include "SL_system_headers.h"
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 /* private includes */
 #include "SL.h"
 #include "SL_objects.h"
 #include "SL_terrains.h"
+#include "SL_meshes.h"
 #include "SL_common.h"
 #include "SL_kinematics.h"
 #include "SL_simulation_servo.h"
@@ -29,7 +33,18 @@
 #include "SL_unix_common.h"
 
 // defines
-#define N_CSPECS_THREADS 8
+#define N_CSPECS_THREADS 8       // default number of contact threads
+#define MIN_CSPECS_THREADED 8    // fewer contact specs are processed inline
+#define CONTACT_CHUNK_SIZE 4     // contact points per chunk of force accumulation
+#define MAX_BROAD_PHASE_CELLS 32768
+#define CULL_MIN_DIST    0.005    // min. distance bound worth culling a point
+#define CULL_RETRY_STEPS 10       // steps until a close point is bounded again
+#define CULL_EPS         1.e-9    // safety margin for the distance bound
+#define IMMINENT_MAX_ACC 100.0    // assumed max. acceleration of contact points [m/s^2]
+#define OBJ_BLOCK_SIZE   64       // objects per block of the object store
+#define OBJ_HANDLE_SLOTS 1048576  // max. number of slots of the object store
+#define OBJ_HASH_EMPTY   -1       // unused entry of the name hash table
+#define OBJ_HASH_DELETED -2       // deleted entry of the name hash table
 
 // contact related defines
 enum ForceConditions {
@@ -73,11 +88,119 @@ static   int            use_threads = TRUE;
 //static   int            use_threads = TRUE;
 ////////////////////////////////////////////////////////
 
-static   pthread_t      cspecs_thread[N_CSPECS_THREADS+1];  // threads for contact checking
-static   ContactSpecs  *cspecs_data[N_CSPECS_THREADS+1];    // data used for thread communication
-static   sl_rt_cond     cspecs_status[N_CSPECS_THREADS+1];  // conditional variable of thread
-static   sl_rt_mutex    cspecs_mutex[N_CSPECS_THREADS+1];   // mutex of threads
-static   int            n_cspecs_data[N_CSPECS_THREADS+1];  // counter of how much to do per thread
+// the contact threads form a persistent pool. The work of one call of 
+// checkContacts() is organized in chunks of CONTACT_CHUNK_SIZE consecutive
+// contact points. The chunks with contacts are partitioned among the pool 
+// threads and the calling thread. Each thread works on its own partition 
+// first, and then steals from the partitions of the other threads. A chunk
+// processes the contact specs of its points, and accumulates their forces in
+// a private accumulator of the chunk. The chunk accumulators are merged with
+// a tree reduction of fixed shape, such that the resulting forces are bit
+// identical for any number of threads.
+static   int            n_cspecs_threads = N_CSPECS_THREADS; // number of pool threads
+static   int            cspecs_pool_active = FALSE;  // pool threads are running
+static   pthread_t     *cspecs_thread;               // threads for contact checking
+static   ContactSpecs  *cspecs_data;                 // contact specs to be processed
+static   int            n_cspecs_data;               // number of contact specs
+static   int           *cspecs_next;                 // next chunk of each partition
+static   int           *cspecs_end;                  // end of each partition
+static   int           *contact_spec;                // contact spec of each contact point
+static   int            n_contact_chunks;            // number of chunks of contact points
+static   int           *chunk_used;                  // chunk needs to be processed
+static   int           *active_chunks;               // chunks to be processed in ascending order
+static   int            n_active_chunks;             // number of chunks to be processed
+static   SL_uext       *chunk_ucontact;              // DOF force accumulator of each chunk
+static   SL_uext       *contact_uobj;                // object force and torque of each contact point
+static   sl_rt_mutex    cspecs_mutex;                // mutex of the pool
+static   sl_rt_cond     cspecs_start;                // signals new work to the pool
+static   sl_rt_cond     cspecs_done;                 // signals that all pool threads are done
+static   int            cspecs_generation = 0;       // counts the batches of work
+static   int            n_cspecs_threads_done;       // pool threads done with current batch
+
+// the broad phase of contact checking uses a uniform grid over the bounding 
+// boxes of all objects with finite extent. The contact points are sorted into
+// the grid cells at every call of checkContacts(), and each object is only 
+// tested against the points in the cells that overlap its bounding box. 
+// Terrains have no finite extent and are tested against all points.
+typedef struct {
+  int        n_objs;          //!< number of objects in the object list
+  ObjectPtr *optrs;           //!< all objects in the order of the object list
+  int       *lo;              //!< lowest grid cell per dimension of each object
+  int       *hi;              //!< highest grid cell per dimension of each object
+  int        n[N_CART+1];     //!< number of grid cells per dimension
+  int        n_cells;         //!< total number of grid cells
+  double     xmin[N_CART+1];  //!< lower corner of the grid
+  double     cell_size;       //!< edge length of a grid cell
+  int       *cell_start;      //!< start of each cell in cell_pts
+  int       *cell_pts;        //!< indices of the contact points in each cell
+} BroadPhase;
+
+static   BroadPhase     bp;
+static   int            bp_update_flag = TRUE;  // objects changed since last build
+
+// structure-of-arrays buffer of all active contact points, which is updated
+// once per call of checkContacts(), and scratch memory for the containment
+// kernels
+typedef struct {
+  int        n;               //!< number of active contact points
+  int       *id;              //!< contact ID of each point
+  int       *cell;            //!< grid cell of each point (-1: outside of grid)
+  int       *obj;             //!< index of the object in contact (-1: none)
+  double    *x;               //!< contact point positions in world coordinates
+  double    *y;
+  double    *z;
+  int       *cand;            //!< candidate points of the current object
+  double    *cx;              //!< candidate positions relative to the object
+  double    *cy;
+  double    *cz;
+  int       *hits;            //!< candidates that are inside the current object
+} ContactPointBuffer;
+
+static   ContactPointBuffer cpb;
+
+// temporal coherence culling of contact points: for a contact point without
+// contact, a lower bound of its distance to all contact objects is recorded
+// together with its current position. As long as the point moved less than
+// this distance, it cannot be inside an object, and it is skipped by the 
+// contact checking. The point is checked again as soon as its travel could
+// have used up the margin. Any change of the objects invalidates all bounds.
+typedef struct {
+  double     dist;            //!< distance bound (<=0: no valid bound)
+  double     x[N_CART+1];     //!< position at which the bound was recorded
+  int        retry;           //!< steps until a bound is recorded again
+} ContactCull;
+
+static   ContactCull   *ccull;
+static   int            cull_contacts = TRUE;   // use contact culling
+
+// velocities of all simulated links, computed once per call of checkContacts()
+static   Matrix         link_omega_sim;   // angular velocity of each link
+static   Matrix         link_vel_sim;     // linear velocity at the world origin of each link
+
+// all objects live in an object store of fixed size blocks, such that object
+// pointers remain valid when the store grows. The objects are addressed by 
+// integer handles, which combine the slot in the store with a generation count 
+// of the slot in order to detect handles of deleted objects. Names are mapped
+// to slots with an open addressing hash table. The objs list is maintained in
+// addition for traversing the objects in the order they were added.
+typedef struct {
+  int        n_slots;         //!< number of allocated slots
+  int        n_used;          //!< number of slots holding an object
+  int        n_blocks;        //!< number of allocated blocks
+  ObjectPtr *blocks;          //!< blocks of OBJ_BLOCK_SIZE objects
+  int       *gen;             //!< generation count of each slot
+  int       *used;            //!< TRUE if the slot holds an object
+  int       *free_slots;      //!< stack of unused slots
+  int        n_free;          //!< number of unused slots
+  int        hash_size;       //!< size of the hash table (power of 2)
+  int        n_hash_deleted;  //!< number of deleted entries in the hash table
+  int       *hash;            //!< slot of each hash table entry
+} ObjectStore;
+
+static   ObjectStore    ostore;
+static   ObjectPtr      objs_last = NULL;   // last object in the objs list
+
+#define OBJ_SLOT_PTR(s) (&ostore.blocks[(s)/OBJ_BLOCK_SIZE][(s)%OBJ_BLOCK_SIZE])
 
 // global functions 
 
@@ -95,7 +218,33 @@ static void  projectForce(ContactPtr cptr, ObjectPtr optr);
 static void  checkContactSpecifics(ContactSpecs cspecs);
 static void *contactThread(void *num);
 static void  spawnContactSpecsThread(long num) ;
-static void  accumulateFinalForces(ContactPtr cptr);
+static void  runContactThreadPool(void);
+static void  processContactChunks(int ID);
+static void  processContactChunk(int c);
+static void  reduceContactChunks(void);
+static void  accumulateFinalForces(ContactPtr cptr, SL_uext *uc, SL_uext *uo);
+static void  contactVelocityGlobal(int cID, double *v);
+static double computeObjectDistance(ObjectPtr optr, double *x);
+static void  buildBroadPhase(void);
+static int   getBroadPhaseCell(double *x);
+static int   checkInsideObject(ObjectPtr optr, double *x);
+static void  updateContactPointBuffer(void);
+static void  loadContactPointTerrainTiles(void);
+static int   getCandidatePoints(int k);
+static int   containmentKernel(ObjectPtr optr, int n, double *x, double *y, double *z,
+			       int *hits);
+static void  dispatchContactSpecs(int cID, ObjectPtr optr, double *x);
+static void  computeSurfaceContactSpecifics(int i, ObjectPtr optr, double *x,
+					    double *n, double depth);
+static void  recordContactCull(int p);
+static double computeObjectDistanceBound(ObjectPtr optr, double *x);
+static unsigned int hashObjName(char *name);
+static int   findObjSlot(char *name);
+static void  insertObjHash(int slot);
+static void  removeObjHash(int slot);
+static void  resizeObjHash(int size);
+static ObjectPtr allocObject(void);
+static void  releaseObject(ObjectPtr ptr);
 
 
 // external functions
@@ -126,22 +275,67 @@ initObjects(void)
   contacts = my_calloc(n_links+1+n,sizeof(Contact),MY_STOP);
   ucontact = my_calloc(n_dofs+1,sizeof(SL_uext),MY_STOP);
 
+  // link velocities for contact velocities
+  link_omega_sim = my_matrix(0,n_links,1,N_CART);
+  link_vel_sim   = my_matrix(0,n_links,1,N_CART);
+
+  // the contact point buffer
+  cpb.id   = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  cpb.cell = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  cpb.obj  = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  cpb.x    = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.y    = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.z    = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.cand = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  cpb.cx   = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.cy   = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.cz   = my_calloc(n_links+1+n,sizeof(double),MY_STOP);
+  cpb.hits = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  bp.cell_pts = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+
+  // the contact culling
+  ccull = my_calloc(n_links+1+n,sizeof(ContactCull),MY_STOP);
+
+  // the chunks for force accumulation
+  n_contact_chunks = (n_links+1+n+CONTACT_CHUNK_SIZE-1)/CONTACT_CHUNK_SIZE;
+  contact_spec   = my_calloc(n_links+1+n,sizeof(int),MY_STOP);
+  contact_uobj   = my_calloc(n_links+1+n,sizeof(SL_uext),MY_STOP);
+  chunk_used     = my_calloc(n_contact_chunks,sizeof(int),MY_STOP);
+  active_chunks  = my_calloc(n_contact_chunks,sizeof(int),MY_STOP);
+  chunk_ucontact = my_calloc(n_contact_chunks*(n_dofs+1),sizeof(SL_uext),MY_STOP);
+  if (read_parameter_pool_int(config_files[PARAMETERPOOL],"cull_contacts",&i))
+    cull_contacts = (i != 0);
+
   // initalize objects in the environment
   readObjects(config_files[OBJECTS]);
 
   n_contacts = n+n_links;
 
-  // allocate thread related data
-  for (i=1; i<=N_CSPECS_THREADS; ++i) 
-    cspecs_data[i]=my_calloc(n_contacts+1,sizeof(ContactSpecs),MY_STOP);
-
   // start contact threads
   if (strcmp(servo_name,"sim")==0 && use_threads) {
-    for (n=1; n<=N_CSPECS_THREADS; ++n) {
-      sl_rt_mutex_init(&(cspecs_mutex[n]));
-      sl_rt_cond_init(&(cspecs_status[n]));
-      spawnContactSpecsThread(n);
+
+    if (read_parameter_pool_int(config_files[PARAMETERPOOL],"n_contact_threads",&n))
+      n_cspecs_threads = (n > 0) ? n : 0;
+
+    if (n_cspecs_threads > 0) {
+
+      // allocate thread related data
+      cspecs_data   = my_calloc(n_contacts+2,sizeof(ContactSpecs),MY_STOP);
+      cspecs_thread = my_calloc(n_cspecs_threads+1,sizeof(pthread_t),MY_STOP);
+      cspecs_next   = my_calloc(n_cspecs_threads+1,sizeof(int),MY_STOP);
+      cspecs_end    = my_calloc(n_cspecs_threads+1,sizeof(int),MY_STOP);
+
+      sl_rt_mutex_init(&cspecs_mutex);
+      sl_rt_cond_init(&cspecs_start);
+      sl_rt_cond_init(&cspecs_done);
+
+      for (n=1; n<=n_cspecs_threads; ++n)
+	spawnContactSpecsThread(n);
+
+      cspecs_pool_active = TRUE;
+
     }
+
   }
 
   return TRUE;
@@ -178,29 +372,20 @@ addObject(char *name, int type, int contact, double *rgb, double *trans, double
 {
   int        i;
   ObjectPtr  ptr=NULL;
-  ObjectPtr  last_ptr=NULL;
   char       string[1000];
   int        n_cps=0, n_ops=0;
   int        new_obj_flag = TRUE;
 
   /* is object already present and only needs update? */
-  if (objs != NULL) {
-
-    ptr = objs;
-    do {
-      if (strcmp(ptr->name,name)==0) {
-	new_obj_flag = FALSE;
-	break;
-      }
-      last_ptr = ptr;
-      ptr = (ObjectPtr) ptr->nptr;
-    } while ( ptr != NULL);
-    
-  }
+  ptr = getObjPtrByName(name);
+  if (ptr != NULL)
+    new_obj_flag = FALSE;
 
   if (new_obj_flag) {
     /* allocate new object */
-    ptr = my_calloc(1,sizeof(Object),MY_STOP);
+    ptr = allocObject();
+    if (ptr == NULL)
+      return NULL;
   }
 
   if (cspecs == NULL) {
@@ -237,14 +422,32 @@ addObject(char *name, int type, int contact, double *rgb, double *trans, double
     ptr->contact_parms[i]=cspecs[i];
   }
 
+  // meshes are only needed for contact checking in the simulation; the mesh
+  // is re-read as its scale could have changed
+  if (type == MESH && strcmp(servo_name,"sim")==0) {
+    freeMesh(ptr->mesh);
+    sprintf(string,"%s%s",MESHES,name);
+    ptr->mesh = readMesh(string,scale);
+  }
+
+  // terrains are identified by a handle in contact queries
+  if (type == TERRAIN)
+    ptr->terrain = getContactTerrainHandle(name);
+
+  updateObjectGeometry(ptr);
+
   if (new_obj_flag) {
+    insertObjHash(ptr->handle % OBJ_HANDLE_SLOTS);
     ptr->nptr=NULL;
+    ptr->pptr=(char *) objs_last;
     if (objs == NULL) {
       objs = ptr;
     } else {
-      last_ptr->nptr = (char *) ptr;
+      objs_last->nptr = (char *) ptr;
     }
+    objs_last = ptr;
   }
+  bp_update_flag = TRUE;
 
   if (strcmp(servo_name,"task")==0)  // communicate info to other servos
     addObjectSync(name, type, contact, rgb, trans, rot, scale, cspecs, ospecs);
@@ -365,7 +568,7 @@ addCylinder(char *name, double *rgb, double *pos, double *rot,
    
 \remarks 
 
-       changes the object position by name (slower, since search is required)
+       changes the object position by name
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
@@ -384,9 +587,34 @@ changeObjPosByName(char *name, double *pos, double *rot)
 
   changeObjPosByPtr(ptr, pos, rot);
 
-  if (strcmp(servo_name,"task")==0)  // communicate info to other servos
-    changeObjPosByNameSync(name, pos, rot);
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  changeObjPosByHandle
+\date  Oct 2026
+   
+\remarks 
+
+       changes the object position by handle
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     handle     : handle of the object 
+ \param[in]     pos        : pointer to position vector 
+ \param[in]     rot        : pointer to rotation vector
 
+ ******************************************************************************/
+int
+changeObjPosByHandle(int handle, double *pos, double *rot)
+{
+  ObjectPtr ptr = getObjPtrByHandle(handle);
+  if (ptr == NULL) 
+    return FALSE;
+
+  changeObjPosByPtr(ptr, pos, rot);
 
   return TRUE;
 }
@@ -410,27 +638,44 @@ changeObjPosByName(char *name, double *pos, double *rot)
 int
 changeHideObjByName(char *name, int hide)
 {
-  ObjectPtr ptr;
-  int i;
-
-  if (objs == NULL) 
+  ObjectPtr ptr = getObjPtrByName(name);
+  if (ptr == NULL) 
     return FALSE;
 
-  ptr = objs;
+  return changeHideObjByHandle(ptr->handle, hide);
+  
+}
 
-  do {
-    if (strcmp(name,ptr->name)==0) {
-      ptr->hide = hide;
+/*!*****************************************************************************
+ *******************************************************************************
+\note  changeHideObjByHandle
+\date  Oct 2026
+   
+\remarks 
 
-      if (strcmp(servo_name,"task")==0)  // communicate info to other servos
-	changeHideObjByNameSync(name, hide);
+       changes the hide status of object by handle
 
-      return TRUE;
-    }
-    ptr = (ObjectPtr) ptr->nptr;
-  } while (ptr != NULL);
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-  return FALSE;
+ \param[in]     handle     : handle of the object 
+ \param[in]     hide       : TRUE/FALSE
+
+ ******************************************************************************/
+int
+changeHideObjByHandle(int handle, int hide)
+{
+  ObjectPtr ptr = getObjPtrByHandle(handle);
+  if (ptr == NULL) 
+    return FALSE;
+
+  ptr->hide = hide;
+  bp_update_flag = TRUE;
+
+  if (strcmp(servo_name,"task")==0)  // communicate info to other servos
+    changeHideObjByNameSync(ptr->name, hide);
+
+  return TRUE;
   
 }
 
@@ -454,26 +699,39 @@ changeHideObjByName(char *name, int hide)
 int
 getObjForcesByName(char *name, double *f, double *t)
 {
-  ObjectPtr ptr;
-  int i;
-
-  if (objs == NULL) 
+  ObjectPtr ptr = getObjPtrByName(name);
+  if (ptr == NULL) 
     return FALSE;
 
-  ptr = objs;
+  return getObjForcesByPtr(ptr, f, t);
+  
+}
 
-  do {
-    if (strcmp(name,ptr->name)==0) {
-      for (i=1;i<=N_CART; ++i) {
-	f[i] = ptr->f[i];
-	t[i] = ptr->t[i];
-      }
-      return TRUE;
-    }
-    ptr = (ObjectPtr) ptr->nptr;
-  } while (ptr != NULL);
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getObjForcesByHandle
+\date  Oct 2026
+   
+\remarks 
 
-  return FALSE;
+   returns the force and torque vector acting on an object
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     handle     : handle of the object 
+ \param[in]     f          : pointer to force vector 
+ \param[in]     t          : pointer to torque vector
+
+ ******************************************************************************/
+int
+getObjForcesByHandle(int handle, double *f, double *t)
+{
+  ObjectPtr ptr = getObjPtrByHandle(handle);
+  if (ptr == NULL) 
+    return FALSE;
+
+  return getObjForcesByPtr(ptr, f, t);
   
 }
 
@@ -526,22 +784,74 @@ getObjForcesByPtr(ObjectPtr ptr, double *f, double *t)
 ObjectPtr
 getObjPtrByName(char *name)
 {
-  ObjectPtr ptr;
-  int i;
+  int slot;
 
-  if (objs == NULL) 
+  slot = findObjSlot(name);
+  if (slot < 0) 
     return NULL;
 
-  ptr = objs;
+  return OBJ_SLOT_PTR(slot);
+  
+}
 
-  do {
-    if (strcmp(name,ptr->name)==0) {
-      return ptr;
-    }
-    ptr = (ObjectPtr) ptr->nptr;
-  } while (ptr != NULL);
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getObjHandleByName
+\date  Oct 2026
+   
+\remarks 
 
-  return NULL;
+   returns the handle of a specific object, or NO_OBJECT_HANDLE if the
+   object does not exist. Handles are only valid in the current process,
+   and become invalid when the object is deleted.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     name       : name of the object 
+
+ ******************************************************************************/
+int
+getObjHandleByName(char *name)
+{
+  ObjectPtr ptr = getObjPtrByName(name);
+  if (ptr == NULL) 
+    return NO_OBJECT_HANDLE;
+
+  return ptr->handle;
+  
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getObjPtrByHandle
+\date  Oct 2026
+   
+\remarks 
+
+   returns the pointer to a specific object, or NULL if the handle does not
+   refer to an existing object
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     handle     : handle of the object 
+
+ ******************************************************************************/
+ObjectPtr
+getObjPtrByHandle(int handle)
+{
+  int slot;
+
+  if (handle < 0)
+    return NULL;
+
+  slot = handle % OBJ_HANDLE_SLOTS;
+  if (slot >= ostore.n_slots || !ostore.used[slot] || 
+      ostore.gen[slot] != handle / OBJ_HANDLE_SLOTS)
+    return NULL;
+
+  return OBJ_SLOT_PTR(slot);
   
 }
 
@@ -574,6 +884,7 @@ changeObjPosByPtr(ObjectPtr ptr, double *pos, double *rot)
     ptr->trans[i]=pos[i];
     ptr->rot[i]=rot[i];
   }
+  updateObjectGeometry(ptr);
   
   if (strcmp(servo_name,"task")==0)  // communicate info to other servos
     changeObjPosByNameSync(ptr->name, pos, rot);
@@ -598,327 +909,1524 @@ changeObjPosByPtr(ObjectPtr ptr, double *pos, double *rot)
 int
 deleteObjByName(char *name)
 {
-  ObjectPtr ptr,ptr2;
-  char     *nptr;
-  int i;
-
-  if (objs == NULL) 
+  ObjectPtr ptr = getObjPtrByName(name);
+  if (ptr == NULL) 
     return FALSE;
 
-  ptr = objs;
-
-  do {
-    if (strcmp(name,ptr->name)==0) {
-      ptr2=objs;
-      if (ptr2 == ptr) {
-	objs = (ObjectPtr) ptr->nptr;
-      } else {
-	do {
-	  if (ptr2->nptr == (char *)ptr) {
-	    ptr2->nptr = ptr->nptr;
-	    break;
-	  }
-	  ptr2 = (ObjectPtr) ptr2->nptr;
-	} while (ptr2 != NULL);
-      }
-      free(ptr);
-      return TRUE;
-    }
-    ptr = (ObjectPtr) ptr->nptr;
-  } while (ptr != NULL);
-
-  if (strcmp(servo_name,"task")==0)  // communicate info to other servos
-    deleteObjByName(name);
-
-  return FALSE;
+  return deleteObjByHandle(ptr->handle);
   
 }
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  checkContacts
-\date  June 1999
+\note  deleteObjByHandle
+\date  Oct 2026
    
 \remarks 
 
-      checks for contacts and computes the contact forces
+       deletes an object by handle
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
-     none
+ \param[in]     handle     : handle of the object 
 
  ******************************************************************************/
-void
-checkContacts(void)
-
+int
+deleteObjByHandle(int handle)
 {
-  int       i,j;
-  ObjectPtr optr;
-  double    x[N_CART+1];
-  double    aux,aux1,aux2;
-  int       ind=0;
-  int       first_contact_flag = FALSE;
-  int       contact_flag = FALSE;
-  double    z;
-  double    n[N_CART+1];
-  double    v[N_CART+1];
-  char      tfname[100];
-  double    no_go;
-  double    dist_z;
-  ContactSpecs cspecs;
-  int       count_thread=0;
-  int       n_threads_used = N_CSPECS_THREADS;
-  int       threads_ready_flag;
+  ObjectPtr ptr;
+  char      name[STRING100];
 
+  ptr = getObjPtrByHandle(handle);
+  if (ptr == NULL) 
+    return FALSE;
 
-  /* zero contact forces */
-  bzero((void *)ucontact,sizeof(SL_uext)*(n_dofs+1));
-  bzero((void *)&cspecs,sizeof(ContactSpecs));
-  
-  /* if there are no objects, exit */
-  if (objs==NULL)
-    return;
-  
-  // zero all object forces and torques
-  optr = objs;
-  do { 
-    for (i=1; i<=N_CART; ++i)
-      optr->f[i] = optr->t[i] = 0.0;
-    optr = (ObjectPtr) optr->nptr;
-  } while (optr != NULL);
+  strcpy(name,ptr->name);
 
-  // zero thread counters
-  for (i=1; i<=N_CSPECS_THREADS; ++i)
-    n_cspecs_data[i] = 0;
-  
-  
-  for (i=0; i<=n_contacts; ++i) { /* loop over all contact points */
-    
-    if (!contacts[i].active)
-      continue;
-    
-    first_contact_flag = FALSE;
-    contact_flag = FALSE;
-    
-    optr = objs;
-    do {   /* check all objects */
-      
-      /* check whether this is a contact */
-      if (optr->contact_model == NO_CONTACT || optr->hide) {
-	optr = (ObjectPtr) optr->nptr;
-	continue;
-      }
-      
-      /* step one: transform potential contact point into object
-	 coordinates */
+  // the terrain board of a terrain object stays loaded, as other threads can
+  // still query it with its handle -- removeTerrainBoard() frees it
+  releaseObject(ptr);
+  bp_update_flag = TRUE;
 
-      // compute the current contact point
-      computeContactPoint(&(contacts[i]),link_pos_sim,Alink_sim,x);
+  if (strcmp(servo_name,"task")==0)  // communicate info to other servos
+    deleteObjByNameSync(name);
 
-      // convert to local coordinates
-      for (j=1; j<=N_CART; ++j)
-	x[j] -= optr->trans[j];
-      
-      // rotate the contact point into object centered coordinates
-      convertGlobal2Object(optr, x, x);
+  return TRUE;
+  
+}
 
-      // is this point inside the object? 
-      switch (optr->type) {
-      case CUBE: //---------------------------------------------------------------
-	if (fabs(x[1]) < optr->scale[1]/2. &&
-	    fabs(x[2]) < optr->scale[2]/2. &&
-	    fabs(x[3]) < optr->scale[3]/2.) {
+/*!*****************************************************************************
+ *******************************************************************************
+\note  hashObjName
+\date  Oct 2026
 
-	  cspecs.i = i;
-	  cspecs.optr = optr;
-	  for (j=1; j<=N_CART; ++j)
-	    cspecs.x[j] = x[j];
+\remarks
 
-	  if (use_threads) {
+       FNV-1a hash of an object name
 
-	    if (++count_thread > n_threads_used)
-	      count_thread = 1;
-	   
-	    cspecs_data[count_thread][++n_cspecs_data[count_thread]] = cspecs;
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
+ \param[in]     name       : name of the object
 
-	  } else {
+ ******************************************************************************/
+static unsigned int
+hashObjName(char *name)
+{
+  unsigned int h = 2166136261u;
 
-	    checkContactSpecifics(cspecs);
+  while (*name != '\0') {
+    h ^= (unsigned char) *name++;
+    h *= 16777619u;
+  }
 
-	  }
+  return h;
+}
 
-	  contact_flag = TRUE;
-	  
-	  optr = NULL;
-	  continue; /* only one object can be in contact with a contact point */
-	  
-	}
-	
-	break;
-	
-      case SPHERE: //---------------------------------------------------------------
-	if ((sqr(x[1]/optr->scale[1]*2.) + sqr(x[2]/optr->scale[2]*2.) + 
-	     sqr(x[3]/optr->scale[3]*2.)) < 1.0) {
+/*!*****************************************************************************
+ *******************************************************************************
+\note  findObjSlot
+\date  Oct 2026
 
-	  cspecs.i = i;
-	  cspecs.optr = optr;
-	  for (j=1; j<=N_CART; ++j)
-	    cspecs.x[j] = x[j];
+\remarks
 
-	  if (use_threads) {
+       returns the slot of an object in the object store, or -1 if there is
+       no object with this name
 
-	    if (++count_thread > n_threads_used)
-	      count_thread = 1;
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-	    cspecs_data[count_thread][++n_cspecs_data[count_thread]] = cspecs;
-	    
-	  } else {
+ \param[in]     name       : name of the object
 
-	    checkContactSpecifics(cspecs);
+ ******************************************************************************/
+static int
+findObjSlot(char *name)
+{
+  int i;
+  int mask;
 
-	  }
+  if (ostore.hash_size == 0)
+    return -1;
 
-	  contact_flag = TRUE;
+  mask = ostore.hash_size-1;
+  for (i = hashObjName(name) & mask; ostore.hash[i] != OBJ_HASH_EMPTY; i = (i+1) & mask)
+    if (ostore.hash[i] >= 0 && strcmp(OBJ_SLOT_PTR(ostore.hash[i])->name,name)==0)
+      return ostore.hash[i];
 
-	  optr=NULL;
-	  continue; /* only one object can be in contact with a contact point */
-	  
-	} 
-	
-	break;
-	
-	
-      case CYLINDER: //---------------------------------------------------------------
-	// the cylinder axis is aliged with te Z axis
-	if ((sqr(x[1]/optr->scale[1]*2.) + sqr(x[2]/optr->scale[2]*2.)) < 1.0 &&
-	    fabs(x[3]) < optr->scale[3]/2.) {
+  return -1;
+}
 
-	  cspecs.i = i;
-	  cspecs.optr = optr;
-	  for (j=1; j<=N_CART; ++j)
-	    cspecs.x[j] = x[j];
+/*!*****************************************************************************
+ *******************************************************************************
+\note  insertObjHash
+\date  Oct 2026
 
-	  if (use_threads) {
+\remarks
 
-	    if (++count_thread > n_threads_used)
-	      count_thread = 1;
-	    
-	    cspecs_data[count_thread][++n_cspecs_data[count_thread]] = cspecs;
+       adds the object in the given slot to the name hash table. The table
+       is kept at most half full, including deleted entries.
 
-	  } else {
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     slot       : slot of the object in the object store
+
+ ******************************************************************************/
+static void
+insertObjHash(int slot)
+{
+  int i;
+  int mask;
+  int size;
+
+  if (2*(ostore.n_used+ostore.n_hash_deleted) >= ostore.hash_size) {
+    size = 2*OBJ_BLOCK_SIZE;
+    while (size < 4*ostore.n_used)
+      size *= 2;
+    resizeObjHash(size);
+  }
+
+  mask = ostore.hash_size-1;
+  for (i = hashObjName(OBJ_SLOT_PTR(slot)->name) & mask; ostore.hash[i] >= 0; i = (i+1) & mask)
+    ;
+
+  if (ostore.hash[i] == OBJ_HASH_DELETED)
+    --ostore.n_hash_deleted;
+  ostore.hash[i] = slot;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  removeObjHash
+\date  Oct 2026
+
+\remarks
+
+       removes the object in the given slot from the name hash table
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     slot       : slot of the object in the object store
+
+ ******************************************************************************/
+static void
+removeObjHash(int slot)
+{
+  int i;
+  int mask;
+
+  mask = ostore.hash_size-1;
+  for (i = hashObjName(OBJ_SLOT_PTR(slot)->name) & mask; ostore.hash[i] != OBJ_HASH_EMPTY; i = (i+1) & mask) {
+    if (ostore.hash[i] == slot) {
+      ostore.hash[i] = OBJ_HASH_DELETED;
+      ++ostore.n_hash_deleted;
+      return;
+    }
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  resizeObjHash
+\date  Oct 2026
+
+\remarks
+
+       rebuilds the name hash table with a new size, which drops all
+       deleted entries
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     size       : new size of the hash table (power of 2)
+
+ ******************************************************************************/
+static void
+resizeObjHash(int size)
+{
+  int  i,j;
+  int  mask;
+  int *old_hash = ostore.hash;
+  int  old_size = ostore.hash_size;
+
+  ostore.hash = my_calloc(size,sizeof(int),MY_STOP);
+  for (i=0; i<size; ++i)
+    ostore.hash[i] = OBJ_HASH_EMPTY;
+  ostore.hash_size      = size;
+  ostore.n_hash_deleted = 0;
+
+  mask = size-1;
+  for (j=0; j<old_size; ++j) {
+    if (old_hash[j] < 0)
+      continue;
+    for (i = hashObjName(OBJ_SLOT_PTR(old_hash[j])->name) & mask; ostore.hash[i] >= 0; i = (i+1) & mask)
+      ;
+    ostore.hash[i] = old_hash[j];
+  }
+
+  if (old_hash != NULL)
+    free(old_hash);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  allocObject
+\date  Oct 2026
+
+\remarks
+
+       returns a zeroed object from the object store with a valid handle.
+       The store grows by one block if all slots are used. The object is
+       neither in the name hash table nor in the objs list yet.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+       none
+
+ ******************************************************************************/
+static ObjectPtr
+allocObject(void)
+{
+  int        i;
+  int        slot;
+  ObjectPtr  ptr;
+  ObjectPtr *blocks;
+  int       *gen, *used, *free_slots;
+
+  if (ostore.n_free == 0) {
+
+    if (ostore.n_slots+OBJ_BLOCK_SIZE > OBJ_HANDLE_SLOTS) {
+      printf("Object store is full (max. %d objects)\n",OBJ_HANDLE_SLOTS);
+      return NULL;
+    }
+
+    blocks     = my_calloc(ostore.n_blocks+1,sizeof(ObjectPtr),MY_STOP);
+    gen        = my_calloc(ostore.n_slots+OBJ_BLOCK_SIZE,sizeof(int),MY_STOP);
+    used       = my_calloc(ostore.n_slots+OBJ_BLOCK_SIZE,sizeof(int),MY_STOP);
+    free_slots = my_calloc(ostore.n_slots+OBJ_BLOCK_SIZE,sizeof(int),MY_STOP);
+
+    if (ostore.n_blocks > 0) {
+      memcpy(blocks,ostore.blocks,ostore.n_blocks*sizeof(ObjectPtr));
+      memcpy(gen,ostore.gen,ostore.n_slots*sizeof(int));
+      memcpy(used,ostore.used,ostore.n_slots*sizeof(int));
+      free(ostore.blocks);
+      free(ostore.gen);
+      free(ostore.used);
+      free(ostore.free_slots);
+    }
+
+    blocks[ostore.n_blocks] = my_calloc(OBJ_BLOCK_SIZE,sizeof(Object),MY_STOP);
+
+    ostore.blocks     = blocks;
+    ostore.gen        = gen;
+    ostore.used       = used;
+    ostore.free_slots = free_slots;
+    ++ostore.n_blocks;
+
+    // lower slots are used first
+    for (i=OBJ_BLOCK_SIZE-1; i>=0; --i)
+      ostore.free_slots[ostore.n_free++] = ostore.n_slots+i;
+    ostore.n_slots += OBJ_BLOCK_SIZE;
+
+  }
+
+  slot = ostore.free_slots[--ostore.n_free];
+  ostore.used[slot] = TRUE;
+  ++ostore.n_used;
+
+  ptr = OBJ_SLOT_PTR(slot);
+  bzero((void *)ptr,sizeof(Object));
+  ptr->handle = slot + OBJ_HANDLE_SLOTS*ostore.gen[slot];
+
+  return ptr;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  releaseObject
+\date  Oct 2026
+
+\remarks
+
+       removes an object from the objs list and the name hash table, and
+       returns its slot to the object store. All handles of the object
+       become invalid.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ptr        : pointer to the object
+
+ ******************************************************************************/
+static void
+releaseObject(ObjectPtr ptr)
+{
+  int slot = ptr->handle % OBJ_HANDLE_SLOTS;
+
+  if (ptr->pptr == NULL)
+    objs = (ObjectPtr) ptr->nptr;
+  else
+    ((ObjectPtr) ptr->pptr)->nptr = ptr->nptr;
+
+  if (ptr->nptr == NULL)
+    objs_last = (ObjectPtr) ptr->pptr;
+  else
+    ((ObjectPtr) ptr->nptr)->pptr = ptr->pptr;
+
+  removeObjHash(slot);
+
+  freeMesh(ptr->mesh);
+  ptr->mesh = NULL;
+
+  ostore.gen[slot] = (ostore.gen[slot]+1) % (INT_MAX/OBJ_HANDLE_SLOTS);
+  ostore.used[slot] = FALSE;
+  ostore.free_slots[ostore.n_free++] = slot;
+  --ostore.n_used;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkContacts
+\date  June 1999
+   
+\remarks 
+
+      checks for contacts and computes the contact forces
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+     none
+
+ ******************************************************************************/
+void
+checkContacts(void)
+
+{
+  int       i,j,k;
+  int       p,h;
+  int       nc,nh;
+  ObjectPtr optr;
+  double    x[N_CART+1];
+
+
+  /* zero contact forces */
+  bzero((void *)ucontact,sizeof(SL_uext)*(n_dofs+1));
+  
+  /* if there are no objects, exit */
+  if (objs==NULL)
+    return;
+  
+  // zero all object forces and torques
+  optr = objs;
+  do { 
+    for (i=1; i<=N_CART; ++i)
+      optr->f[i] = optr->t[i] = 0.0;
+    optr = (ObjectPtr) optr->nptr;
+  } while (optr != NULL);
+
+  // zero thread counters
+  n_cspecs_data = 0;
+
+  // the broad phase only needs to be rebuilt if objects changed, which also
+  // invalidates all distance bounds of the contact culling
+  if (bp_update_flag) {
+    buildBroadPhase();
+    for (i=0; i<=n_contacts; ++i) {
+      ccull[i].dist  = 0.0;
+      ccull[i].retry = 0;
+    }
+  }
+
+  // the velocities of all links, needed for the contact velocities
+  computeLinkVelocities(link_pos_sim, joint_origin_pos_sim, joint_axis_pos_sim, 
+			joint_sim_state, link_omega_sim, link_vel_sim);
+
+  // compute all active contact points and sort them into the grid
+  updateContactPointBuffer();
+
+  // the contact queries of streamed terrains do not read tiles from disk
+  loadContactPointTerrainTiles();
+
+  // check all objects in the order of the object list, such that a contact
+  // point is in contact with the first object that contains it
+  for (k=0; k<bp.n_objs; ++k) {
+
+    optr = bp.optrs[k];
+      
+    /* check whether this is a contact */
+    if (optr->contact_model == NO_CONTACT || optr->hide)
+      continue;
+
+    // the contact points without contact so far that are close to the object
+    nc = getCandidatePoints(k);
+    if (nc == 0)
+      continue;
+
+    // rotate the candidates into object centered coordinates and check 
+    // which are inside the object -- meshes are bounded, but have no kernel
+    if (optr->radius >= 0 && optr->type != MESH) {
+
+      nh = containmentKernel(optr, nc, cpb.cx, cpb.cy, cpb.cz, cpb.hits);
+
+    } else {
+
+      nh = 0;
+      for (p=0; p<nc; ++p) {
+	x[_X_] = cpb.cx[p];
+	x[_Y_] = cpb.cy[p];
+	x[_Z_] = cpb.cz[p];
+	convertGlobal2Object(optr, x, x);
+	cpb.cx[p] = x[_X_];
+	cpb.cy[p] = x[_Y_];
+	cpb.cz[p] = x[_Z_];
+	if (checkInsideObject(optr, x))
+	  cpb.hits[nh++] = p;
+      }
+
+    }
+
+    for (h=0; h<nh; ++h) {
+
+      p = cpb.hits[h];
+      cpb.obj[cpb.cand[p]] = k; /* only one object can be in contact with a contact point */
+
+      x[_X_] = cpb.cx[p];
+      x[_Y_] = cpb.cy[p];
+      x[_Z_] = cpb.cz[p];
+      dispatchContactSpecs(cpb.id[cpb.cand[p]], optr, x);
+
+    }
+
+  }
+
+  for (p=0; p<cpb.n; ++p) {
+
+    if (cpb.obj[p] >= 0)
+      continue;
+
+    // this is just for easy data interpretation
+    i = cpb.id[p];
+    for (j=1; j<=N_CART; ++j) {
+      contacts[i].normal[j] = 0.0;
+      contacts[i].normvel[j] = 0.0;
+      contacts[i].tangent[j] = 0.0;
+      contacts[i].tanvel[j] = 0.0;
+      contacts[i].viscvel[j] = 0.0;
+      contacts[i].f[j] = 0.0;
+      contacts[i].n[j] = 0.0;
+      contacts[i].status = FALSE;
+    }
+
+  }
+
+  // record the distance bounds of the points without contact
+  if (cull_contacts)
+    for (p=0; p<cpb.n; ++p)
+      recordContactCull(p);
+
+  // the chunks that contribute forces: chunks with contact specs in this step
+  // are already marked, and contact points can still have a contact status 
+  // if they were deactivated
+  for (i=0; i<=n_contacts; ++i)
+    if (contacts[i].status)
+      chunk_used[i/CONTACT_CHUNK_SIZE] = TRUE;
+
+  n_active_chunks = 0;
+  for (i=0; i<n_contact_chunks; ++i) {
+    if (chunk_used[i]) {
+      active_chunks[n_active_chunks++] = i;
+      chunk_used[i] = FALSE;
+    }
+  }
+
+  // process the remaining contact specs and accumulate the forces per chunk
+  if (cspecs_pool_active && n_cspecs_data >= MIN_CSPECS_THREADED) {
+    runContactThreadPool();
+  } else {
+    for (i=0; i<n_active_chunks; ++i)
+      processContactChunk(active_chunks[i]);
+  }
+
+  // accumulate forces in global structures
+  reduceContactChunks();
+
+  /* add simulated external forces to contact forces */
+  
+  for (i=0; i<=n_dofs; ++i)
+    for (j=_X_; j<=_Z_; ++j) {
+      ucontact[i].f[j] += uext_sim[i].f[j];
+      ucontact[i].t[j] += uext_sim[i].t[j];
+    }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkInsideObject
+\date  Oct 2026
+   
+\remarks 
+
+ checks whether a point in object centered coordinates is inside an object
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     optr : pointer to object
+ \param[in]     x    : point in object centered coordinates
+
+ returns TRUE if the point is inside, and FALSE otherwise
+
+ ******************************************************************************/
+static int
+checkInsideObject(ObjectPtr optr, double *x)
+{
+  double z;
+  double n[N_CART+1];
+  double no_go;
+
+  switch (optr->type) {
+
+  case CUBE: //---------------------------------------------------------------
+    return (fabs(x[1]) < optr->scale[1]/2. &&
+	    fabs(x[2]) < optr->scale[2]/2. &&
+	    fabs(x[3]) < optr->scale[3]/2.);
+    
+  case SPHERE: //---------------------------------------------------------------
+    return ((sqr(x[1]/optr->scale[1]*2.) + sqr(x[2]/optr->scale[2]*2.) + 
+	     sqr(x[3]/optr->scale[3]*2.)) < 1.0);
+    
+  case CYLINDER: //---------------------------------------------------------------
+    // the cylinder axis is aligned with the Z axis
+    return ((sqr(x[1]/optr->scale[1]*2.) + sqr(x[2]/optr->scale[2]*2.)) < 1.0 &&
+	    fabs(x[3]) < optr->scale[3]/2.);
+
+  case TERRAIN: //---------------------------------------------------------------
+    if (!getContactTerrainInfoByHandle(optr->terrain, x[1], x[2], &z, n, &no_go))
+      return FALSE;
+    return (x[3] < z);
+
+  case MESH: //---------------------------------------------------------------
+    if (optr->mesh == NULL)
+      return FALSE;
+    return checkInsideMesh(optr->mesh, x);
+
+  }
+
+  return FALSE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  buildBroadPhase
+\date  Oct 2026
+   
+\remarks 
+
+ builds the uniform grid for the broad phase of contact checking. Every object
+ with finite extent is bounded by its bounding sphere, and the range of grid
+ cells that overlap the bounding box of this sphere is stored. The cell size
+ is the average diameter of all bounding spheres, enlarged if needed to limit
+ the number of cells. This only needs to be called when objects were added,
+ deleted, or moved.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ none
+
+ ******************************************************************************/
+static void
+buildBroadPhase(void)
+{
+  int       j,k;
+  int       n_bounded=0;
+  double    xmax[N_CART+1];
+  double    mean_diameter=0.0;
+  ObjectPtr optr;
+
+  // free the previous data
+  if (bp.optrs != NULL) {
+    free(bp.optrs);
+    free(bp.lo);
+    free(bp.hi);
+    free(bp.cell_start);
+  }
+  bp.optrs      = NULL;
+  bp.cell_start = NULL;
+  bp.n_objs     = 0;
+  bp.n_cells    = 0;
+  for (j=1; j<=N_CART; ++j)
+    bp.n[j] = 0;
+  bp_update_flag = FALSE;
+
+  // count the objects
+  for (optr = objs; optr != NULL; optr = (ObjectPtr) optr->nptr)
+    ++bp.n_objs;
+
+  bp.optrs = my_calloc(bp.n_objs+1,sizeof(ObjectPtr),MY_STOP);
+  bp.lo    = my_calloc((bp.n_objs+1)*(N_CART+1),sizeof(int),MY_STOP);
+  bp.hi    = my_calloc((bp.n_objs+1)*(N_CART+1),sizeof(int),MY_STOP);
+
+  // overall extent of all objects
+  for (j=1; j<=N_CART; ++j) {
+    bp.xmin[j] =  1.e10;
+    xmax[j]    = -1.e10;
+  }
+
+  for (optr = objs, k=0; optr != NULL; optr = (ObjectPtr) optr->nptr, ++k) {
+
+    bp.optrs[k] = optr;
+
+    if (optr->radius >= 0) {
+      for (j=1; j<=N_CART; ++j) {
+	if (optr->trans[j]-optr->radius < bp.xmin[j])
+	  bp.xmin[j] = optr->trans[j]-optr->radius;
+	if (optr->trans[j]+optr->radius > xmax[j])
+	  xmax[j] = optr->trans[j]+optr->radius;
+      }
+      mean_diameter += 2.*optr->radius;
+      ++n_bounded;
+    }
+
+  }
+
+  // the grid
+  if (n_bounded > 0) {
+
+    bp.cell_size = mean_diameter/(double)n_bounded;
+    if (bp.cell_size <= 0)
+      bp.cell_size = 1.0;
+
+    do {
+      bp.n_cells = 1;
+      for (j=1; j<=N_CART; ++j) {
+	bp.n[j] = (int)((xmax[j]-bp.xmin[j])/bp.cell_size) + 1;
+	bp.n_cells *= bp.n[j];
+      }
+      if (bp.n_cells > MAX_BROAD_PHASE_CELLS)
+	bp.cell_size *= 2.0;
+    } while (bp.n_cells > MAX_BROAD_PHASE_CELLS);
+
+  }
+
+  bp.cell_start = my_calloc(bp.n_cells+2,sizeof(int),MY_STOP);
+
+  // the range of cells of each object
+  for (k=0; k<bp.n_objs; ++k) {
+
+    if (bp.optrs[k]->radius < 0)
+      continue;
+
+    for (j=1; j<=N_CART; ++j) {
+      bp.lo[k*(N_CART+1)+j] = 
+	(int)floor((bp.optrs[k]->trans[j]-bp.optrs[k]->radius-bp.xmin[j])/bp.cell_size);
+      bp.hi[k*(N_CART+1)+j] = 
+	(int)floor((bp.optrs[k]->trans[j]+bp.optrs[k]->radius-bp.xmin[j])/bp.cell_size);
+      if (bp.lo[k*(N_CART+1)+j] < 0)
+	bp.lo[k*(N_CART+1)+j] = 0;
+      if (bp.hi[k*(N_CART+1)+j] > bp.n[j]-1)
+	bp.hi[k*(N_CART+1)+j] = bp.n[j]-1;
+    }
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getBroadPhaseCell
+\date  Oct 2026
+   
+\remarks 
+
+ returns the index of the broad phase grid cell of a point in world 
+ coordinates, or -1 if the point is outside of the grid
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     x : point in world coordinates
+
+ ******************************************************************************/
+static int
+getBroadPhaseCell(double *x)
+{
+  int j;
+  int ind[N_CART+1];
+
+  if (bp.n_cells == 0)
+    return -1;
+
+  for (j=1; j<=N_CART; ++j) {
+    ind[j] = (int)floor((x[j]-bp.xmin[j])/bp.cell_size);
+    if (ind[j] < 0 || ind[j] >= bp.n[j])
+      return -1;
+  }
+
+  return (ind[_X_]*bp.n[_Y_] + ind[_Y_])*bp.n[_Z_] + ind[_Z_];
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  updateContactPointBuffer
+\date  Oct 2026
+
+\remarks
+
+ computes all active contact points in world coordinates, stores them in the
+ structure-of-arrays contact point buffer, and sorts them into the cells of
+ the broad phase grid. This assumes that link_pos_sim and Alink_sim are up
+ to date.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ none
+
+ ******************************************************************************/
+static void
+updateContactPointBuffer(void)
+{
+  int    i,p;
+  double x[N_CART+1];
+
+  cpb.n = 0;
+
+  for (i=0; i<=n_contacts; ++i) { /* loop over all contact points */
+
+    if (!contacts[i].active) {
+      ccull[i].dist = 0.0;
+      continue;
+    }
+
+    computeContactPoint(&(contacts[i]),link_pos_sim,Alink_sim,x);
+
+    // skip the point if it cannot have reached an object yet
+    if (ccull[i].dist > 0 &&
+	sqr(x[_X_]-ccull[i].x[_X_])+sqr(x[_Y_]-ccull[i].x[_Y_])+
+	sqr(x[_Z_]-ccull[i].x[_Z_]) < sqr(ccull[i].dist)) {
+      continue;
+    }
+    ccull[i].dist = 0.0;
+
+    cpb.id[cpb.n]   = i;
+    cpb.x[cpb.n]    = x[_X_];
+    cpb.y[cpb.n]    = x[_Y_];
+    cpb.z[cpb.n]    = x[_Z_];
+    cpb.cell[cpb.n] = getBroadPhaseCell(x);
+    cpb.obj[cpb.n]  = -1;
+    ++cpb.n;
+
+  }
+
+  if (bp.n_cells == 0)
+    return;
+
+  // sort the points into the grid cells: count the points per cell, convert
+  // the counts to start indices, and fill the cells
+  for (i=0; i<=bp.n_cells+1; ++i)
+    bp.cell_start[i] = 0;
+
+  for (p=0; p<cpb.n; ++p)
+    if (cpb.cell[p] >= 0)
+      ++bp.cell_start[cpb.cell[p]+1];
+
+  for (i=1; i<=bp.n_cells; ++i)
+    bp.cell_start[i] += bp.cell_start[i-1];
+  for (i=bp.n_cells; i>0; --i)
+    bp.cell_start[i] = bp.cell_start[i-1];
+  bp.cell_start[0] = 0;
+
+  for (p=0; p<cpb.n; ++p)
+    if (cpb.cell[p] >= 0)
+      bp.cell_pts[bp.cell_start[cpb.cell[p]+1]++] = p;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  loadContactPointTerrainTiles
+\date  Oct 2026
+
+\remarks
+
+ loads the tiles of streamed terrain boards around the bounding box of the 
+ points in the contact point buffer, before these points are checked, as the
+ contact queries of streamed boards only use tiles that are already loaded
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ none
+
+ ******************************************************************************/
+static void
+loadContactPointTerrainTiles(void)
+{
+  int       i,j,k,p;
+  double    x_min[N_CART+1],x_max[N_CART+1];
+  double    l_min[N_CART+1],l_max[N_CART+1];
+  double    x[N_CART+1];
+  ObjectPtr optr;
+
+  if (cpb.n == 0)
+    return;
+
+  for (j=1; j<=N_CART; ++j) {
+    x_min[j] =  1.e10;
+    x_max[j] = -1.e10;
+  }
+  for (p=0; p<cpb.n; ++p) {
+    x[_X_] = cpb.x[p];
+    x[_Y_] = cpb.y[p];
+    x[_Z_] = cpb.z[p];
+    for (j=1; j<=N_CART; ++j) {
+      if (x[j] < x_min[j])
+	x_min[j] = x[j];
+      if (x[j] > x_max[j])
+	x_max[j] = x[j];
+    }
+  }
+
+  for (k=0; k<bp.n_objs; ++k) {
+
+    optr = bp.optrs[k];
+    if (optr->type != TERRAIN || optr->contact_model == NO_CONTACT || optr->hide)
+      continue;
+
+    // the bounding box of the corners of the box in object coordinates
+    for (i=0; i<8; ++i) {
+      x[_X_] = (i & 1) ? x_max[_X_] : x_min[_X_];
+      x[_Y_] = (i & 2) ? x_max[_Y_] : x_min[_Y_];
+      x[_Z_] = (i & 4) ? x_max[_Z_] : x_min[_Z_];
+      convertGlobal2Object(optr, x, x);
+      for (j=1; j<=N_CART; ++j) {
+	if (i == 0 || x[j] < l_min[j])
+	  l_min[j] = x[j];
+	if (i == 0 || x[j] > l_max[j])
+	  l_max[j] = x[j];
+      }
+    }
+
+    loadContactTerrainTiles(optr->terrain, l_min[_X_], l_max[_X_], 
+			    l_min[_Y_], l_max[_Y_]);
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getCandidatePoints
+\date  Oct 2026
+
+\remarks
+
+ collects all contact points that may be in contact with an object, i.e.,
+ points without contact so far that lie in the grid cells of the object. For
+ objects without finite extent, all points without contact are candidates.
+ The candidate positions relative to the object are stored in cpb.cx, cpb.cy,
+ and cpb.cz, and their indices in the contact point buffer in cpb.cand.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     k : index of the object in the broad phase
+
+ returns the number of candidates
+
+ ******************************************************************************/
+static int
+getCandidatePoints(int k)
+{
+  int       p,c,nc=0;
+  int       ix,iy,iz;
+  int       n_obj_cells;
+  int      *lo = &(bp.lo[k*(N_CART+1)]);
+  int      *hi = &(bp.hi[k*(N_CART+1)]);
+  ObjectPtr optr = bp.optrs[k];
+
+#define ADD_CANDIDATE(p)			\
+  if (cpb.obj[p] < 0) {				\
+    cpb.cand[nc] = p;				\
+    cpb.cx[nc] = cpb.x[p] - optr->trans[_X_];	\
+    cpb.cy[nc] = cpb.y[p] - optr->trans[_Y_];	\
+    cpb.cz[nc] = cpb.z[p] - optr->trans[_Z_];	\
+    ++nc;					\
+  }
+
+  if (optr->radius < 0) {
+
+    for (p=0; p<cpb.n; ++p) {
+      ADD_CANDIDATE(p);
+    }
+
+  } else {
+
+    n_obj_cells = (hi[_X_]-lo[_X_]+1)*(hi[_Y_]-lo[_Y_]+1)*(hi[_Z_]-lo[_Z_]+1);
+
+    if (n_obj_cells > cpb.n) { // large objects: check the cell of every point
+
+      for (p=0; p<cpb.n; ++p) {
+	if ((c = cpb.cell[p]) < 0)
+	  continue;
+	iz = c%bp.n[_Z_];
+	iy = (c/bp.n[_Z_])%bp.n[_Y_];
+	ix = c/(bp.n[_Z_]*bp.n[_Y_]);
+	if (ix >= lo[_X_] && ix <= hi[_X_] && iy >= lo[_Y_] && iy <= hi[_Y_] &&
+	    iz >= lo[_Z_] && iz <= hi[_Z_]) {
+	  ADD_CANDIDATE(p);
+	}
+      }
 
-	    checkContactSpecifics(cspecs);
+    } else { // small objects: visit the cells of the object
 
+      for (ix=lo[_X_]; ix<=hi[_X_]; ++ix)
+	for (iy=lo[_Y_]; iy<=hi[_Y_]; ++iy)
+	  for (iz=lo[_Z_]; iz<=hi[_Z_]; ++iz) {
+	    c = (ix*bp.n[_Y_] + iy)*bp.n[_Z_] + iz;
+	    for (p=bp.cell_start[c]; p<bp.cell_start[c+1]; ++p) {
+	      ADD_CANDIDATE(bp.cell_pts[p]);
+	    }
 	  }
 
-	  contact_flag = TRUE;
-	  
-	  optr=NULL;
-	  continue; /* only one object can be in contact with a contact point */
+    }
 
-	} 
+  }
 
-	break;
+#undef ADD_CANDIDATE
 
-	
-      case TERRAIN: //---------------------------------------------------------------
-	if (!getContactTerrainInfo(x[1], x[2], optr->name, &z, n, &no_go))
-	  break;
+  return nc;
 
-	if (x[3] < z) {
+}
 
-	  cspecs.i = i;
-	  cspecs.optr = optr;
-	  for (j=1; j<=N_CART; ++j)
-	    cspecs.x[j] = x[j];
+/*!*****************************************************************************
+ *******************************************************************************
+\note  containmentKernel
+\date  Oct 2026
 
-	  if (use_threads) {
+\remarks
 
-	    if (++count_thread > n_threads_used)
-	      count_thread = 1;
-	    
-	    cspecs_data[count_thread][++n_cspecs_data[count_thread]] = cspecs;
+ rotates n points relative to an object into object centered coordinates and
+ checks which points are inside the object. This works for cubes, spheres,
+ and cylinders. If the compiler targets AVX-512 or AVX2, 8 or 4 points are
+ processed at a time, and the remaining points are processed with the scalar
+ code of convertGlobal2Object() and checkInsideObject(). All code paths use
+ the same arithmetic, such that the results are identical if the compiler 
+ does not contract multiplies and adds into FMA instructions. Thus, this file
+ is compiled with -ffp-contract=off for SL_NATIVE_ARCH.
 
-	  } else {
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-	    checkContactSpecifics(cspecs);
+ \param[in]     optr : pointer to object
+ \param[in]     n    : number of points
+ \param[in,out] x    : x coordinates relative to object -> object coordinates
+ \param[in,out] y    : y coordinates relative to object -> object coordinates
+ \param[in,out] z    : z coordinates relative to object -> object coordinates
+ \param[out]    hits : indices of the points inside the object
 
-	  }
+ returns the number of points inside the object
 
-	  contact_flag = TRUE;
-	
-	  optr = NULL;
-	  continue; /* only one object can be in contact with a contact point */
+ ******************************************************************************/
+static int
+containmentKernel(ObjectPtr optr, int n, double *x, double *y, double *z, int *hits)
+{
+  int    k=0;
+  int    nh=0;
+  double xl[N_CART+1];
+
+#if defined(__AVX512F__)
+  {
+    unsigned int m;
+    __m512d px,py,pz,lx,ly,lz,a,b,c;
+    __m512d r11 = _mm512_set1_pd(optr->R[1][1]);
+    __m512d r12 = _mm512_set1_pd(optr->R[1][2]);
+    __m512d r13 = _mm512_set1_pd(optr->R[1][3]);
+    __m512d r21 = _mm512_set1_pd(optr->R[2][1]);
+    __m512d r22 = _mm512_set1_pd(optr->R[2][2]);
+    __m512d r23 = _mm512_set1_pd(optr->R[2][3]);
+    __m512d r31 = _mm512_set1_pd(optr->R[3][1]);
+    __m512d r32 = _mm512_set1_pd(optr->R[3][2]);
+    __m512d r33 = _mm512_set1_pd(optr->R[3][3]);
+    __m512d sx  = _mm512_set1_pd(optr->scale[_X_]);
+    __m512d sy  = _mm512_set1_pd(optr->scale[_Y_]);
+    __m512d sz  = _mm512_set1_pd(optr->scale[_Z_]);
+    __m512d hx  = _mm512_set1_pd(optr->scale[_X_]/2.);
+    __m512d hy  = _mm512_set1_pd(optr->scale[_Y_]/2.);
+    __m512d hz  = _mm512_set1_pd(optr->scale[_Z_]/2.);
+    __m512d one = _mm512_set1_pd(1.0);
+    __m512d two = _mm512_set1_pd(2.0);
+
+    for (k=0; k+8<=n; k+=8) {
+
+      px = _mm512_loadu_pd(x+k);
+      py = _mm512_loadu_pd(y+k);
+      pz = _mm512_loadu_pd(z+k);
+
+      lx = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(r11,px),_mm512_mul_pd(r12,py)),
+			 _mm512_mul_pd(r13,pz));
+      ly = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(r21,px),_mm512_mul_pd(r22,py)),
+			 _mm512_mul_pd(r23,pz));
+      lz = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(r31,px),_mm512_mul_pd(r32,py)),
+			 _mm512_mul_pd(r33,pz));
+
+      _mm512_storeu_pd(x+k,lx);
+      _mm512_storeu_pd(y+k,ly);
+      _mm512_storeu_pd(z+k,lz);
 
-	}
+      switch (optr->type) {
+      case CUBE:
+	m = _mm512_cmp_pd_mask(_mm512_abs_pd(lx),hx,_CMP_LT_OQ) &
+	    _mm512_cmp_pd_mask(_mm512_abs_pd(ly),hy,_CMP_LT_OQ) &
+	    _mm512_cmp_pd_mask(_mm512_abs_pd(lz),hz,_CMP_LT_OQ);
+	break;
 
+      case SPHERE:
+	a = _mm512_mul_pd(_mm512_div_pd(lx,sx),two);
+	b = _mm512_mul_pd(_mm512_div_pd(ly,sy),two);
+	c = _mm512_mul_pd(_mm512_div_pd(lz,sz),two);
+	a = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(a,a),_mm512_mul_pd(b,b)),
+			  _mm512_mul_pd(c,c));
+	m = _mm512_cmp_pd_mask(a,one,_CMP_LT_OQ);
 	break;
 
-      }
+      case CYLINDER:
+	a = _mm512_mul_pd(_mm512_div_pd(lx,sx),two);
+	b = _mm512_mul_pd(_mm512_div_pd(ly,sy),two);
+	a = _mm512_add_pd(_mm512_mul_pd(a,a),_mm512_mul_pd(b,b));
+	m = _mm512_cmp_pd_mask(a,one,_CMP_LT_OQ) &
+	    _mm512_cmp_pd_mask(_mm512_abs_pd(lz),hz,_CMP_LT_OQ);
+	break;
 
-      optr = (ObjectPtr) optr->nptr;
+      default:
+	m = 0;
 
-    } while (optr != NULL);
+      }
 
-    if (!contact_flag) { // this is just for easy data interpretation
-      for (j=1; j<=N_CART; ++j) {
-	contacts[i].normal[j] = 0.0;
-	contacts[i].normvel[j] = 0.0;
-	contacts[i].tangent[j] = 0.0;
-	contacts[i].tanvel[j] = 0.0;
-	contacts[i].viscvel[j] = 0.0;
-	contacts[i].f[j] = 0.0;
-	contacts[i].n[j] = 0.0;
-	contacts[i].status = FALSE;
+      while (m) {
+	hits[nh++] = k + __builtin_ctz(m);
+	m &= m-1;
       }
-    }
 
+    }
   }
+#elif defined(__AVX2__)
+  {
+    unsigned int m;
+    __m256d px,py,pz,lx,ly,lz,a,b,c;
+    __m256d r11 = _mm256_set1_pd(optr->R[1][1]);
+    __m256d r12 = _mm256_set1_pd(optr->R[1][2]);
+    __m256d r13 = _mm256_set1_pd(optr->R[1][3]);
+    __m256d r21 = _mm256_set1_pd(optr->R[2][1]);
+    __m256d r22 = _mm256_set1_pd(optr->R[2][2]);
+    __m256d r23 = _mm256_set1_pd(optr->R[2][3]);
+    __m256d r31 = _mm256_set1_pd(optr->R[3][1]);
+    __m256d r32 = _mm256_set1_pd(optr->R[3][2]);
+    __m256d r33 = _mm256_set1_pd(optr->R[3][3]);
+    __m256d sx  = _mm256_set1_pd(optr->scale[_X_]);
+    __m256d sy  = _mm256_set1_pd(optr->scale[_Y_]);
+    __m256d sz  = _mm256_set1_pd(optr->scale[_Z_]);
+    __m256d hx  = _mm256_set1_pd(optr->scale[_X_]/2.);
+    __m256d hy  = _mm256_set1_pd(optr->scale[_Y_]/2.);
+    __m256d hz  = _mm256_set1_pd(optr->scale[_Z_]/2.);
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d two = _mm256_set1_pd(2.0);
+    __m256d sgn = _mm256_set1_pd(-0.0);
+
+    for (k=0; k+4<=n; k+=4) {
+
+      px = _mm256_loadu_pd(x+k);
+      py = _mm256_loadu_pd(y+k);
+      pz = _mm256_loadu_pd(z+k);
+
+      lx = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r11,px),_mm256_mul_pd(r12,py)),
+			 _mm256_mul_pd(r13,pz));
+      ly = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r21,px),_mm256_mul_pd(r22,py)),
+			 _mm256_mul_pd(r23,pz));
+      lz = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r31,px),_mm256_mul_pd(r32,py)),
+			 _mm256_mul_pd(r33,pz));
+
+      _mm256_storeu_pd(x+k,lx);
+      _mm256_storeu_pd(y+k,ly);
+      _mm256_storeu_pd(z+k,lz);
 
-  if (use_threads) {
+      switch (optr->type) {
+      case CUBE:
+	a = _mm256_and_pd(_mm256_cmp_pd(_mm256_andnot_pd(sgn,lx),hx,_CMP_LT_OQ),
+			  _mm256_cmp_pd(_mm256_andnot_pd(sgn,ly),hy,_CMP_LT_OQ));
+	a = _mm256_and_pd(a,_mm256_cmp_pd(_mm256_andnot_pd(sgn,lz),hz,_CMP_LT_OQ));
+	m = _mm256_movemask_pd(a);
+	break;
 
-    // start all the threads
-    for (i=1; i<=n_threads_used; ++i) {
-      //printf("start thread %d with %d items\n",i,n_cspecs_data[i]);
-      if (n_cspecs_data[i] > 0)
-	sl_rt_cond_signal(&(cspecs_status[i]));
-    }
+      case SPHERE:
+	a = _mm256_mul_pd(_mm256_div_pd(lx,sx),two);
+	b = _mm256_mul_pd(_mm256_div_pd(ly,sy),two);
+	c = _mm256_mul_pd(_mm256_div_pd(lz,sz),two);
+	a = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a,a),_mm256_mul_pd(b,b)),
+			  _mm256_mul_pd(c,c));
+	m = _mm256_movemask_pd(_mm256_cmp_pd(a,one,_CMP_LT_OQ));
+	break;
 
-    // check for thread completion
-    threads_ready_flag = FALSE;
+      case CYLINDER:
+	a = _mm256_mul_pd(_mm256_div_pd(lx,sx),two);
+	b = _mm256_mul_pd(_mm256_div_pd(ly,sy),two);
+	a = _mm256_add_pd(_mm256_mul_pd(a,a),_mm256_mul_pd(b,b));
+	a = _mm256_and_pd(_mm256_cmp_pd(a,one,_CMP_LT_OQ),
+			  _mm256_cmp_pd(_mm256_andnot_pd(sgn,lz),hz,_CMP_LT_OQ));
+	m = _mm256_movemask_pd(a);
+	break;
 
-    while (!threads_ready_flag) {
+      default:
+	m = 0;
 
-      threads_ready_flag = TRUE;
+      }
 
-      for (i=1; i<=n_threads_used; ++i) {
-	sl_rt_mutex_lock(&(cspecs_mutex[i]));
-	if (n_cspecs_data[i] != 0)
-	  threads_ready_flag = FALSE;
-	sl_rt_mutex_unlock(&(cspecs_mutex[i]));
+      while (m) {
+	hits[nh++] = k + __builtin_ctz(m);
+	m &= m-1;
       }
 
     }
+  }
+#endif
+
+  // scalar code for the remaining points
+  for (; k<n; ++k) {
+
+    xl[_X_] = x[k];
+    xl[_Y_] = y[k];
+    xl[_Z_] = z[k];
+    convertGlobal2Object(optr, xl, xl);
+    x[k] = xl[_X_];
+    y[k] = xl[_Y_];
+    z[k] = xl[_Z_];
+
+    if (checkInsideObject(optr, xl))
+      hits[nh++] = k;
 
   }
 
-  // accumulate forces in global structures
+  return nh;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  dispatchContactSpecs
+\date  Oct 2026
+
+\remarks
+
+ hands a contact point that is inside an object to the contact thread pool,
+ or processes it right away if the pool is not used
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     cID  : ID of the contact point
+ \param[in]     optr : pointer to object in contact
+ \param[in]     x    : contact point in object centered coordinates
+
+ ******************************************************************************/
+static void
+dispatchContactSpecs(int cID, ObjectPtr optr, double *x)
+{
+  int          j;
+  ContactSpecs cspecs;
+
+  cspecs.i = cID;
+  cspecs.optr = optr;
+  for (j=1; j<=N_CART; ++j)
+    cspecs.x[j] = x[j];
+
+  chunk_used[cID/CONTACT_CHUNK_SIZE] = TRUE;
+
+  if (cspecs_pool_active) {
+
+    cspecs_data[++n_cspecs_data] = cspecs;
+    contact_spec[cID] = n_cspecs_data;
+
+  } else {
+
+    checkContactSpecifics(cspecs);
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkContactsImminent
+\date  Oct 2026
+   
+\remarks 
+
+ checks whether any contact point is currently in contact, or could come into
+ contact with an object within the time horizon dt. A contact point is
+ considered imminent if the lower bound of its distance to an object from
+ computeObjectDistance() is smaller than the distance margin plus the 
+ distance it can travel within dt at its current speed, accelerating with
+ IMMINENT_MAX_ACC. This is used by the simulation servo to decide whether
+ the integration needs to run at the fine rate. The function assumes that
+ link_pos_sim and Alink_sim are up to date.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     dt     : time horizon to look ahead
+ \param[in]     margin : safety distance margin
+
+ returns TRUE if contacts are active or imminent, and FALSE otherwise
+
+ ******************************************************************************/
+int
+checkContactsImminent(double dt, double margin)
+{
+  int       i,j;
+  ObjectPtr optr;
+  double    x[N_CART+1];
+  double    xl[N_CART+1];
+  double    v[N_CART+1];
+  double    dist;
+  double    speed;
+
+  // if there are no objects, nothing can be contacted
+  if (objs == NULL)
+    return FALSE;
+
+  // the velocities of all links, needed for the contact velocities
+  computeLinkVelocities(link_pos_sim, joint_origin_pos_sim, joint_axis_pos_sim, 
+			joint_sim_state, link_omega_sim, link_vel_sim);
+
   for (i=0; i<=n_contacts; ++i) { /* loop over all contact points */
-    if (!contacts[i].status)
+
+    if (!contacts[i].active)
       continue;
-    accumulateFinalForces(&(contacts[i]));
+
+    if (contacts[i].status)
+      return TRUE;
+
+    // the current contact point and its speed in world coordinates
+    computeContactPoint(&(contacts[i]),link_pos_sim,Alink_sim,x);
+    contactVelocityGlobal(i,v);
+    speed = sqrt(sqr(v[_X_])+sqr(v[_Y_])+sqr(v[_Z_]));
+
+    optr = objs;
+    do {
+
+      if (optr->contact_model != NO_CONTACT && !optr->hide) {
+
+	for (j=1; j<=N_CART; ++j)
+	  xl[j] = x[j] - optr->trans[j];
+	convertGlobal2Object(optr, xl, xl);
+
+	dist = computeObjectDistance(optr, xl);
+
+	if (dist < margin + speed*dt + 0.5*IMMINENT_MAX_ACC*sqr(dt))
+	  return TRUE;
+
+      }
+
+      optr = (ObjectPtr) optr->nptr;
+
+    } while (optr != NULL);
+
   }
 
-  /* add simulated external forces to contact forces */
-  
-  for (i=0; i<=n_dofs; ++i)
-    for (j=_X_; j<=_Z_; ++j) {
-      ucontact[i].f[j] += uext_sim[i].f[j];
-      ucontact[i].t[j] += uext_sim[i].t[j];
+  return FALSE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeObjectDistance
+\date  Oct 2026
+   
+\remarks 
+
+ computes a conservative lower bound of the distance of a point to the
+ surface of an object. For spheres and cylinders with unequal scaling, the
+ distance in the unit shape is scaled with the smallest semi-axis, which
+ never overestimates the true distance. For terrains, the clearance above
+ the highest point of the contact grid is returned, as the vertical 
+ clearance above the terrain below the point is no lower bound for a point
+ moving sideways over a slope or a step.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     optr : pointer to object
+ \param[in]     x    : point in object centered coordinates
+
+ returns the distance, which is negative or zero if the point is inside
+
+ ******************************************************************************/
+static double
+computeObjectDistance(ObjectPtr optr, double *x)
+{
+  int    j;
+  double aux, aux1;
+  double d[N_CART+1];
+  double z_max;
+  double n[N_CART+1];
+  double min_semi_axis;
+
+  switch (optr->type) {
+
+  case CUBE: //---------------------------------------------------------------
+    aux  = 0.0;
+    aux1 = -1.e10;
+    for (j=1; j<=N_CART; ++j) {
+      d[j] = fabs(x[j]) - optr->scale[j]/2.;
+      if (d[j] > 0)
+	aux += sqr(d[j]);
+      if (d[j] > aux1)
+	aux1 = d[j];
+    }
+    if (aux1 <= 0)
+      return aux1;
+    return sqrt(aux);
+
+  case SPHERE: //---------------------------------------------------------------
+    aux = 0.0;
+    min_semi_axis = optr->scale[_X_]/2.;
+    for (j=1; j<=N_CART; ++j) {
+      aux += sqr(x[j]/(optr->scale[j]/2.));
+      if (optr->scale[j]/2. < min_semi_axis)
+	min_semi_axis = optr->scale[j]/2.;
+    }
+    return (sqrt(aux)-1.0)*min_semi_axis;
+
+  case CYLINDER: //---------------------------------------------------------------
+    // the cylinder axis is aligned with the Z axis
+    aux = sqr(x[_X_]/(optr->scale[_X_]/2.)) + sqr(x[_Y_]/(optr->scale[_Y_]/2.));
+    min_semi_axis = optr->scale[_X_]/2.;
+    if (optr->scale[_Y_]/2. < min_semi_axis)
+      min_semi_axis = optr->scale[_Y_]/2.;
+    d[_X_] = (sqrt(aux)-1.0)*min_semi_axis;
+    d[_Z_] = fabs(x[_Z_]) - optr->scale[_Z_]/2.;
+    if (d[_X_] <= 0 && d[_Z_] <= 0)
+      return (d[_X_] > d[_Z_]) ? d[_X_] : d[_Z_];
+    aux = 0.0;
+    if (d[_X_] > 0)
+      aux += sqr(d[_X_]);
+    if (d[_Z_] > 0)
+      aux += sqr(d[_Z_]);
+    return sqrt(aux);
+
+  case TERRAIN: //---------------------------------------------------------------
+    if (!getContactTerrainMaxZByHandle(optr->terrain, &z_max))
+      return 1.e10;
+    return x[_Z_] - z_max;
+
+  case MESH: //---------------------------------------------------------------
+    if (optr->mesh == NULL)
+      return 1.e10;
+    aux = getClosestPointMesh(optr->mesh, x, d, n);
+    if (checkInsideMesh(optr->mesh, x))
+      return -aux;
+    return aux;
+
+  }
+
+  return 1.e10;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeObjectDistanceBound
+\date  Oct 2026
+   
+\remarks 
+
+ computes a lower bound of the distance of a point outside of an object to the 
+ object, as needed for contact culling. In contrast to computeObjectDistance(),
+ the distance to a mesh is not signed, and a terrain whose board is not found
+ gives no bound.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     optr : pointer to object
+ \param[in]     x    : point in object centered coordinates
+
+ returns the distance bound
+
+ ******************************************************************************/
+static double
+computeObjectDistanceBound(ObjectPtr optr, double *x)
+{
+  double z_max;
+  double c[N_CART+1];
+  double n[N_CART+1];
+
+  switch (optr->type) {
+
+  case TERRAIN: //---------------------------------------------------------------
+    if (!getContactTerrainMaxZByHandle(optr->terrain, &z_max))
+      return 0.0;
+    return x[_Z_] - z_max;
+
+  case MESH: //---------------------------------------------------------------
+    if (optr->mesh == NULL)
+      return 1.e10;
+    return getClosestPointMesh(optr->mesh, x, c, n);
+
+  }
+
+  return computeObjectDistance(optr, x);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  recordContactCull
+\date  Oct 2026
+   
+\remarks 
+
+ records the distance bound of a contact point in the contact point buffer to
+ all contact objects, if the point is not in contact. Points closer than 
+ CULL_MIN_DIST are not worth culling, and are only bounded again after
+ CULL_RETRY_STEPS steps.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     p : index of the point in the contact point buffer
+
+ ******************************************************************************/
+static void
+recordContactCull(int p)
+{
+  int       i,j,k;
+  double    d;
+  double    dmin = 1.e10;
+  double    x[N_CART+1];
+  double    xl[N_CART+1];
+  ObjectPtr optr;
+
+  i = cpb.id[p];
+  ccull[i].dist = 0.0;
+
+  if (cpb.obj[p] >= 0)
+    return;
+
+  if (ccull[i].retry > 0) {
+    --ccull[i].retry;
+    return;
+  }
+
+  x[_X_] = cpb.x[p];
+  x[_Y_] = cpb.y[p];
+  x[_Z_] = cpb.z[p];
+
+  for (k=0; k<bp.n_objs && dmin >= CULL_MIN_DIST; ++k) {
+
+    optr = bp.optrs[k];
+    if (optr->contact_model == NO_CONTACT || optr->hide)
+      continue;
+
+    // the bounding sphere gives a cheap bound first
+    if (optr->radius >= 0) {
+      d = sqrt(sqr(x[_X_]-optr->trans[_X_])+sqr(x[_Y_]-optr->trans[_Y_])+
+	       sqr(x[_Z_]-optr->trans[_Z_])) - optr->radius;
+      if (d >= dmin)
+	continue;
     }
 
+    for (j=1; j<=N_CART; ++j)
+      xl[j] = x[j] - optr->trans[j];
+    convertGlobal2Object(optr, xl, xl);
+
+    d = computeObjectDistanceBound(optr, xl);
+    if (d < dmin)
+      dmin = d;
+
+  }
+
+  if (dmin < CULL_MIN_DIST) {
+    ccull[i].retry = CULL_RETRY_STEPS;
+    return;
+  }
+
+  ccull[i].dist = dmin - CULL_EPS;
+  for (j=1; j<=N_CART; ++j)
+    ccull[i].x[j] = x[j];
+
 }
 
 /*!*****************************************************************************
@@ -982,38 +2490,103 @@ Euler angle notation x-y-z rotations
  \param[in]   xg  : vector in global coordinates
  \param[out]  xl  : vector in local coordinates
 
- note: xl and xg can be the same pointers
+ note: xl and xg can be the same pointers
+
+ ******************************************************************************/
+static void
+convertGlobal2Object(ObjectPtr optr, double *xg, double *xl)
+
+{
+  int    i;
+  double x[N_CART+1];
+
+  for (i=1; i<=N_CART; ++i)
+    x[i] = xg[i];
+
+  // the link point in object centered coordinates
+  for (i=1; i<=N_CART; ++i)
+    xl[i] = optr->R[i][_X_]*x[_X_] + optr->R[i][_Y_]*x[_Y_] + optr->R[i][_Z_]*x[_Z_];
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  updateObjectGeometry
+\date  Oct 2026
+   
+\remarks 
+
+computes the rotation matrices and the bounding radius of an object. The 
+rotation matrix is built from Euler angle notation x-y-z rotations, i.e., 
+the global coordinates are first rotated about x, then y, and then z. This
+needs to be called whenever the pose or the scale of the object changes, and
+it marks the broad phase of the contact checking for a rebuild.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out]   optr: point to object
 
  ******************************************************************************/
-static void
-convertGlobal2Object(ObjectPtr optr, double *xg, double *xl)
+void
+updateObjectGeometry(ObjectPtr optr)
 
 {
-  int    i;
+  int    i,j;
   double aux;
+  double xl[N_CART+1];
 
-  for (i=1; i<=N_CART; ++i)
-    xl[i] = xg[i];
+  // rotate the unit vectors to obtain the columns of the rotation matrix
+  for (j=1; j<=N_CART; ++j) {
+
+    for (i=1; i<=N_CART; ++i)
+      xl[i] = (i==j) ? 1.0 : 0.0;
+
+    if (optr->rot[_A_] != 0.0) {
+      aux   =  xl[2]*cos(optr->rot[_A_])+xl[3]*sin(optr->rot[_A_]);
+      xl[3] = -xl[2]*sin(optr->rot[_A_])+xl[3]*cos(optr->rot[_A_]);
+      xl[2] = aux;
+    }
+    
+    if (optr->rot[_B_] != 0.0) {
+      aux   =  xl[1]*cos(optr->rot[_B_])-xl[3]*sin(optr->rot[_B_]);
+      xl[3] =  xl[1]*sin(optr->rot[_B_])+xl[3]*cos(optr->rot[_B_]);
+      xl[1] = aux;
+    }
+    
+    if (optr->rot[_G_] != 0.0) {
+      aux   =  xl[1]*cos(optr->rot[_G_])+xl[2]*sin(optr->rot[_G_]);
+      xl[2] = -xl[1]*sin(optr->rot[_G_])+xl[2]*cos(optr->rot[_G_]);
+      xl[1] = aux;
+    }
+
+    for (i=1; i<=N_CART; ++i) {
+      optr->R[i][j]  = xl[i];
+      optr->RT[j][i] = xl[i];
+    }
 
-  // the link point in object centered coordinates
-  if (optr->rot[1] != 0.0) {
-    aux  =  xl[2]*cos(optr->rot[1])+xl[3]*sin(optr->rot[1]);
-    xl[3] = -xl[2]*sin(optr->rot[1])+xl[3]*cos(optr->rot[1]);
-    xl[2] = aux;
-  }
-  
-  if (optr->rot[2] != 0.0) {
-    aux  =  xl[1]*cos(optr->rot[2])-xl[3]*sin(optr->rot[2]);
-    xl[3] =  xl[1]*sin(optr->rot[2])+xl[3]*cos(optr->rot[2]);
-    xl[1] = aux;
   }
-  
-  if (optr->rot[3] != 0.0) {
-    aux  =  xl[1]*cos(optr->rot[3])+xl[2]*sin(optr->rot[3]);
-    xl[2] = -xl[1]*sin(optr->rot[3])+xl[2]*cos(optr->rot[3]);
-    xl[1] = aux;
+
+  // the bounding sphere
+  switch (optr->type) {
+  case CUBE:
+  case SPHERE:
+  case CYLINDER:
+    optr->radius = 0.5*sqrt(sqr(optr->scale[_X_])+sqr(optr->scale[_Y_])+
+			    sqr(optr->scale[_Z_]));
+    break;
+
+  case MESH:
+    optr->radius = (optr->mesh != NULL) ? optr->mesh->radius : -1.0;
+    break;
+
+  default:
+    optr->radius = -1.0;
+
   }
 
+  bp_update_flag = TRUE;
+
 }
 
 /*!*****************************************************************************
@@ -1233,7 +2806,7 @@ void
 readObjects(char *cfname) 
 
 {
-  int j, i, ID;
+  int j, i;
   FILE  *in;
   double dum;
   double rgb[N_CART+1];
@@ -1303,6 +2876,10 @@ readObjects(char *cfname)
       sprintf(name2,"%s.asc",name);
       strcpy(name,name2);
     }
+    if (objtype == MESH) { // meshes use .obj names
+      sprintf(name2,"%s.obj",name);
+      strcpy(name,name2);
+    }
     optr = addObject(name,objtype,contact,rgb,pos,rot,scale,cparms,oparms);
     
     /* if there is a floor, initialize the gound level for the terrains */
@@ -1314,17 +2891,14 @@ readObjects(char *cfname)
     
     // for terrains we need to add the terrain and create a display list for this terrain
     if (objtype == TERRAIN) {
-      if ((ID=getNextTerrainID())) { 
-	SL_quat q;
-	
-	eulerToQuat(rot,&q);
-	// Note: oparms[1] = reg_rad oparms[2]=reg_down oparms[3]=reg_crad oparms[4]=disp_grid_delta
-	setTerrainInfo(ID,ID,name,pos,q.q,
-		       (int)rint(oparms[1]),(int)rint(oparms[2]),(int)rint(oparms[3]));
-	
-      } else {
-	printf("No more terrains possible -- increase MAX_TERRAINS\n");
-      }
+      SL_quat q;
+
+      eulerToQuat(rot,&q);
+      // Note: oparms[1] = reg_rad oparms[2]=reg_down oparms[3]=reg_crad oparms[4]=disp_grid_delta
+      if (addTerrainBoard(name,pos,q.q,
+			  (int)rint(oparms[1]),(int)rint(oparms[2]),(int)rint(oparms[3])))
+	if (optr != NULL)
+	  optr->terrain = getContactTerrainHandle(name);
     }
     
   }
@@ -1359,6 +2933,8 @@ computeContactForces(ObjectPtr optr, ContactPtr cptr)
 {
   int i,j;
   double aux;
+  double f[N_CART+1];
+  double n[N_CART+1];
   double temp[N_CART+1];
   double temp1[N_CART+1];
   double temp2[N_CART+1];
@@ -1565,34 +3141,14 @@ computeContactForces(ObjectPtr optr, ContactPtr cptr)
     cptr->n[i] /= aux;
 
 
-  if (optr->rot[_G_] != 0.0) {
-    aux    =  cptr->f[_X_]*cos(optr->rot[_G_])-cptr->f[_Y_]*sin(optr->rot[_G_]);
-    cptr->f[_Y_] =  cptr->f[_X_]*sin(optr->rot[_G_])+cptr->f[_Y_]*cos(optr->rot[_G_]);
-    cptr->f[_X_] = aux;
-
-    aux          =  cptr->n[_X_]*cos(optr->rot[_G_])-cptr->n[_Y_]*sin(optr->rot[_G_]);
-    cptr->n[_Y_] =  cptr->n[_X_]*sin(optr->rot[_G_])+cptr->n[_Y_]*cos(optr->rot[_G_]);
-    cptr->n[_X_] = aux;
-  }
-
-  if (optr->rot[_B_] != 0.0) {
-    aux    =  cptr->f[_X_]*cos(optr->rot[_B_])+cptr->f[_Z_]*sin(optr->rot[_B_]);
-    cptr->f[_Z_] = -cptr->f[_X_]*sin(optr->rot[_B_])+cptr->f[_Z_]*cos(optr->rot[_B_]);
-    cptr->f[_X_] = aux;
-
-    aux    =  cptr->n[_X_]*cos(optr->rot[_B_])+cptr->n[_Z_]*sin(optr->rot[_B_]);
-    cptr->n[_Z_] = -cptr->n[_X_]*sin(optr->rot[_B_])+cptr->n[_Z_]*cos(optr->rot[_B_]);
-    cptr->n[_X_] = aux;
+  for (i=1; i<=N_CART; ++i) {
+    f[i] = cptr->f[i];
+    n[i] = cptr->n[i];
   }
-  
-  if (optr->rot[_A_] != 0.0) {
-    aux    =  cptr->f[_Y_]*cos(optr->rot[_A_])-cptr->f[_Z_]*sin(optr->rot[_A_]);
-    cptr->f[_Z_] =  cptr->f[_Y_]*sin(optr->rot[_A_])+cptr->f[_Z_]*cos(optr->rot[_A_]);
-    cptr->f[_Y_] = aux;
 
-    aux    =  cptr->n[_Y_]*cos(optr->rot[_A_])-cptr->n[_Z_]*sin(optr->rot[_A_]);
-    cptr->n[_Z_] =  cptr->n[_Y_]*sin(optr->rot[_A_])+cptr->n[_Z_]*cos(optr->rot[_A_]);
-    cptr->n[_Y_] = aux;
+  for (i=1; i<=N_CART; ++i) {
+    cptr->f[i] = optr->RT[i][_X_]*f[_X_] + optr->RT[i][_Y_]*f[_Y_] + optr->RT[i][_Z_]*f[_Z_];
+    cptr->n[i] = optr->RT[i][_X_]*n[_X_] + optr->RT[i][_Y_]*n[_Y_] + optr->RT[i][_Z_]*n[_Z_];
   }
 
 }
@@ -1616,62 +3172,63 @@ computes the velocity of a contact point in object coordinates
  ******************************************************************************/
 static void 
 contactVelocity(int cID, ObjectPtr optr, double *v)
+{
+
+  // get the velocity in world coordinates
+  contactVelocityGlobal(cID, v);
+
+  // convert the velocity to object coordinates
+  convertGlobal2Object(optr, v, v);
+
+}
+
+
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  contactVelocityGlobal
+\date  Oct 2026
+   
+\remarks 
+
+computes the velocity of a contact point in world coordinates. The link
+velocities need to be up-to-date, see computeLinkVelocities().
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     cID    : ID of contact point
+ \param[out]    v      : velocity vector
+
+ ******************************************************************************/
+static void 
+contactVelocityGlobal(int cID, double *v)
 {
   int    i;
-  double aux;
   double v_start[N_CART+1];
   double v_end[N_CART+1];
   double x[N_CART+1];
 
-  // get the velocity in world coordinates
   if (contacts[cID].point_contact_flag) {
 
     computeContactPoint(&(contacts[cID]),link_pos_sim,Alink_sim,x);
 
-    computeLinkVelocityPoint(contacts[cID].id_start, x, link_pos_sim, joint_origin_pos_sim, 
-			     joint_axis_pos_sim, joint_sim_state, v);
-
+    computeLinkPointVelocity(contacts[cID].id_start, x, link_omega_sim, link_vel_sim, v);
 
-    //computeLinkVelocity(contacts[cID].id_start, link_pos_sim, joint_origin_pos_sim, 
-    //			     joint_axis_pos_sim, joint_sim_state, v);
-    /*
-    for (i=1; i<=N_CART; ++i)
-      v[i] = base_state.xd[i];
-    */
-    
   } else {
-    computeLinkVelocity(contacts[cID].id_start, link_pos_sim, joint_origin_pos_sim, 
-			joint_axis_pos_sim, joint_sim_state, v_start);
-    computeLinkVelocity(contacts[cID].id_end, link_pos_sim, joint_origin_pos_sim, 
-			joint_axis_pos_sim, joint_sim_state, v_end);
+
+    computeLinkPointVelocity(contacts[cID].id_start, link_pos_sim[contacts[cID].id_start], 
+			     link_omega_sim, link_vel_sim, v_start);
+    computeLinkPointVelocity(contacts[cID].id_end, link_pos_sim[contacts[cID].id_end], 
+			     link_omega_sim, link_vel_sim, v_end);
 
     for (i=1; i<=N_CART; ++i)
       v[i] = v_start[i]*contacts[cID].fraction_start + v_end[i]*contacts[cID].fraction_end;
-  }
 
-  // convert the velocity to object coordinates
-  if (optr->rot[_A_] != 0.0) {
-    aux  =  v[2]*cos(optr->rot[1])+v[3]*sin(optr->rot[_A_]);
-    v[3] = -v[2]*sin(optr->rot[1])+v[3]*cos(optr->rot[_A_]);
-    v[2] = aux;
-  }
-  
-  if (optr->rot[_B_] != 0.0) {
-    aux  =  v[1]*cos(optr->rot[2])-v[3]*sin(optr->rot[_B_]);
-    v[3] =  v[1]*sin(optr->rot[2])+v[3]*cos(optr->rot[_B_]);
-    v[1] = aux;
-  }
-  
-  if (optr->rot[_G_] != 0.0) {
-    aux  =  v[1]*cos(optr->rot[3])+v[2]*sin(optr->rot[_G_]);
-    v[2] = -v[1]*sin(optr->rot[3])+v[2]*cos(optr->rot[_G_]);
-    v[1] = aux;
   }
 
 }
 
-
-
 /*!*****************************************************************************
  *******************************************************************************
 \note  addObjectSync
@@ -1741,6 +3298,10 @@ addObjectSync(char *name, int type, int contact, double *rgb, double *pos, doubl
     n_objs_parm = N_CYLINDER_PARMS;
     break;
 
+  case MESH:
+    n_objs_parm = N_MESH_PARMS;
+    break;
+
   default:
     n_objs_parm = 0;
   }
@@ -2170,6 +3731,80 @@ computeContactPoint(ContactPtr cptr, double **lp, double ***al, double *x)
 }
 
 
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeSurfaceContactSpecifics
+\date  Oct 2026
+   
+\remarks 
+
+ computes the contact specifics and forces of a contact point with a surface
+ that is given by its normal and the penetration depth along the normal, as 
+ for terrains and meshes
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     i     : the contact point
+ \param[in]     optr  : the object in contact
+ \param[in]     x     : contact point in object centered coordinates
+ \param[in]     n     : the unit normal of the surface, pointing out of the surface
+ \param[in]     depth : penetration depth along the normal
+
+ ******************************************************************************/
+static void
+computeSurfaceContactSpecifics(int i, ObjectPtr optr, double *x, double *n, 
+			       double depth)
+{
+  int       j;
+  double    aux,aux1;
+  double    v[N_CART+1];
+
+  // remember which object we are contacting, and also the 
+  // contact point in object centered coordinates
+  if (!contacts[i].status || contacts[i].optr != optr ) {
+    for (j=1; j<=N_CART; ++j) {
+      contacts[i].x_start[j] = x[j];
+      contacts[i].x[j] = x[j];
+    }
+    contacts[i].friction_flag = FALSE;
+  }
+  contacts[i].status = TRUE;
+  contacts[i].optr   = optr;
+  for (j=1; j<=N_CART; ++j) {
+    contacts[i].x[j] = x[j];
+  }
+  
+  // the local veclocity of the contact point
+  contactVelocity(i,optr,v);
+  aux1 = n[_X_]*v[_X_]+n[_Y_]*v[_Y_]+n[_Z_]*v[_Z_];
+  
+  // the normal vector: the penetration depth along the normal
+  for (j=1; j<=N_CART; ++j) {
+    contacts[i].normal[j]   = n[j]*depth;
+    contacts[i].normvel[j]  = -aux1*n[j];
+  }
+  
+  // the tangential vector: project x-x_start into the null-space of normal
+  aux  = 0.0;
+  for (j=1; j<=N_CART; ++j) {
+    contacts[i].tangent[j]=x[j]-contacts[i].x_start[j];
+    aux  += contacts[i].tangent[j]*n[j];
+  }
+  
+  for (j=1; j<=N_CART; ++j) {
+    contacts[i].tangent[j] -= n[j]*aux;
+    contacts[i].tanvel[j]   = v[j]-n[j]*aux1;
+  }
+  
+  // the tangential velocity for viscous friction
+  for (j=1; j<=N_CART; ++j)
+    contacts[i].viscvel[j] = v[j]-n[j]*aux1;
+  
+  computeContactForces(optr,&contacts[i]);
+
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  checkContactSpecifics
@@ -2203,6 +3838,7 @@ checkContactSpecifics(ContactSpecs cspecs)
   char      tfname[100];
   double    no_go;
   double    dist_z;
+  double    xc[N_CART+1];
 
   first_contact_flag = FALSE;
   contact_flag = FALSE;
@@ -2490,56 +4126,25 @@ checkContactSpecifics(ContactSpecs cspecs)
     
   case TERRAIN: //---------------------------------------------------------------
 
-    getContactTerrainInfo(x[1], x[2], optr->name, &z, n, &no_go);
+    getContactTerrainInfoByHandle(optr->terrain, x[1], x[2], &z, n, &no_go);
 
-    // remember which object we are contacting, and also the 
-    // contact point in object centered coordinates
-    if (!contacts[i].status || contacts[i].optr != optr ) {
-      for (j=1; j<=N_CART; ++j) {
-	contacts[i].x_start[j] = x[j];
-	contacts[i].x[j] = x[j];
-      }
-      contacts[i].friction_flag = FALSE;
-      first_contact_flag = TRUE;
-    }
-    contacts[i].status = contact_flag = TRUE;
-    contacts[i].optr   = optr;
-    for (j=1; j<=N_CART; ++j) {
-      contacts[i].x[j] = x[j];
-    }
-    
-    // the local veclocity of the contact point
-    contactVelocity(i,optr,v);
-    aux1 = n[_X_]*v[_X_]+n[_Y_]*v[_Y_]+n[_Z_]*v[_Z_];
-    
-    // compute relevant geometric information
-    
-    // the normal vector
-    for (j=1; j<=N_CART; ++j) {
-      // note: n'*[ 0 0 (z-x[3])] = (z-x[3])*n[3] is the effective
-      // projection of the vertical distance to the surface onto
-      // the normal
-      contacts[i].normal[j]   = n[j]*((z-x[3])*n[3]);
-      contacts[i].normvel[j]  = -aux1*n[j];
-    }
-    
-    // the tangential vector: project x-x_start into the null-space of normal
-    aux  = 0.0;
-    for (j=1; j<=N_CART; ++j) {
-      contacts[i].tangent[j]=x[j]-contacts[i].x_start[j];
-      aux  += contacts[i].tangent[j]*n[j];
-    }
+    // note: n'*[ 0 0 (z-x[3])] = (z-x[3])*n[3] is the effective projection
+    // of the vertical distance to the surface onto the normal
+    computeSurfaceContactSpecifics(i, optr, x, n, (z-x[3])*n[3]);
     
-    for (j=1; j<=N_CART; ++j) {
-      contacts[i].tangent[j] -= n[j]*aux;
-      contacts[i].tanvel[j]   = v[j]-n[j]*aux1;
-    }
+    break;
     
-    // the tangential velocity for viscous friction
-    for (j=1; j<=N_CART; ++j)
-      contacts[i].viscvel[j] = v[j]-n[j]*aux1;
     
-    computeContactForces(optr,&contacts[i]);
+  case MESH: //---------------------------------------------------------------
+
+    // the closest point on the mesh surface: the contact normal points from 
+    // x to this point, or is the face normal if x is right at the surface
+    aux2 = getClosestPointMesh(optr->mesh, x, xc, n);
+    if (aux2 > 1.e-10)
+      for (j=1; j<=N_CART; ++j)
+	n[j] = (xc[j]-x[j])/aux2;
+
+    computeSurfaceContactSpecifics(i, optr, x, n, aux2);
     
     break;
     
@@ -2601,9 +4206,9 @@ static void *
 contactThread(void *num)
 {
 
-  int i;
   long t = (long) num;
-  int ID;
+  int  ID;
+  int  generation = 0;
   char name[100];
 
   ID = (int) t;
@@ -2613,20 +4218,23 @@ contactThread(void *num)
 #ifdef __XENO__
   rt_task_shadow(NULL, name, 90, T_CPU((ID-1)));
 #endif
-  sl_rt_mutex_lock(&(cspecs_mutex[ID]));
+  sl_rt_mutex_lock(&cspecs_mutex);
 
   while ( TRUE ) {
 
-    sl_rt_cond_wait(&(cspecs_status[ID]),&(cspecs_mutex[ID]));
+    // wait for a new batch of work -- checking the generation counter
+    // under the mutex ensures that no start signal can be lost
+    while (cspecs_generation == generation)
+      sl_rt_cond_wait(&cspecs_start,&cspecs_mutex);
+    generation = cspecs_generation;
+    sl_rt_mutex_unlock(&cspecs_mutex);
 
-    //printf("running %d for %d\n",ID,cspecs_data[ID].i);
-    for (i=1; i<=n_cspecs_data[ID]; ++i)
-      checkContactSpecifics(cspecs_data[ID][i]);
+    processContactChunks(ID);
 
     // done ...
-    n_cspecs_data[ID] = 0;
-
-    //printf("done %d for %d\n",ID,cspecs_data[ID].i);
+    sl_rt_mutex_lock(&cspecs_mutex);
+    if (++n_cspecs_threads_done == n_cspecs_threads)
+      sl_rt_cond_signal(&cspecs_done);
 
   } 
   
@@ -2636,6 +4244,183 @@ contactThread(void *num)
 
 }
 
+/*!*****************************************************************************
+*******************************************************************************
+\note  runContactThreadPool
+\date  Oct 2026
+ 
+\remarks 
+ 
+processes all active chunks of contact points with the thread pool. The 
+chunks are partitioned into contiguous blocks for the pool threads and the
+calling thread, which all participate in the work. The function returns
+after all chunks were processed.
+ 
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+ 
+none
+ 
+******************************************************************************/
+static void
+runContactThreadPool(void)
+{
+  int i;
+  int n = n_cspecs_threads+1;
+
+  // the partitions; the calling thread has ID zero
+  for (i=0; i<n; ++i) {
+    cspecs_next[i] = (i*n_active_chunks)/n;
+    cspecs_end[i]  = ((i+1)*n_active_chunks)/n;
+  }
+
+  // start the pool
+  sl_rt_mutex_lock(&cspecs_mutex);
+  n_cspecs_threads_done = 0;
+  ++cspecs_generation;
+  sl_rt_cond_broadcast(&cspecs_start);
+  sl_rt_mutex_unlock(&cspecs_mutex);
+
+  processContactChunks(0);
+
+  // wait for all pool threads to finish
+  sl_rt_mutex_lock(&cspecs_mutex);
+  while (n_cspecs_threads_done < n_cspecs_threads)
+    sl_rt_cond_wait(&cspecs_done,&cspecs_mutex);
+  sl_rt_mutex_unlock(&cspecs_mutex);
+
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  processContactChunks
+\date  Oct 2026
+ 
+\remarks 
+ 
+processes the active chunks of the current batch, starting with the thread's
+own partition, and stealing from the other partitions afterwards. Chunks are
+claimed with an atomic increment, such that every chunk is processed exactly
+once.
+ 
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+ 
+\param[in]     ID : the ID of the thread (0 for the calling thread)
+ 
+******************************************************************************/
+static void
+processContactChunks(int ID)
+{
+  int i,k,p;
+  int n = n_cspecs_threads+1;
+
+  for (k=0; k<n; ++k) {
+    p = (ID+k)%n;
+    while ((i = __sync_fetch_and_add(&(cspecs_next[p]),1)) < cspecs_end[p])
+      processContactChunk(active_chunks[i]);
+  }
+
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  processContactChunk
+\date  Oct 2026
+ 
+\remarks 
+ 
+processes the pending contact specs of all contact points of a chunk, and 
+accumulates the forces of the points with contact in the chunk accumulator,
+in the order of the contact points. Only data of the chunk is written, such
+that chunks can be processed in parallel.
+ 
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+ 
+\param[in]     c : the chunk index
+ 
+******************************************************************************/
+static void
+processContactChunk(int c)
+{
+  int      i;
+  int      i_end = (c+1)*CONTACT_CHUNK_SIZE;
+  SL_uext *uc = &(chunk_ucontact[c*(n_dofs+1)]);
+
+  if (i_end > n_contacts+1)
+    i_end = n_contacts+1;
+
+  bzero((void *)uc,sizeof(SL_uext)*(n_dofs+1));
+
+  for (i=c*CONTACT_CHUNK_SIZE; i<i_end; ++i) {
+
+    if (contact_spec[i] > 0) {
+      checkContactSpecifics(cspecs_data[contact_spec[i]]);
+      contact_spec[i] = 0;
+    }
+
+    if (contacts[i].status)
+      accumulateFinalForces(&(contacts[i]), uc, &(contact_uobj[i]));
+
+  }
+
+}
+
+/*!*****************************************************************************
+*******************************************************************************
+\note  reduceContactChunks
+\date  Oct 2026
+ 
+\remarks 
+ 
+merges the chunk accumulators into ucontact with a pairwise tree reduction
+over the active chunks, and adds the forces and torques on the objects in 
+the order of the contact points. The order of all additions only depends on
+which contact points are in contact.
+ 
+*******************************************************************************
+Function Parameters: [in]=input,[out]=output
+ 
+none
+ 
+******************************************************************************/
+static void
+reduceContactChunks(void)
+{
+  int      i,j,k,s;
+  SL_uext *uc1;
+  SL_uext *uc2;
+
+  if (n_active_chunks == 0)
+    return;
+
+  for (s=1; s<n_active_chunks; s*=2) {
+    for (k=0; k+s<n_active_chunks; k+=2*s) {
+      uc1 = &(chunk_ucontact[active_chunks[k]*(n_dofs+1)]);
+      uc2 = &(chunk_ucontact[active_chunks[k+s]*(n_dofs+1)]);
+      for (i=0; i<=n_dofs; ++i)
+	for (j=_X_; j<=_Z_; ++j) {
+	  uc1[i].f[j] += uc2[i].f[j];
+	  uc1[i].t[j] += uc2[i].t[j];
+	}
+    }
+  }
+
+  memcpy((void *)ucontact,(void *)&(chunk_ucontact[active_chunks[0]*(n_dofs+1)]),
+	 sizeof(SL_uext)*(n_dofs+1));
+
+  for (i=0; i<=n_contacts; ++i) {
+    if (!contacts[i].status)
+      continue;
+    for (j=_X_; j<=_Z_; ++j) {
+      contacts[i].optr->f[j] += contact_uobj[i].f[j];
+      contacts[i].optr->t[j] += contact_uobj[i].t[j];
+    }
+  }
+
+}
+
 
 /*!*****************************************************************************
  *******************************************************************************
@@ -2645,21 +4430,21 @@ contactThread(void *num)
 \remarks 
 
       for a given contact point and object, the final forces acting on the
-      joint and objects are accumulated. The force/torque structures must
-      have been zeros before accumulation over all contact points. The forces
-      at the contact point must be pre-computed. This function was separated
-      as it requires writing to memory structures that need to be shared
-      between threads.
+      joint are accumulated in uc, and the force and torque acting on the 
+      object are returned in uo. The force/torque structure uc must have 
+      been zeroed before accumulation over all contact points. The forces
+      at the contact point must be pre-computed.
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
- \param[in]     optr  : ptr to object
  \param[in]     ctpr  : ptr to contact point
+ \param[in,out] uc    : accumulator of the forces/torques at all DOFs
+ \param[out]    uo    : force and torque on the object
 
  ******************************************************************************/
 static void
-accumulateFinalForces(ContactPtr cptr)
+accumulateFinalForces(ContactPtr cptr, SL_uext *uc, SL_uext *uo)
 
 {
   int i,j;
@@ -2669,57 +4454,58 @@ accumulateFinalForces(ContactPtr cptr)
   ObjectPtr optr;
 
   optr = cptr->optr;
+  bzero((void *)uo,sizeof(SL_uext));
 
   // compute the contact point in global coordinates
   computeContactPoint(cptr,link_pos_sim,Alink_sim,x);
 
   /* first the start link */
   for (i=1; i<=N_CART; ++i) {
-    ucontact[cptr->base_dof_start].f[i] += cptr->f[i]*cptr->fraction_start;
-    optr->f[i] += cptr->f[i]*cptr->fraction_start;
+    uc[cptr->base_dof_start].f[i] += cptr->f[i]*cptr->fraction_start;
+    uo->f[i] += cptr->f[i]*cptr->fraction_start;
     moment_arm[i] = x[i]-link_pos_sim[cptr->off_link_start][i];
     moment_arm_object[i] = x[i]-optr->trans[i];
   }
 
   /* get the torque at the DOF from the cross product */
-  ucontact[cptr->base_dof_start].t[_A_] += moment_arm[_Y_]*cptr->f[_Z_]*cptr->fraction_start - 
+  uc[cptr->base_dof_start].t[_A_] += moment_arm[_Y_]*cptr->f[_Z_]*cptr->fraction_start - 
     moment_arm[_Z_]*cptr->f[_Y_]*cptr->fraction_start;
-  ucontact[cptr->base_dof_start].t[_B_] += moment_arm[_Z_]*cptr->f[_X_]*cptr->fraction_start - 
+  uc[cptr->base_dof_start].t[_B_] += moment_arm[_Z_]*cptr->f[_X_]*cptr->fraction_start - 
     moment_arm[_X_]*cptr->f[_Z_]*cptr->fraction_start;
-  ucontact[cptr->base_dof_start].t[_G_] += moment_arm[_X_]*cptr->f[_Y_]*cptr->fraction_start - 
+  uc[cptr->base_dof_start].t[_G_] += moment_arm[_X_]*cptr->f[_Y_]*cptr->fraction_start - 
     moment_arm[_Y_]*cptr->f[_X_]*cptr->fraction_start;
 
   /* get the torque at the object center from the cross product */
-  optr->t[_A_] += moment_arm_object[_Y_]*cptr->f[_Z_]*cptr->fraction_start - 
+  uo->t[_A_] += moment_arm_object[_Y_]*cptr->f[_Z_]*cptr->fraction_start - 
     moment_arm_object[_Z_]*cptr->f[_Y_]*cptr->fraction_start;
-  optr->t[_B_] += moment_arm_object[_Z_]*cptr->f[_X_]*cptr->fraction_start - 
+  uo->t[_B_] += moment_arm_object[_Z_]*cptr->f[_X_]*cptr->fraction_start - 
     moment_arm_object[_X_]*cptr->f[_Z_]*cptr->fraction_start;
-  optr->t[_G_] += moment_arm_object[_X_]*cptr->f[_Y_]*cptr->fraction_start - 
+  uo->t[_G_] += moment_arm_object[_X_]*cptr->f[_Y_]*cptr->fraction_start - 
     moment_arm_object[_Y_]*cptr->f[_X_]*cptr->fraction_start;
 
   /* second the end link */
   for (i=1; i<=N_CART; ++i) {
-    ucontact[cptr->base_dof_end].f[i] += cptr->f[i]*cptr->fraction_end;
-    optr->f[i] += cptr->f[i]*cptr->fraction_end;
+    uc[cptr->base_dof_end].f[i] += cptr->f[i]*cptr->fraction_end;
+    uo->f[i] += cptr->f[i]*cptr->fraction_end;
     moment_arm[i] = x[i]-link_pos_sim[cptr->off_link_end][i];
     moment_arm_object[i] = x[i]-optr->trans[i];
   }
   
   /* get the torque at the DOF from the cross product */
-  ucontact[cptr->base_dof_end].t[_A_] += moment_arm[_Y_]*cptr->f[_Z_]*cptr->fraction_end - 
+  uc[cptr->base_dof_end].t[_A_] += moment_arm[_Y_]*cptr->f[_Z_]*cptr->fraction_end - 
     moment_arm[_Z_]*cptr->f[_Y_]*cptr->fraction_end;
-  ucontact[cptr->base_dof_end].t[_B_] += moment_arm[_Z_]*cptr->f[_X_]*cptr->fraction_end - 
+  uc[cptr->base_dof_end].t[_B_] += moment_arm[_Z_]*cptr->f[_X_]*cptr->fraction_end - 
     moment_arm[_X_]*cptr->f[_Z_]*cptr->fraction_end;
-  ucontact[cptr->base_dof_end].t[_G_] += moment_arm[_X_]*cptr->f[_Y_]*cptr->fraction_end - 
+  uc[cptr->base_dof_end].t[_G_] += moment_arm[_X_]*cptr->f[_Y_]*cptr->fraction_end - 
     moment_arm[_Y_]*cptr->f[_X_]*cptr->fraction_end;
 
   
   /* get the torque at the object center from the cross product */
-  optr->t[_A_] += moment_arm_object[_Y_]*cptr->f[_Z_]*cptr->fraction_end - 
+  uo->t[_A_] += moment_arm_object[_Y_]*cptr->f[_Z_]*cptr->fraction_end - 
     moment_arm_object[_Z_]*cptr->f[_Y_]*cptr->fraction_end;
-  optr->t[_B_] += moment_arm_object[_Z_]*cptr->f[_X_]*cptr->fraction_end - 
+  uo->t[_B_] += moment_arm_object[_Z_]*cptr->f[_X_]*cptr->fraction_end - 
     moment_arm_object[_X_]*cptr->f[_Z_]*cptr->fraction_end;
-  optr->t[_G_] += moment_arm_object[_X_]*cptr->f[_Y_]*cptr->fraction_end - 
+  uo->t[_G_] += moment_arm_object[_X_]*cptr->f[_Y_]*cptr->fraction_end - 
     moment_arm_object[_Y_]*cptr->f[_X_]*cptr->fraction_end;
 
 
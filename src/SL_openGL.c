@@ -36,6 +36,7 @@
 #include "SL_terrains.h"
 #include "SL_common.h"
 #include "SL_objects.h"
+#include "SL_meshes.h"
 #include "utility.h"
 #include "SL_collect_data.h"
 #include "SL_man.h"
@@ -1334,6 +1335,39 @@ drawObjects(void)
 	
 	break;
 	
+      case MESH:
+	// the display list is created from the unscaled OBJ file, and its
+	// index is kept in display_list_active (-1 if the file cannot be read)
+	if (!ptr->display_list_active) {
+	  char fname[200];
+	  
+	  sprintf(fname,"%s%s",MESHES,ptr->name);
+	  ptr->display_list_active = displayListFromObjFile(fname,1.0);
+	  if (!ptr->display_list_active)
+	    ptr->display_list_active = -1;
+	}
+	if (ptr->display_list_active < 0)
+	  break;
+
+	glPushMatrix();
+	glTranslated((GLdouble)ptr->trans[1],
+		     (GLdouble)ptr->trans[2],
+		     (GLdouble)ptr->trans[3]);
+	if (ptr->rot[1] != 0.0)
+	  glRotated((GLdouble)(180./PI)*ptr->rot[1],(GLdouble)1.,
+		    (GLdouble)0.,(GLdouble)0.);      
+	if (ptr->rot[2] != 0.0)
+	  glRotated((GLdouble)(180./PI)*ptr->rot[2],(GLdouble)0.,
+		    (GLdouble)1,(GLdouble)0.);      
+	if (ptr->rot[3] != 0.0)
+	  glRotated((GLdouble)(180./PI)*ptr->rot[3],(GLdouble)0.0,
+		    (GLdouble)0.,(GLdouble)1.);      
+	glScaled(ptr->scale[1],ptr->scale[2],ptr->scale[3]);
+	glCallList((GLuint)ptr->display_list_active);
+	glPopMatrix();
+	
+	break;
+	
       }
       
     }
@@ -3361,8 +3395,8 @@ drawCoordSystem(double length, double **A, char *name)
    
 \remarks 
 
-        reads an OBJ (WAVEFRONT/MAJA) file and creates a display list
-	from the faces.
+        reads an OBJ (WAVEFRONT/MAJA) file with readObjFile() and creates 
+	a display list from the faces.
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
@@ -3374,7 +3408,6 @@ drawCoordSystem(double length, double **A, char *name)
  returns the ID of the display list, or FALSE
 
  ******************************************************************************/
-#define MAX_STRING_LEN 1000
 int
 displayListFromObjFile(char *fname, double scale) 
 {
@@ -3384,16 +3417,7 @@ displayListFromObjFile(char *fname, double scale)
 int
 displayListFromObjFileFlag(char *fname, double scale,int flag)
 {
-  int     i,j,k,r,rc;
-  FILE   *fp;
-  double  v1[3+1];
-  double  v2[3+1];
-  double  v3[3+1];
-  double  x,y,z;
-  char    string[MAX_STRING_LEN+1];
-  char    fnamebin[300];
-  int     c;
-  char    key[10];
+  int     i,j;
   int     n_v=0;
   int     n_f=0;
   int     n_vn=0;
@@ -3402,196 +3426,28 @@ displayListFromObjFileFlag(char *fname, double scale,int flag)
   iMatrix f;
   double  max_v[N_CART+1] = {0.0,-1.e10,-1.e10,-1.e10};
   double  min_v[N_CART+1] = {0.0,+1.e10,+1.e10,+1.e10};
-  int     nx,ny;
-  struct  stat sfile;
-  struct  stat sfilebin;
-
-  // check whether binary version exists 
-  sprintf(fnamebin,"%s.bin",fname);
-
-  // check whether binary versin needs to be re-generated
-  if (stat(fnamebin,&sfilebin) == 0) { // the file exists
-
-    // check date in comparison to filename file and regenerate .bin if needed
-    stat(fname,&sfile);
-    if (sfile.st_mtime > sfilebin.st_mtime) // need update
-      remove(fnamebin);
-  }
-
-  fp = fopen(fnamebin,"r");
-
-  if (fp == NULL) { // try reading the ascii file
-
-    // try to open the file
-    fp = fopen(fname,"r");
-    if (fp == NULL) {
-      printf("Cannot read OBJ file >%s<\n",fname);
-      return FALSE;
-    }
-    
-    printf("Processing %s ...\n",fname);
-    
-    // count the number of faces, vertices, normals in file
-    while (TRUE) {
-      
-      // get the next line
-      i=0;
-      while ((c=fgetc(fp)) != '\n' && c != EOF) {
-	string[i++] = c;
-	if ( i >= MAX_STRING_LEN ) {
-	  printf("ERROR: max. string length exceeded\n");
-	  return FALSE;
-	}
-      }
-      string[i] = '\0';
-      
-      // check for vertices and faces
-      sscanf(string,"%s",key);
-      if (strcmp(key,"vn")==0)
-	++n_vn;
-      else if (strcmp(key,"f")==0)
-	++n_f;
-      else if (strcmp(key,"v")==0)
-	++n_v;
-      
-      if (c == EOF)
-	break;
-      
-    }
-    
-    printf("#faces=%d  #vertices=%d   #normals=%d\n",n_f,n_v,n_vn);
-    
-    rewind(fp);
-    
-    // allocate memory
-    v  = my_matrix(1,n_v,1,3);
-    f  = my_imatrix(1,n_f,1,9); // first 3 for vertex, next for texture, last 3 for normal
-    if (n_vn > 0)
-      vn = my_matrix(1,n_vn,1,3);
-    
-    // get the data
-    n_v = n_f = n_vn = 0;
-    while (TRUE) {
-      char s1[100],s2[100],s3[100];
-      
-      // get the next line
-      i=0;
-      while ((c=fgetc(fp)) != '\n' && c != EOF) {
-	string[i++] = c;
-	if ( i >= MAX_STRING_LEN ) {
-	  printf("ERROR: max. string length exceeded\n");
-	  return FALSE;
-	}
-      }
-      string[i] = '\0';
-      
-      // check for vertices, normals, and faces
-      sscanf(string,"%s",key);
-      if (strcmp(key,"vn")==0) {
-	++n_vn;
-	sscanf(string,"%s %lf %lf %lf",key,&vn[n_vn][1],&vn[n_vn][2],&vn[n_vn][3]);
-	
-      } else if (strcmp(key,"v")==0) {
-	++n_v;
-	sscanf(string,"%s %lf %lf %lf",key,&v[n_v][1],&v[n_v][2],&v[n_v][3]);
-	
-	v[n_v][1]*=scale;
-	v[n_v][2]*=scale;
-	v[n_v][3]*=scale;
-	
-	for (j=1; j<=N_CART; ++j) {
-	  if (v[n_v][j] > max_v[j])
-	    max_v[j] = v[n_v][j];
-	  if (v[n_v][j] < min_v[j])
-	    min_v[j] = v[n_v][j];
-	}
-	
-      } else if (strcmp(key,"f")==0) {
-	++n_f;
-	
-	sscanf(string,"%s %s %s %s",key,s1,s2,s3);
-	
-	if (sscanf(s1,"%d/%d/%d",&f[n_f][1],&f[n_f][1+3],&f[n_f][1+6]) == 3) {
-	  ; // this is the best scenario with vertex,texture, and normal info
-	} else if (sscanf(s1,"%d//%d",&f[n_f][1],&f[n_f][1+6]) == 2) {
-	  ; // texture info is missing
-	} else if (sscanf(s1,"%d/%d/",&f[n_f][1],&f[n_f][1+3]) == 2) {
-	  ; // normal info is missing
-	} else {
-	  if (sscanf(s1,"%d",&f[n_f][1]) != 1) 
-	    printf("Couldn't parse face informamtion\n");
-	}
-	
-	if (sscanf(s2,"%d/%d/%d",&f[n_f][2],&f[n_f][2+3],&f[n_f][2+6]) == 3) {
-	  ; // this is the best scenario with vertex,texture, and normal info
-	} else if (sscanf(s2,"%d//%d",&f[n_f][2],&f[n_f][2+6]) == 2) {
-	  ; // texture info is missing
-	} else if (sscanf(s2,"%d/%d/",&f[n_f][2],&f[n_f][2+3]) == 2) {
-	  ; // normal info is missing
-	} else {
-	  if (sscanf(s2,"%d",&f[n_f][2]) != 1) 
-	    printf("Couldn't parse face informamtion\n");
-	}
-	
-	if (sscanf(s3,"%d/%d/%d",&f[n_f][3],&f[n_f][3+3],&f[n_f][3+6]) == 3) {
-	  ; // this is the best scenario with vertex,texture, and normal info
-	} else if (sscanf(s3,"%d//%d",&f[n_f][3],&f[n_f][3+6]) == 2) {
-	  ; // texture info is missing
-	} else if (sscanf(s3,"%d/%d/",&f[n_f][3],&f[n_f][3+3]) == 2) {
-	  ; // normal info is missing
-	} else {
-	  if (sscanf(s3,"%d",&f[n_f][3]) != 1) 
-	    printf("Couldn't parse face informamtion\n");
-	}
-	
-      }
-      
-      if (c == EOF)
-	break;
-    }
-    fclose(fp);
-    
-    printf("max: x=%6.2f y=%6.2f z=%6.2f\n",max_v[_X_],max_v[_Y_],max_v[_Z_]);
-    printf("min: x=%6.2f y=%6.2f z=%6.2f\n",min_v[_X_],min_v[_Y_],min_v[_Z_]);
-    
-    // write binary files
-    fp = fopen(fnamebin,"w");
-    fprintf(fp,"%d %d %d\n",n_v,n_vn,n_f);
-
-    fwrite_mat(fp,v);
-    if (n_vn > 0)
-      fwrite_mat(fp,vn);
-    fwrite_imat(fp,f);
 
-    fclose(fp);
+  // read the OBJ file with the same parser as the simulation meshes
+  if (!readObjFile(fname,&v,&n_v,&vn,&n_vn,&f,&n_f))
+    return FALSE;
 
-    printf("... done with %s\n",fname);
-    
-  } else { // read binary files
-    
-    rc = fscanf(fp,"%d %d %d",&n_v,&n_vn,&n_f);
-    fgetc(fp);
-
-    // allocate memory
-    v  = my_matrix(1,n_v,1,3);
-    f  = my_imatrix(1,n_f,1,9); // first 3 for vertex, next for texture, last 3 for normal
-    if (n_vn > 0)
-      vn = my_matrix(1,n_vn,1,3);
-    
-    // binary read
-    fread_mat(fp,v);
-    if (n_vn > 0) {
-      fread_mat(fp,vn);
-      if (flag) 
-	mat_mult_scalar(vn,-1.0,vn);
+  // scale the vertices
+  for (i=1; i<=n_v; ++i) {
+    for (j=1; j<=N_CART; ++j) {
+      v[i][j] *= scale;
+      if (v[i][j] > max_v[j])
+	max_v[j] = v[i][j];
+      if (v[i][j] < min_v[j])
+	min_v[j] = v[i][j];
     }
-    fread_imat(fp,f);
+  }
 
-    fclose(fp);
+  printf("max: x=%6.2f y=%6.2f z=%6.2f\n",max_v[_X_],max_v[_Y_],max_v[_Z_]);
+  printf("min: x=%6.2f y=%6.2f z=%6.2f\n",min_v[_X_],min_v[_Y_],min_v[_Z_]);
 
-  }
+  if (n_vn > 0 && flag) 
+    mat_mult_scalar(vn,-1.0,vn);
 
-  
   // create one display list item
   GLuint index = glGenLists(1);
   glNewList((GLuint)index, GL_COMPILE);
@@ -829,6 +829,10 @@ sendMessageToServo(smMessage *sm_message, SEM_ID sm_message_sem,
  void 
    sendMessageOpenGLServo(char *message, void *buf, int n_bytes)
  {
+   // without graphics, nobody would ever read these messages
+   if (no_graphics_flag)
+     return;
+
    sendMessageToServo(sm_openGL_message, sm_openGL_message_sem, 
 		      sm_openGL_message_ready_sem, 
 		      message, buf, n_bytes);
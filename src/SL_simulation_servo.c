@@ -49,11 +49,15 @@ double  servo_time=0;
 int     n_integration    = 1;   
 int     integrate_method = INTEGRATE_EULER;
 int     real_time        = TRUE;
+int     n_integration_coarse   = 0;     // 0: multi-rate integration is off
+double  multi_rate_dist_margin = 0.01;  // distance margin for imminent contacts
 
 // local variables
 double *controller_gain_th;
 double *controller_gain_thd;
 double *controller_gain_int;
+static long n_fine_steps   = 0;
+static long n_coarse_steps = 0;
 
 
 // global functions 
@@ -61,6 +65,8 @@ double *controller_gain_int;
 // local functions
 static void setIntRate(void);
 static void setIntMethod(void);
+static void setMultiRate(void);
+static void integrateStep(double dt);
 static void status(void);
 
 
@@ -129,6 +135,7 @@ int
 init_simulation_servo(void)
 {
   int i, j;
+  double aux;
 
   // the servo name
   sprintf(servo_name,"sim");
@@ -159,6 +166,12 @@ init_simulation_servo(void)
   if (!initObjects())
     return FALSE;
 
+  // multi-rate integration: coarse steps away from contacts
+  if (read_parameter_pool_int(config_files[PARAMETERPOOL],"n_integration_coarse",&i))
+    n_integration_coarse = (i > 0) ? i : 0;
+  if (read_parameter_pool_double(config_files[PARAMETERPOOL],"multi_rate_dist_margin",&aux))
+    multi_rate_dist_margin = aux;
+
   // need sensor offsets
   if (!read_sensor_offsets(config_files[SENSOROFFSETS]))
     return FALSE;
@@ -170,6 +183,7 @@ init_simulation_servo(void)
   // add to man pages 
   addToMan("setIntRate","set number of integration cycles",setIntRate);
   addToMan("setIntMethod","set integration method",setIntMethod);
+  addToMan("setMultiRate","set number of coarse integration cycles",setMultiRate);
   addToMan("realTime","toggle real-time processing",toggleRealTime);
   addToMan("status","displays status information about servo",status);
   addToMan("dss","disables the simulation servo",dss);
@@ -210,7 +224,7 @@ int
 run_simulation_servo(void)
 
 {
-  int    i;
+  int    i,j,n;
   double k,kd;
   double delta;
   double dt;
@@ -328,25 +342,33 @@ run_simulation_servo(void)
   // general numerical integration: integration runs at higher rate
   dt = 1./(double)(simulation_servo_rate)/(double)n_integration;
 
-  for (i=1; i<=n_integration; ++i) {
-    
-    // integrate the simulation
-    switch (integrate_method) {
-    case INTEGRATE_RK:
-      SL_IntegrateRK(joint_sim_state, &base_state, 
-		     &base_orient, ucontact, endeff,dt,n_dofs);
-      break;
-      
-    case INTEGRATE_EULER:
-      SL_IntegrateEuler(joint_sim_state, &base_state, 
-			&base_orient, ucontact, endeff,dt,n_dofs,TRUE);
-      break;
-      
-    default:
-      printf("invalid integration method\n");
-      
+  if (n_integration_coarse > 0 && n_integration_coarse < n_integration &&
+      n_integration % n_integration_coarse == 0) {
+
+    // multi-rate integration: each coarse step is only subdivided into 
+    // fine steps if contacts are active or could occur during the step.
+    // The servo cycle always covers the same simulated time.
+    n = n_integration/n_integration_coarse;
+
+    for (i=1; i<=n_integration_coarse; ++i) {
+
+      if (checkContactsImminent(dt*(double)n,multi_rate_dist_margin)) {
+	for (j=1; j<=n; ++j)
+	  integrateStep(dt);
+	n_fine_steps += n;
+      } else {
+	integrateStep(dt*(double)n);
+	++n_coarse_steps;
+      }
+
     }
-    
+
+  } else {
+
+    for (i=1; i<=n_integration; ++i)
+      integrateStep(dt);
+    n_fine_steps += n_integration;
+
   }
 
   // compute miscellenous sensors
@@ -572,6 +594,8 @@ status(void)
   printf("            Real-Time Flag         = %d\n",real_time);
   printf("            Gravity                = %f\n",gravity);
   printf("            Integration Rate       = %d\n",n_integration);
+  printf("            Coarse Integration Rate= %d\n",n_integration_coarse);
+  printf("            Fine/Coarse Steps      = %ld/%ld\n",n_fine_steps,n_coarse_steps);
 #ifdef __XENO__
   extern long count_xenomai_mode_switches;
   extern int  delay_ns;
@@ -607,6 +631,81 @@ setIntRate(void)
   n_integration = i;
 
 }
+/*!*****************************************************************************
+ *******************************************************************************
+\note  setMultiRate
+\date  Oct 2026
+\remarks 
+
+ sets the numbers of coarse integration cycles, which are used when no
+ contacts are active or imminent. Zero switches multi-rate integration off.
+ The number of integration cycles needs to be a multiple of this number.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+  none
+
+ ******************************************************************************/
+static void
+setMultiRate(void)
+{
+  int    i;
+  double aux;
+
+  i = n_integration_coarse;
+  get_int("Number of coarse integrations per servo cycle (0=off)",i,&i);
+  if (i < 0)
+    i = 0;
+  if (i > 0 && n_integration % i != 0) {
+    printf("Integration rate %d is not a multiple of %d -- multi-rate is off\n",
+	   n_integration,i);
+    i = 0;
+  }
+  n_integration_coarse = i;
+
+  aux = multi_rate_dist_margin;
+  get_double("Distance margin for imminent contacts",aux,&aux);
+  multi_rate_dist_margin = aux;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  integrateStep
+\date  Oct 2026
+\remarks 
+
+ performs one numerical integration step with the current integration method
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     dt : integration time step
+
+ ******************************************************************************/
+static void
+integrateStep(double dt)
+{
+
+  switch (integrate_method) {
+  case INTEGRATE_RK:
+    SL_IntegrateRK(joint_sim_state, &base_state, 
+		   &base_orient, ucontact, endeff,dt,n_dofs);
+    break;
+    
+  case INTEGRATE_EULER:
+    SL_IntegrateEuler(joint_sim_state, &base_state, 
+		      &base_orient, ucontact, endeff,dt,n_dofs,TRUE);
+    break;
+    
+  default:
+    printf("invalid integration method\n");
+    
+  }
+
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  setIntMethod
@@ -1101,6 +1200,10 @@ send_contacts(void)
   
   int i,j;
 
+  // contact information is only broadcast for visualization
+  if (no_graphics_flag)
+    return TRUE;
+
   if (semTake(sm_contacts_sem,ns2ticks(TIME_OUT_NS)) == ERROR) {
     
     ++simulation_servo_errors;
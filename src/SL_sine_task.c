@@ -228,6 +228,7 @@ run_sine_task(void)
     SL_InvDyn(joint_state,joint_des_state,endeff,&base_state,&base_orient);
 
   // udpate min/max of endeffector
+  update_kinematics(KIN_STATE);
   for (j=1; j<=n_endeffs; ++j) {
     for (i=1; i<=N_CART; ++i) {
 
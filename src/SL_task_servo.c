@@ -48,6 +48,8 @@ int    frame_counter = 0;
 int    exit_on_stop = FALSE;
 
 /* local variables */
+static int    kin_valid = 0;               // KIN_* flags computed in this tick
+static int    lazy_kinematics = FALSE;
 
 /* global functions */
 int  step(int jid, int iamp);
@@ -148,6 +150,10 @@ init_task_servo(void)
   /* object handling */
   if (!initObjects())
     return;
+
+  /* compute kinematic variables only on request? */
+  if (read_parameter_pool_int(config_files[PARAMETERPOOL],"lazy_kinematics",&i))
+    lazyKinematics(i != 0);
   
   /* add variables to data collection */
   task_servo_rate=servo_base_rate/task_servo_ratio;
@@ -622,6 +628,8 @@ run_task_servo(void)
    * collect data
    */
 
+  if (save_data_flag)
+    update_kinematics(KIN_ALL);
   writeToBuffer();
   sendOscilloscopeData();
 
@@ -952,7 +960,10 @@ step(int jid, int iamp)
    
 \remarks 
 
-       computes kinematic variables
+       computes kinematic variables. At the start of every servo tick, all
+       kinematic variables are marked as out of date. Unless lazy kinematics
+       is switched on, all of them are computed right away, otherwise only 
+       when requested with update_kinematics().
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
@@ -963,139 +974,233 @@ step(int jid, int iamp)
 static void
 compute_kinematics(void)
 {
-  int i,j,r,o;
-  static int firsttime = TRUE;
-  static SL_DJstate *temp;
-  static Matrix last_J;
-  static Matrix last_Jbase;
-  
-  if (firsttime) {
-    temp=(SL_DJstate *)my_calloc((unsigned long)(n_dofs+1),sizeof(SL_DJstate),MY_STOP);
-    last_J      = my_matrix(1,6*n_endeffs,1,n_dofs);
-    last_Jbase  = my_matrix(1,6*n_endeffs,1,2*N_CART);
-  }
 
-  /* compute the desired link positions */
-  linkInformationDes(joint_des_state,&base_state,&base_orient,endeff,
-		     joint_cog_mpos_des,joint_axis_pos_des,joint_origin_pos_des,
-		     link_pos_des,Alink_des,Adof_des);
+  kin_valid = 0;
+
+  if (!lazy_kinematics)
+    update_kinematics(KIN_ALL);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  update_kinematics
+\date  Oct 2026
+   
+\remarks 
+
+       computes the requested kinematic variables if they have not been
+       computed in the current servo tick yet, including all variables
+       they depend on. This function should be called from the task servo,
+       e.g., at the beginning of the run function of a task.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     flags : KIN_* flags of the requested variables
 
-  /* the desired endeffector information */
-  for (i=1; i<=N_CART; ++i) {
+ ******************************************************************************/
+void
+update_kinematics(int flags)
+{
+  int i,j,k,r;
+
+  /* add the variables that the requested ones depend on */
+  if (flags & KIN_CART_VEL)
+    flags |= KIN_JACOBIAN | KIN_JACOBIAN_DT;
+  if (flags & KIN_DES_CART_VEL)
+    flags |= KIN_DES_JACOBIAN;
+  if (flags & (KIN_JACOBIAN | KIN_JACOBIAN_DT))
+    flags |= KIN_STATE;
+  if (flags & KIN_DES_JACOBIAN)
+    flags |= KIN_DES_STATE;
+  if (flags & KIN_COG)
+    flags |= KIN_STATE | KIN_DES_STATE;
+
+  /* only what is out of date */
+  flags &= ~kin_valid;
+  if (flags == 0)
+    return;
+
+  if (flags & KIN_DES_STATE) {
+
+    /* compute the desired link positions */
+    linkInformationDes(joint_des_state,&base_state,&base_orient,endeff,
+		       joint_cog_mpos_des,joint_axis_pos_des,joint_origin_pos_des,
+		       link_pos_des,Alink_des,Adof_des);
+
+    /* the desired endeffector information */
+    for (i=1; i<=N_CART; ++i) {
+      for (j=1; j<=n_endeffs; ++j) {
+	cart_des_state[j].x[i] = link_pos_des[link2endeffmap[j]][i];
+      }
+    }
+
+    /* the desired quaternian of the endeffector */
     for (j=1; j<=n_endeffs; ++j) {
-      cart_des_state[j].x[i] = link_pos_des[link2endeffmap[j]][i];
+      linkQuat(Alink_des[link2endeffmap[j]],&(cart_des_orient[j]));
     }
-  }
 
-  /* the desired quaternian of the endeffector */
-  for (j=1; j<=n_endeffs; ++j) {
-    linkQuat(Alink_des[link2endeffmap[j]],&(cart_des_orient[j]));
   }
 
+  if (flags & KIN_STATE) {
 
-  /* additional link information */
-  linkInformation(joint_state,&base_state,&base_orient,endeff,
-		  joint_cog_mpos,joint_axis_pos,joint_origin_pos,
-		  link_pos,Alink,Adof);
+    /* additional link information */
+    linkInformation(joint_state,&base_state,&base_orient,endeff,
+		    joint_cog_mpos,joint_axis_pos,joint_origin_pos,
+		    link_pos,Alink,Adof);
 
-  /* create the endeffector information */
-  for (i=1; i<=N_CART; ++i) {
+    /* create the endeffector information */
+    for (i=1; i<=N_CART; ++i) {
+      for (j=1; j<=n_endeffs; ++j) {
+	cart_state[j].x[i] = link_pos[link2endeffmap[j]][i];
+      }
+    }
+
+    /* the quaternian of the endeffector */
     for (j=1; j<=n_endeffs; ++j) {
-      cart_state[j].x[i] = link_pos[link2endeffmap[j]][i];
+      linkQuat(Alink[link2endeffmap[j]],&(cart_orient[j]));
     }
-  }
 
-  /* the quaternian of the endeffector */
-  for (j=1; j<=n_endeffs; ++j) {
-    linkQuat(Alink[link2endeffmap[j]],&(cart_orient[j]));
   }
 
   /* the COG position */
-  compute_cog();
+  if (flags & KIN_COG)
+    compute_cog();
 
   /* the jacobian */
-  jacobian(link_pos,joint_origin_pos,joint_axis_pos,J);
-  baseJacobian(link_pos,joint_origin_pos,joint_axis_pos,Jbase);
-
-  jacobian(link_pos_des,joint_origin_pos_des,joint_axis_pos_des,Jdes);
-  baseJacobian(link_pos_des,joint_origin_pos_des,joint_axis_pos_des,Jbasedes);
-
-  /* numerical time derivative of Jacobian */
-  if (!firsttime) {
-    mat_sub(J,last_J,dJdt);
-    mat_mult_scalar(dJdt,(double)task_servo_rate,dJdt);
-    mat_sub(Jbase,last_Jbase,dJbasedt);
-    mat_mult_scalar(dJbasedt,(double)task_servo_rate,dJbasedt);
+  if (flags & KIN_JACOBIAN) {
+    jacobian(link_pos,joint_origin_pos,joint_axis_pos,J);
+    baseJacobian(link_pos,joint_origin_pos,joint_axis_pos,Jbase);
+  }
+
+  if (flags & KIN_DES_JACOBIAN) {
+    jacobian(link_pos_des,joint_origin_pos_des,joint_axis_pos_des,Jdes);
+    baseJacobian(link_pos_des,joint_origin_pos_des,joint_axis_pos_des,Jbasedes);
   }
-  mat_equal(J,last_J);
-  mat_equal(Jbase,last_Jbase);
+
+  /* analytic time derivative of Jacobian */
+  if (flags & KIN_JACOBIAN_DT)
+    jacobianTimeDerivative(link_pos,joint_origin_pos,joint_axis_pos,joint_state,
+			   dJdt,dJbasedt);
 
   /* compute the cartesian velocities and accelerations */
+  if (flags & KIN_CART_VEL) {
+
+    for (j=1; j<=n_endeffs; ++j) {
 
-  for (j=1; j<=n_endeffs; ++j) {
+      for (i=1; i<=N_CART; ++i) {
 
-    for (i=1; i<=N_CART; ++i) {
+	cart_state[j].xd[i]     = 0.0;
+	cart_state[j].xdd[i]    = 0.0;
 
-      cart_state[j].xd[i]     = 0.0;
-      cart_state[j].xdd[i]    = 0.0;
+	cart_orient[j].ad[i]     = 0.0;
+	cart_orient[j].add[i]    = 0.0;
 
-      cart_orient[j].ad[i]     = 0.0;
-      cart_orient[j].add[i]    = 0.0;
+	/* contributations from the joints in the chain of the endeffector */
+	for (k=1; k<=n_endeff_dofs[j]; ++k) {
+	  r = endeff_dofs[j][k];
+	  cart_state[j].xd[i]     += J[(j-1)*6+i][r] * joint_state[r].thd;
+	  cart_orient[j].ad[i]    += J[(j-1)*6+i+3][r] * joint_state[r].thd;
 
-      cart_des_state[j].xd[i] = 0.0;
-      cart_des_orient[j].ad[i] = 0.0;
+	  cart_state[j].xdd[i]    += J[(j-1)*6+i][r] * joint_state[r].thdd + 
+	    dJdt[(j-1)*6+i][r] * joint_state[r].thd;
+	  cart_orient[j].add[i]   += J[(j-1)*6+i+3][r] * joint_state[r].thdd + 
+	    dJdt[(j-1)*6+i+3][r] * joint_state[r].thd;
+	}
+
+	/* contributations from the base */
+	for (r=1; r<=N_CART; ++r) {
+	  cart_state[j].xd[i]     += Jbase[(j-1)*6+i][r] * base_state.xd[r];
+	  cart_orient[j].ad[i]    += Jbase[(j-1)*6+i+3][r] * base_state.xd[r];
 
-      /* contributations from the joints */
-      for (r=1; r<=n_dofs; ++r) {
-	cart_state[j].xd[i]     += J[(j-1)*6+i][r] * joint_state[r].thd;
-	cart_orient[j].ad[i]    += J[(j-1)*6+i+3][r] * joint_state[r].thd;
+	  cart_state[j].xd[i]     += Jbase[(j-1)*6+i][3+r] * base_orient.ad[r];
+	  cart_orient[j].ad[i]    += Jbase[(j-1)*6+i+3][3+r] * base_orient.ad[r];
 
-	cart_des_state[j].xd[i] += Jdes[(j-1)*6+i][r] *joint_des_state[r].thd;
-	cart_des_orient[j].ad[i]+= Jdes[(j-1)*6+i+3][r] * joint_des_state[r].thd;
+	  cart_state[j].xdd[i]    += Jbase[(j-1)*6+i][r] * base_state.xdd[r] + 
+	    dJbasedt[(j-1)*6+i][r] * base_state.xd[r];
+	  cart_orient[j].add[i]   += Jbase[(j-1)*6+i+3][r] * base_state.xdd[r] + 
+	    dJbasedt[(j-1)*6+i+3][r] * base_state.xd[r];
+
+	  cart_state[j].xdd[i]    += Jbase[(j-1)*6+i][3+r] * base_orient.add[r] + 
+	    dJbasedt[(j-1)*6+i][3+r] * base_orient.ad[r];
+	  cart_orient[j].add[i]   += Jbase[(j-1)*6+i+3][3+r] * base_orient.add[r] + 
+	    dJbasedt[(j-1)*6+i+3][3+r] * base_orient.ad[r];
+	}
 
-	cart_state[j].xdd[i]    += J[(j-1)*6+i][r] * joint_state[r].thdd + 
-	  dJdt[(j-1)*6+i][r] * joint_state[r].thd;
-	cart_orient[j].add[i]   += J[(j-1)*6+i+3][r] * joint_state[r].thdd + 
-	  dJdt[(j-1)*6+i+3][r] * joint_state[r].thd;
       }
 
-      /* contributations from the base */
-      for (r=1; r<=N_CART; ++r) {
-	cart_state[j].xd[i]     += Jbase[(j-1)*6+i][r] * base_state.xd[r];
-	cart_orient[j].ad[i]    += Jbase[(j-1)*6+i+3][r] * base_state.xd[r];
+      /* compute quaternion derivatives */
+      quatDerivatives(&(cart_orient[j]));
+
+    }
+
+  }
+
+  if (flags & KIN_DES_CART_VEL) {
+
+    for (j=1; j<=n_endeffs; ++j) {
 
-	cart_state[j].xd[i]     += Jbase[(j-1)*6+i][3+r] * base_orient.ad[r];
-	cart_orient[j].ad[i]    += Jbase[(j-1)*6+i+3][3+r] * base_orient.ad[r];
+      for (i=1; i<=N_CART; ++i) {
 
-	cart_des_state[j].xd[i]     += Jbasedes[(j-1)*6+i][r] * base_state.xd[r];
-	cart_des_orient[j].ad[i]    += Jbasedes[(j-1)*6+i+3][r] * base_state.xd[r];
+	cart_des_state[j].xd[i] = 0.0;
+	cart_des_orient[j].ad[i] = 0.0;
 
-	cart_des_state[j].xd[i]     += Jbasedes[(j-1)*6+i][3+r] * base_orient.ad[r];
-	cart_des_orient[j].ad[i]    += Jbasedes[(j-1)*6+i+3][3+r] * base_orient.ad[r];
+	/* contributations from the joints in the chain of the endeffector */
+	for (k=1; k<=n_endeff_dofs[j]; ++k) {
+	  r = endeff_dofs[j][k];
+	  cart_des_state[j].xd[i] += Jdes[(j-1)*6+i][r] *joint_des_state[r].thd;
+	  cart_des_orient[j].ad[i]+= Jdes[(j-1)*6+i+3][r] * joint_des_state[r].thd;
+	}
 
-	cart_state[j].xdd[i]    += Jbase[(j-1)*6+i][r] * base_state.xdd[r] + 
-	  dJbasedt[(j-1)*6+i][r] * base_state.xd[r];
-	cart_orient[j].add[i]   += Jbase[(j-1)*6+i+3][r] * base_state.xdd[r] + 
-	  dJbasedt[(j-1)*6+i+3][r] * base_state.xd[r];
+	/* contributations from the base */
+	for (r=1; r<=N_CART; ++r) {
+	  cart_des_state[j].xd[i]     += Jbasedes[(j-1)*6+i][r] * base_state.xd[r];
+	  cart_des_orient[j].ad[i]    += Jbasedes[(j-1)*6+i+3][r] * base_state.xd[r];
+
+	  cart_des_state[j].xd[i]     += Jbasedes[(j-1)*6+i][3+r] * base_orient.ad[r];
+	  cart_des_orient[j].ad[i]    += Jbasedes[(j-1)*6+i+3][3+r] * base_orient.ad[r];
+	}
 
-	cart_state[j].xdd[i]    += Jbase[(j-1)*6+i][3+r] * base_orient.add[r] + 
-	  dJbasedt[(j-1)*6+i][3+r] * base_orient.ad[r];
-	cart_orient[j].add[i]   += Jbase[(j-1)*6+i+3][3+r] * base_orient.add[r] + 
-	  dJbasedt[(j-1)*6+i+3][3+r] * base_orient.ad[r];
       }
 
-    }
+      /* compute quaternion derivatives */
+      quatDerivatives(&(cart_des_orient[j]));
+      for (r=1; r<=N_QUAT; ++r)
+	cart_des_orient[j].qdd[r] = 0.0; // we don't have dJdes_dt so far
 
-    /* compute quaternion derivatives */
-    quatDerivatives(&(cart_orient[j]));
-    quatDerivatives(&(cart_des_orient[j]));
-    for (r=1; r<=N_QUAT; ++r)
-      cart_des_orient[j].qdd[r] = 0.0; // we don't have dJdes_dt so far
+    }
 
   }
 
-  /* reset first time flag */
-  firsttime = FALSE;
+  kin_valid |= flags;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  lazyKinematics
+\date  Oct 2026
+   
+\remarks 
+
+       switches lazy computation of the kinematic variables on or off. 
+       With lazy kinematics, the task servo only computes the endeffector
+       positions for the vision servo, and everything else needs to be 
+       requested with update_kinematics(). This saves the computation of
+       all Jacobians for tasks that only use joint space control.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     flag : TRUE/FALSE for lazy kinematics
+
+ ******************************************************************************/
+void
+lazyKinematics(int flag)
+{
+
+  lazy_kinematics = flag;
 
 }
 
@@ -1127,6 +1232,8 @@ send_cartesian(void)
 
   } else {
 
+    update_kinematics(KIN_STATE);
+
     cSL_Cstate(cart_state,sm_cart_states_data,n_endeffs,DOUBLE2FLOAT);
 
     memcpy((void *)(&sm_cart_states->state[1]),(const void*)(&sm_cart_states_data[1]),
@@ -1565,6 +1672,10 @@ int
 sendUserGraphics(char *name, void *buf, int n_bytes)
 {
   int i,j;
+
+  // no graphics process to read the data
+  if (no_graphics_flag)
+    return TRUE;
   
   // send the user graphics data
   if (semTake(sm_user_graphics_sem,ns2ticks(TIME_OUT_NS)) == ERROR) {
@@ -1777,14 +1888,18 @@ checkForMessages(void)
       } data;
      
       memcpy(&data,sm_task_message->buf+sm_task_message->moff[i],sizeof(data));
-      
+
+      // only the local copy is updated, as changeObjPosByName() would send
+      // the update back to the other servos
       ObjectPtr ptr = getObjPtrByName(data.obj_name);
       if (ptr != NULL) { 
-        for (i=1;i<=N_CART; ++i) {
-          ptr->trans[i]=data.pos[i];
-          ptr->rot[i]=data.rot[i];
-        }
+	for (j=1; j<=N_CART; ++j) {
+	  ptr->trans[j]=data.pos[j];
+	  ptr->rot[j]=data.rot[j];
+	}
+	updateObjectGeometry(ptr);
       }
+
     }
 
   }
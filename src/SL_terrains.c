@@ -25,9 +25,13 @@
 #include "math.h"
 #include "string.h"
 #include "strings.h"
+#include "limits.h"
 #include "pthread.h"
 #ifdef UNIX
 #include "sys/stat.h"
+#include "sys/mman.h"
+#include "fcntl.h"
+#include "unistd.h"
 #endif
 #ifdef VX
 #include "sys/stat.h"
@@ -42,14 +46,201 @@
 
 #define EMPTY_TERRAIN -9999.0
 #define RADIUS_FZ     7
+#define TERRAIN_TILE_SIZE      32 // cells per tile side for caching terrain info
+#define N_TERRAIN_THREADS      4  // default number of threads for caching
+
+// caching states of a tile
+#define TILE_PENDING 0
+#define TILE_BUSY    1
+#define TILE_DONE    2
+
+// cached flag of a cell while its data is written (FALSE and TRUE otherwise)
+#define CELL_BUSY    2
+
+// codes of the 16 bit layers of compact boards
+#define TERRAIN_QUANT_MAX    0xFFFE // largest code of a value
+#define TERRAIN_QUANT_EMPTY  0xFFFF // code of EMPTY_TERRAIN
+
+// the summed-area tables are kept in long double, as the sums over a regression
+// neighborhood are differences of large and nearly equal table entries on 
+// large boards
+typedef struct TerrainSAT { //!< summed-area tables for the plane regression
+  int       rad_x;       //!< regression radius in x (multiple of down)
+  int       rad_y;       //!< regression radius in y (multiple of down)
+  int       down;        //!< down sampling of the regression
+  int       off;         //!< table index of grid index 1 minus 1
+  int       n_x;         //!< size of the tables in x
+  int       n_y;         //!< size of the tables in y
+  double    z_ref;       //!< reference height subtracted from all z
+  long double *s_z;      //!< table of z
+  long double *s_xz;     //!< table of x table index times z
+  long double *s_yz;     //!< table of y table index times z
+  long double *s_zz;     //!< table of z squared
+} TerrainSAT;
+
+typedef struct TerrainGrid { //!< a memory mapped terrain grid file
+  void     *base;        //!< start of the mapping
+  size_t    size;        //!< size of the mapping
+  TerrainGridHeader *h;  //!< the header of the file
+} TerrainGrid;
+
+typedef struct TerrainIndex { //!< uniform grid over the footprints of the boards
+  double    cell;        //!< size of a grid cell
+  int       n_buckets;   //!< number of hash buckets (power of 2)
+  int      *start;       //!< first entry of each bucket in ids (n_buckets+1 entries)
+  int      *ids;         //!< terrain array indices, ascending in each bucket
+} TerrainIndex;
+
+typedef struct TerrainStream { //!< a tiled terrain file that is streamed
+  int       fd;          //!< file descriptor of the file
+  TerrainTilesHeader h;  //!< the header of the file
+  int       n_tx;        //!< number of tiles in x direction
+  int       n_ty;        //!< number of tiles in y direction
+  int       c_n_tx;      //!< number of tiles in x direction for contacts
+  int       c_n_ty;      //!< number of tiles in y direction for contacts
+  int      *slot;        //!< slot in the tile cache of each tile (-1: not loaded)
+  int      *c_slot;      //!< slot in the tile cache of each contact tile
+} TerrainStream;
+
+typedef struct {         //!< a slot of the tile cache of streamed terrains
+  int       ID;          //!< terrain array index (0 for an unused slot)
+  int       cflag;       //!< TRUE for a tile of the contact grid
+  int       tile;        //!< index of the tile
+  int       prev;        //!< previous slot in the LRU list (more recently used)
+  int       next;        //!< next slot in the LRU list (less recently used)
+  int       pins;        //!< number of contact queries reading the tile
+  float    *data;        //!< the layers of the tile
+} TerrainTileSlot;
+
+typedef struct {         //!< a query point of a batch with its bucket in the spatial index
+  int       bucket;      //!< bucket of the query point
+  int       q;           //!< index of the query point
+} TerrainQuery;
+
+typedef struct {         //!< state of a query of a batch while the boards are visited
+  int       m;           //!< x index of the query point in the current board
+  int       n;           //!< y index of the query point in the current board
+  int       win;         //!< terrain array index of the board with the height (0: none)
+  int       win_m;       //!< x index of the query point in this board
+  int       win_n;       //!< y index of the query point in this board
+  int       found;       //!< TRUE if a board covers the query point
+  int       in_padding;  //!< TRUE if the height is in the padding of the board
+  double    z;           //!< height of the query point
+  double    no_go;       //!< no_go info of the query point
+} TerrainQueryState;
+
+typedef struct {         //!< a part of the sorted queries of a batch for a thread
+  double   *x;           //!< x positions of the query points
+  double   *y;           //!< y positions of the query points
+  int       z_only;      //!< TRUE if no terrain info is requested
+  TerrainIndex *idx;     //!< the spatial index used for all queries
+  TerrainQuery *queries; //!< the queries sorted by bucket
+  TerrainInfoBatch *tinfo; //!< the results
+  int       start;       //!< first sorted query of the part
+  int       end;         //!< last sorted query of the part plus one
+  int       n_found;     //!< number of query points with data found in terrains
+} TerrainQueryBatch;
+
+typedef struct {         //!< 16 bit quantization of a layer of a compact board
+  double    off;         //!< value of code 0
+  double    scale;       //!< value step per code
+} TerrainQuant;
+
+typedef struct {         //!< a no_go layer of a compact board
+  unsigned int   *bits;  //!< bitset of the cells if all values are 0 or 1 (else NULL)
+  unsigned short *v;     //!< quantized values otherwise
+  TerrainQuant    q;     //!< quantization of v
+} TerrainNoGoLayer;
+
+typedef struct {         //!< a cell of the terrain grid of a compact board
+  unsigned short z;      //!< height relative to the board origin
+  unsigned short pz;     //!< predicted height relative to the board origin
+  unsigned short fz;     //!< foot placement height relative to the board origin
+  unsigned short n_x;    //!< x component of normal
+  unsigned short n_y;    //!< y component of normal
+  unsigned short n_nMSE; //!< nMSE of normal
+} TerrainCompactCell;
+
+typedef struct {         //!< a cell of the contact grid of a compact board
+  unsigned short c_z;    //!< height in local coordinates (not used in the padding)
+  unsigned short cn_x;   //!< x component of normal for contact
+  unsigned short cn_y;   //!< y component of normal for contact
+} TerrainCompactCCell;
+
+typedef struct TerrainCompact { //!< the compact layers of a board
+  TerrainCompactCell  *cells;   //!< cells of the terrain grid (nx*ny)
+  TerrainCompactCCell *c_cells; //!< cells of the contact grid (c_nx*c_ny)
+  TerrainQuant  q_z;     //!< quantization of z, pz, and fz
+  TerrainQuant  q_n;     //!< quantization of the x and y components of normals
+  TerrainQuant  q_nMSE;  //!< quantization of n_nMSE
+  TerrainQuant  q_cz;    //!< quantization of c_z
+  TerrainNoGoLayer no_go;   //!< no_go of the terrain grid
+  TerrainNoGoLayer c_no_go; //!< no_go of the contact grid
+  double    c_z0;        //!< c_z of the padding is c_z0 + c_zx*(m-1) + c_zy*(n-1)
+  double    c_zx;        //!< slope of c_z of the padding in x
+  double    c_zy;        //!< slope of c_z of the padding in y
+} TerrainCompact;
+
+typedef struct {         //!< a tile to be cached by the caching threads
+  int       ID;          //!< terrain array index
+  int       cflag;       //!< TRUE for a tile of the contact grid
+  int       tile;        //!< index of the tile
+} TerrainTileJob;
+
+// the terrain array index of a handle from getContactTerrainHandle()
+#define TERRAIN_HANDLE_SLOTS (MAX_TERRAINS+1)
+
+// the terrain with a given array index (between 1 and n_terrains)
+#define TERRAIN_PTR(ID) \
+  (&(terrain_blocks[((ID)-1)/TERRAIN_BLOCK_SIZE][((ID)-1)%TERRAIN_BLOCK_SIZE]))
+
+// boards without float layers, whose terrain info is precomputed and which
+// cannot be modified
+#define TERRAIN_PRECOMPUTED(t) ((t)->stream != NULL || (t)->compact != NULL)
+
+// the bucket of a cell of the spatial index (n is a power of 2)
+#define TERRAIN_INDEX_HASH(ix,iy,n) \
+  ((((unsigned int)(ix))*73856093u ^ ((unsigned int)(iy))*19349663u) & ((n)-1))
 
 // variable declarations
 // local variables
-Terrain terrains[MAX_TERRAINS+1];
+
+// the terrain boards are allocated in blocks, such that pointers to a board 
+// remain valid when more boards are added
+static Terrain      *terrain_blocks[MAX_TERRAIN_BLOCKS];
+static int           n_terrains = 0;        // number of allocated terrain slots
+static TerrainIndex *terrain_index = NULL;  // spatial index over the active boards
 static double  ground_level_z = 0.0;
 
-static pthread_t       cthread_terrain;                          // thread for caching terrain info
-static pthread_mutex_t mutex_terrain= PTHREAD_MUTEX_INITIALIZER; // for a safe thread
+static int     use_sat_regression = TRUE; // summed-area tables for the regression
+static int     use_compact_layers = FALSE; // compact new boards in memory
+
+// the terrain info is cached in tiles by a pool of threads. The tiles are 
+// claimed with an atomic compare-and-swap of their state, such that a thread 
+// waiting for a region can process pending tiles of this region itself.
+static pthread_mutex_t mutex_regression = PTHREAD_MUTEX_INITIALIZER; // for the regression cache
+static pthread_mutex_t mutex_cache = PTHREAD_MUTEX_INITIALIZER;      // for the caching jobs
+static pthread_cond_t  cond_cache = PTHREAD_COND_INITIALIZER;        // signals a finished tile
+static TerrainTileJob *cache_jobs = NULL;     // tiles to be cached
+static int             n_cache_jobs = 0;      // number of tiles to be cached
+static int             max_cache_jobs = 0;    // allocated size of cache_jobs
+static int             next_cache_job = 0;    // next tile to be claimed by a thread
+static int             n_cache_threads = 0;   // number of running caching threads
+static int             n_busy_tiles = 0;      // number of tiles processed by the threads
+static int             cache_paused = FALSE;  // threads do not claim tiles while paused
+
+// the tiles of streamed terrains are kept in a cache with a memory budget, 
+// and the least recently used tile is replaced if the budget is exhausted.
+// Contact queries do not take mutex_stream: they pin a loaded tile with an
+// atomic counter of its slot, and a pinned tile is not replaced.
+static pthread_mutex_t  mutex_stream = PTHREAD_MUTEX_INITIALIZER; // for the tile cache
+static TerrainTileSlot *stream_slots = NULL;   // the slots of the tile cache
+static int              n_stream_slots = 0;    // number of allocated slots
+static int              max_stream_slots = 0;  // number of slots within the budget
+static int              n_stream_loaded = 0;   // number of slots with a tile
+static int              stream_lru_first = -1; // most recently used slot
+static int              stream_lru_last  = -1; // least recently used slot
+static double           stream_budget_mb = TERRAIN_TILE_CACHE_MB;
 
 
 // global variables
@@ -65,8 +256,106 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
 static int
 getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, 
 		       TerrainInfo *tinfo);
+static void
+getTerrainCellInfo(int ID, int m, int n, float *cell, TerrainInfo *tinfo);
+static void *
+processTerrainQueries(void *dptr);
+static int
+compareTerrainQueries(const void *a, const void *b);
+static int
+setTerrainInfoSwitched(int ID, int tID, char *tfname, double *pos, double *orient,
+		       int reg_rad, int reg_down, int reg_crad, int stream_flag);
 static void *
 cacheTerrainInfoThread(void *dptr);
+static void
+cacheTerrainCell(int ID, int i, int j, TerrainInfo *tinfo);
+static void
+cacheContactTerrainCell(int ID, int i, int j, double *norm);
+static void
+processTerrainTile(int ID, int cflag, int tile);
+static void
+waitForTerrainTile(int ID, int cflag, int tile);
+static TerrainSAT *
+getTerrainSAT(int ID, int cflag);
+static TerrainSAT *
+buildTerrainSAT(int ID, int cflag);
+static void
+freeTerrainSAT(TerrainSAT **sat);
+static int
+computeTerrainNormalSAT(int ID, int ix, int iy, int cflag, TerrainInfo *tinfo);
+
+static int
+checkTerrainGridFile(char *fname, char *gname);
+static int
+mapTerrainGrid(char *gname, Terrain *t);
+static int
+writeTerrainGrid(char *gname, int ID, fMatrix *layers);
+static void
+applyTerrainGridLayers(int ID);
+static void
+freeTerrainBoard(int ID);
+static fMatrix
+getTerrainGridLayer(TerrainGrid *g, int layer);
+
+static Terrain *
+getTerrainByHandle(int h);
+static void
+allocTerrainSlots(int n);
+static void
+updateTerrainBoundingBox(void);
+static void
+updateTerrainIndex(void);
+static TerrainIndex *
+buildTerrainIndex(void);
+static void
+freeTerrainIndex(TerrainIndex *idx);
+static void
+getTerrainIndexRange(Terrain *t, double cell, int *sx, int *ex, int *sy, int *ey);
+static int
+getTerrainIndexBucket(TerrainIndex *idx, double x, double y);
+static void
+pauseTerrainCache(void);
+static void
+resumeTerrainCache(void);
+
+static int
+openTerrainTiles(char *fname, int ID, double *pos, double *orient,
+		 int reg_rad, int reg_down, int reg_crad);
+static int
+writeTerrainTiles(char *fname, int ID);
+static void
+closeTerrainTiles(int ID);
+static int
+getTerrainStreamSlot(int ID, int cflag, int tile);
+static int
+readTerrainStreamCell(int ID, int cflag, int m, int n, float *v);
+static int
+readTerrainStreamCellPinned(int ID, int m, int n, float *v);
+static void
+loadTerrainStreamTiles(int ID, int cflag, int sx, int ex, int sy, int ey);
+static int
+releaseTerrainStreamSlot(int k);
+static int
+readTerrainCell(int ID, int cflag, int m, int n, float *v);
+
+static void
+readTerrainCompactCell(int ID, int cflag, int m, int n, float *v);
+static void
+setTerrainQuant(TerrainQuant *q, double min, double max);
+static unsigned short
+quantizeTerrain(TerrainQuant *q, double v);
+static double
+dequantizeTerrain(TerrainQuant *q, unsigned short c);
+static void
+compactTerrainNoGo(fMatrix no_go, int nx, int ny, TerrainNoGoLayer *l);
+static double
+getTerrainNoGo(TerrainNoGoLayer *l, int k);
+static void
+freeTerrainCompact(int ID);
+static void
+freeTerrainLayers(int ID);
+static void
+dropTerrainCacheJobs(int ID);
 
 static double
 computeMedian(double *v, int n_v) ;
@@ -110,21 +399,36 @@ readTerrainBoard(char *fname, int ID)
   Terrain    *t;
   TerrainInfo tinfo;
   int     nx,ny;
+  int     gen;
+  char    gname[200];
 
   // check for validity of terrain index
   if (ID < 1 || ID > MAX_TERRAINS) {
     printf("Terrain %d out of range of terrains from 1-%d\n",ID,MAX_TERRAINS);
     return FALSE;
   }
+  allocTerrainSlots(ID);
 
   // use a simpler variable for convenience
-  t = &(terrains[ID]);
+  t = TERRAIN_PTR(ID);
 
   // initialize position and orientation of board
+  gen = t->gen;
   bzero((void *)t,sizeof(Terrain));
+  t->gen = gen;
   t->ID = 0;
   t->orient.q[_Q0_] = 1.0;
 
+  // use the binary terrain grid file if it is up to date
+  sprintf(gname,"%s%s",fname,TERRAIN_GRID_EXT);
+  if (checkTerrainGridFile(fname,gname) && mapTerrainGrid(gname,t)) {
+    printf("\nMapped Terrain Board >%s< with %d x-values and %d y-values\n",
+	   gname,t->nx_local,t->ny_local);
+    printf("and %f[m] dx and %f[m] dy grid size\n",t->dx,t->dy);
+    t->status = FALSE;
+    return TRUE;
+  }
+
   // read the terrain file
   read_terrain_file(fname,&temp,&nx,&ny,&min_x,&max_x,&min_y,&max_y,FALSE,&count);
   t->nx_local = nx;
@@ -237,6 +541,9 @@ readTerrainBoard(char *fname, int ID)
   my_free_matrix(temp_z,1,t->nx_local,1,t->ny_local);
   my_free_matrix(temp_no_go,1,t->nx_local,1,t->ny_local);
 
+  // write the binary terrain grid file for quicker future processing
+  writeTerrainGrid(gname,ID,NULL);
+
   // the status is only true after the position and orientation of the
   // board are filled in with setTerrainInfo()
   t->status = FALSE;
@@ -274,9 +581,45 @@ int
 setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
 	       int reg_rad, int reg_down, int reg_crad)
 {
+  return setTerrainInfoSwitched(ID,tID,tfname,pos,orient,reg_rad,reg_down,reg_crad,TRUE);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  setTerrainInfoSwitched
+\date  Oct 2026
+   
+\remarks 
+
+        same as setTerrainInfo(), but streaming of the board from a tiled 
+        terrain file can be switched off. A board is streamed if the tiled
+        terrain file is up to date and was computed with the same regression
+        parameters, and if the board is not rotated. Otherwise, the board is
+        kept in compact layers if the terrain_compact_layers parameter is 
+        set, unless streaming is switched off.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     tID     : identifier number of the terrain board
+ \param[in]     tfname  : file name of the terrain *.asc file
+ \param[in]     pos     : 3D position vector of terrain origin
+ \param[in]     orient  : 4D unit quaternion vector of terrain origin.
+ \param[in]     reg_rad : radius of points used in regression of normal
+ \param[in]     reg_down: down sampling for normal regression
+ \param[in]     reg_crad: radius of points used to comopute contact normal 
+ \param[in]     stream_flag: TRUE if the board can be streamed or compacted
+
+ ******************************************************************************/
+static int
+setTerrainInfoSwitched(int ID, int tID, char *tfname, double *pos, double *orient,
+		       int reg_rad, int reg_down, int reg_crad, int stream_flag)
+{
 
   int i,j,n,m,r;
   char string[100];
+  char tname[200];
   Matrix X,Y,Z;
   Matrix R;
   Vector v,vv;
@@ -297,6 +640,13 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
       terrain_bounding_box_max[i] = -1.e10;
       terrain_bounding_box_min[i] =  1.e10;
     }
+    if (read_parameter_pool_int(config_files[PARAMETERPOOL],"terrain_sat_regression",&i))
+      use_sat_regression = (i != 0);
+    if (read_parameter_pool_int(config_files[PARAMETERPOOL],"terrain_tile_cache_mb",&i) &&
+	i > 0)
+      setTerrainTileCacheSize((double) i);
+    if (read_parameter_pool_int(config_files[PARAMETERPOOL],"terrain_compact_layers",&i))
+      use_compact_layers = (i != 0);
   }
 
   // check for validity of terrain index
@@ -308,13 +658,31 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
   if (!tID)
     return FALSE;
 
-  t = &(terrains[ID]);
+  allocTerrainSlots(ID);
+
+  t = TERRAIN_PTR(ID);
 
   if (t->status)
     return TRUE;
 
-  // read the terrain board information
+  // stream the board from a tiled terrain file if possible
   sprintf(string,"%s%s",TERRAINS,tfname);
+  sprintf(tname,"%s%s",string,TERRAIN_TILES_EXT);
+  if (stream_flag && checkTerrainGridFile(string,tname) &&
+      openTerrainTiles(tname,ID,pos,orient,reg_rad,reg_down,reg_crad)) {
+    t->ID = tID;
+    strcpy(t->tfname,tfname);
+    t->status = TRUE;
+    updateTerrainBoundingBox();
+    updateTerrainIndex();
+    printf("Terrain Board %d with ID=%d is streamed from %s at: x=% 5.3f  y=% 5.3f  z=% 5.3f\n",
+	   ID,tID,tname,pos[_X_],pos[_Y_],pos[_Z_]);
+    printf("     with reg_rad=%d reg_down=%d reg_crad=%d\n\n",t->reg_rad,
+	   t->reg_down,t->reg_crad);
+    return TRUE;
+  }
+
+  // read the terrain board information
   if (!readTerrainBoard(string, ID)) {
     printf("Could not initialize terrain board #%d from %s\n",ID,string);
     return FALSE;
@@ -476,6 +844,15 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
   t->cn_z    = my_fmatrix(1,t->c_nx,1,t->c_ny);
   t->ccached = my_imatrix(1,t->c_nx,1,t->c_ny);
 
+  // the tiles for caching the terrain info
+  t->n_tx   = (t->nx+TERRAIN_TILE_SIZE-1)/TERRAIN_TILE_SIZE;
+  t->n_ty   = (t->ny+TERRAIN_TILE_SIZE-1)/TERRAIN_TILE_SIZE;
+  t->c_n_tx = (t->c_nx+TERRAIN_TILE_SIZE-1)/TERRAIN_TILE_SIZE;
+  t->c_n_ty = (t->c_ny+TERRAIN_TILE_SIZE-1)/TERRAIN_TILE_SIZE;
+  t->tiles  = (int *)my_calloc(t->n_tx*t->n_ty,sizeof(int),MY_STOP);
+  t->ctiles = (int *)my_calloc(t->c_n_tx*t->c_n_ty,sizeof(int),MY_STOP);
+  t->n_tiles_done = 0;
+
   for (i=1; i<=t->c_nx; ++i)
     for (j=1; j<=t->c_ny; ++j) {
 
@@ -514,6 +891,13 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
 
     }
 
+  // the max height for contact checking
+  t->c_max_z = -1.e10;
+  for (i=1; i<=t->c_nx; ++i)
+    for (j=1; j<=t->c_ny; ++j)
+      if (t->c_z[i][j] > t->c_max_z)
+	t->c_max_z = t->c_z[i][j];
+
   // initialize t->z such that we can detect uninitialized z values
   for (i=1; i<=t->nx; ++i)
     for (j=1; j<=t->ny; ++j)
@@ -596,28 +980,18 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
 	t->no_go[i][j] = temp_no_go[i][j];
       }
 
+  // use precomputed terrain info of a terrain grid file
+  if (t->grid != NULL)
+    applyTerrainGridLayers(ID);
+
   // set status of terrain to TRUE
   t->status = TRUE;
 
   // update the bounding box
-  if (t->xorg < terrain_bounding_box_min[_X_])
-    terrain_bounding_box_min[_X_] = t->xorg;
-
-  if (t->xorg+(t->nx-1)*t->dx > terrain_bounding_box_max[_X_])
-    terrain_bounding_box_max[_X_] = t->xorg+(t->nx-1)*t->dx;
-
-  if (t->yorg < terrain_bounding_box_min[_Y_])
-    terrain_bounding_box_min[_Y_] = t->yorg;
-
-  if (t->yorg+(t->ny-1)*t->dy > terrain_bounding_box_max[_Y_])
-    terrain_bounding_box_max[_Y_] = t->yorg+(t->ny-1)*t->dy;
-
-  if (t->min_z < terrain_bounding_box_min[_Z_])
-    terrain_bounding_box_min[_Z_] = t->min_z;
-
-  if (t->max_z > terrain_bounding_box_max[_Z_])
-    terrain_bounding_box_max[_Z_] = t->max_z;
+  updateTerrainBoundingBox();
 
+  // make the board visible to queries in world coordinates
+  updateTerrainIndex();
 
   // free memory
   my_free_matrix(X,1,t->nx_local,1,t->ny_local);
@@ -635,6 +1009,10 @@ setTerrainInfo(int ID, int tID, char *tfname, double *pos, double *orient,
   printf("     with reg_rad=%d reg_down=%d reg_crad=%d\n\n",t->reg_rad,
 	 t->reg_down,t->reg_crad);
 
+  // keep the board in compact layers if requested
+  if (stream_flag && use_compact_layers)
+    compactTerrainBoard(ID);
+
   return TRUE;
 
 }
@@ -719,12 +1097,16 @@ getTerrainInfoZOnly(double x, double y, TerrainInfo *tinfo)
 static int
 getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *tinfo)
 {
-  int           i,j,m,n,r;
+  int           i,j,k,m,n,r;
+  int           ks,ke;
   Terrain      *t;
+  TerrainIndex *idx;
   double        norm[N_CART+1];
   double        nnorm[N_CART+1];
   double        alpha;
   double        aux;
+  double        z,no_go;
+  float         cell[TERRAIN_TILE_N_LAYERS];
   int           found_flag = FALSE;
   int           in_padding_flag = TRUE; // indicates whether the max z point was in padding
 
@@ -741,13 +1123,22 @@ getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *
   tinfo->ID         = 0;
   tinfo->in_padding = FALSE;
 
-  // loop over all terrain boards and try to find whether query point is
-  // covered by the given board
+  // loop over all terrain boards that may cover the query point according 
+  // to the spatial index, and try to find whether query point is covered 
+  // by the given board
+  idx = __atomic_load_n(&terrain_index,__ATOMIC_ACQUIRE);
+  if (idx != NULL) {
+    k  = getTerrainIndexBucket(idx,x,y);
+    ks = idx->start[k];
+    ke = idx->start[k+1];
+  } else
+    ks = ke = 0;
 
-  for (i=1; i<=MAX_TERRAINS; ++i) {
+  for (k=ks; k<ke; ++k) {
 
     // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+    i = idx->ids[k];
+    t = TERRAIN_PTR(i);
 
     if (!t->status)
       continue;
@@ -761,6 +1152,17 @@ getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *
       
       if (no_pad && (m <= t->padx || m > t->nx-t->padx || n <= t->pady || n > t->ny-t->pady))
 	continue;
+
+      // the cell of a streamed or compact board is read with all layers
+      if (TERRAIN_PRECOMPUTED(t)) {
+	if (!readTerrainCell(i, FALSE, m, n, cell))
+	  continue;
+	z     = (cell[TT_Z] == EMPTY_TERRAIN) ? EMPTY_TERRAIN : cell[TT_Z] + t->pos.x[_Z_];
+	no_go = cell[TT_NO_GO];
+      } else {
+	z     = t->z[m][n];
+	no_go = t->no_go[m][n];
+      }
       
       // note that we found a terrain board for this data point
       found_flag = TRUE;
@@ -769,17 +1171,17 @@ getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *
       // padding only serves to smoothly connect terrain boards. Note that the ground_level is
       // intialized as in_padding_flag=TRUE to simplify the logic below
 
-      if (t->z[m][n] > tinfo->z) { 
+      if (z > tinfo->z) { 
 	if (m <= t->padx || m > t->nx-t->padx || n <= t->pady || n > t->ny-t->pady) { // in padding
 	  if (in_padding_flag) {
-	    tinfo->z = t->z[m][n];
-	    tinfo->no_go = t->no_go[m][n];
+	    tinfo->z = z;
+	    tinfo->no_go = no_go;
 	    tinfo->in_padding = TRUE;
 	  } else
 	    continue; // data points found outside of padding have priority as padding is just a fudge
 	} else { // not in padding
-	  tinfo->z = t->z[m][n];
-	  tinfo->no_go = t->no_go[m][n];
+	  tinfo->z = z;
+	  tinfo->no_go = no_go;
 	  in_padding_flag = FALSE;
 	  tinfo->in_padding = FALSE;
 	}	    
@@ -788,8 +1190,8 @@ getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *
 	  if (m <= t->padx || m > t->nx-t->padx || n <= t->pady || n > t->ny-t->pady) { // in padding
 	    continue;
 	  } else {
-	    tinfo->z = t->z[m][n];
-	    tinfo->no_go = t->no_go[m][n];
+	    tinfo->z = z;
+	    tinfo->no_go = no_go;
 	    in_padding_flag = FALSE;
 	    tinfo->in_padding = FALSE;
 	  }
@@ -798,57 +1200,395 @@ getTerrainInfoSwitched(double x, double y, int z_only, int no_pad, TerrainInfo *
       }
 
       // terrain info data
-      if (!z_only) {
+      if (!z_only)
+	getTerrainCellInfo(i, m, n, cell, tinfo);
+
+      tinfo->ID = t->ID;
 
-	if (t->cached[m][n]) {
+    } // end in valid terrain area
 
-	  tinfo->n_nMSE = t->n_nMSE[m][n];
-	  tinfo->n[_X_] = t->n_x[m][n];
-	  tinfo->n[_Y_] = t->n_y[m][n];
-	  tinfo->n[_Z_] = t->n_z[m][n];
-	  tinfo->pz     = t->pz[m][n];
-	  tinfo->fz     = t->fz[m][n];
+  }
 
-	} else {
+  if (!found_flag) {
+    tinfo->z      = ground_level_z;
+    tinfo->pz     = ground_level_z;
+    tinfo->fz     = ground_level_z;
+  }
 
-	  pthread_mutex_lock( &mutex_terrain );
 
-	  computeTerrainNormal(i, m, n, t->reg_rad, t->reg_rad, t->reg_down, 
-			       FALSE, TRUE,tinfo);
-	  t->fz[m][n]  = tinfo->fz;
+  return found_flag;
+}
 
-	  computeTerrainNormal(i, m, n, t->reg_rad, t->reg_rad, t->reg_down, 
-			       FALSE, FALSE,tinfo);
-	  t->n_x[m][n] = tinfo->n[_X_];
-	  t->n_y[m][n] = tinfo->n[_Y_];
-	  t->n_z[m][n] = tinfo->n[_Z_];
-	  t->pz[m][n]  = tinfo->pz;
-	  
-	  t->cached[m][n] = TRUE;
-	  pthread_mutex_unlock( &mutex_terrain );
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainCellInfo
+\date  Oct 2026
+   
+\remarks 
+
+        returns the terrain info of a cell of a terrain board, i.e., the
+        normal, its nMSE, the slope, and the predicted and foot placement
+        heights. The info is computed if the cell is not cached yet.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     m       : x index of the cell
+ \param[in]     n       : y index of the cell
+ \param[in]     cell    : the layers of the cell for a streamed or compact board
+ \param[out]    tinfo   : the terrain info structure
+
+ ******************************************************************************/
+static void
+getTerrainCellInfo(int ID, int m, int n, float *cell, TerrainInfo *tinfo)
+{
+  Terrain *t = TERRAIN_PTR(ID);
+
+  if (TERRAIN_PRECOMPUTED(t)) {
+
+    tinfo->n_nMSE = cell[TT_N_NMSE];
+    tinfo->n[_X_] = cell[TT_N_X];
+    tinfo->n[_Y_] = cell[TT_N_Y];
+    tinfo->n[_Z_] = cell[TT_N_Z];
+    tinfo->pz     = (cell[TT_PZ] == EMPTY_TERRAIN) ? EMPTY_TERRAIN : cell[TT_PZ] + t->pos.x[_Z_];
+    tinfo->fz     = (cell[TT_FZ] == EMPTY_TERRAIN) ? EMPTY_TERRAIN : cell[TT_FZ] + t->pos.x[_Z_];
+
+  } else if (__atomic_load_n(&(t->cached[m][n]),__ATOMIC_ACQUIRE) == TRUE) {
+
+    tinfo->n_nMSE = t->n_nMSE[m][n];
+    tinfo->n[_X_] = t->n_x[m][n];
+    tinfo->n[_Y_] = t->n_y[m][n];
+    tinfo->n[_Z_] = t->n_z[m][n];
+    tinfo->pz     = t->pz[m][n];
+    tinfo->fz     = t->fz[m][n];
+
+  } else {
+
+    cacheTerrainCell(ID, m, n, tinfo);
+
+  }
+
+  tinfo->slope  = fabs(acos(tinfo->n[_Z_]));
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainInfoBatch
+\date  Oct 2026
+   
+\remarks 
+
+        Returns the terrain info for a batch of query points, with the same
+        results as getTerrainInfo() for every point. The queries are sorted
+        by their bucket in the spatial index, such that the boards of a 
+        bucket are visited once for all its queries, and the terrain info is
+        only computed for the board that provides the final height of a 
+        point. The sorted queries can be split over several threads. If none
+        of pz, fz, n_x, n_y, n_z, n_nMSE, and slope is requested, only the 
+        heights are looked up as in getTerrainInfoZOnly().
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     n_points : number of query points
+ \param[in]     x        : x positions of query points (1 to n_points)
+ \param[in]     y        : y positions of query points (1 to n_points)
+ \param[in]     n_threads: number of threads for the queries (1: calling thread)
+ \param[out]    tinfo    : terrain info arrays (1 to n_points, NULL arrays 
+                           are not filled in)
+   
+     Returns the number of query points with data found in terrains
+
+ ******************************************************************************/
+int
+getTerrainInfoBatch(int n_points, double *x, double *y, int n_threads,
+		    TerrainInfoBatch *tinfo)
+{
+  int                i;
+  int                n_found = 0;
+  int                z_only;
+  TerrainIndex      *idx;
+  TerrainQuery      *queries;
+  TerrainQueryBatch *batch;
+  pthread_t         *threads;
+  int               *started;
+
+  if (n_points < 1)
+    return 0;
+
+  if (n_threads > n_points)
+    n_threads = n_points;
+  if (n_threads < 1)
+    n_threads = 1;
+
+  z_only = (tinfo->pz == NULL && tinfo->fz == NULL && tinfo->n_x == NULL &&
+	    tinfo->n_y == NULL && tinfo->n_z == NULL && tinfo->n_nMSE == NULL &&
+	    tinfo->slope == NULL);
+
+  // sort the queries by their bucket in the spatial index
+  idx = __atomic_load_n(&terrain_index,__ATOMIC_ACQUIRE);
+  queries = (TerrainQuery *)my_calloc(n_points,sizeof(TerrainQuery),MY_STOP);
+  for (i=0; i<n_points; ++i) {
+    queries[i].q      = i+1;
+    queries[i].bucket = (idx != NULL) ? getTerrainIndexBucket(idx,x[i+1],y[i+1]) : 0;
+  }
+  qsort(queries,n_points,sizeof(TerrainQuery),compareTerrainQueries);
+
+  // split the sorted queries into equal parts for the threads
+  batch   = (TerrainQueryBatch *)my_calloc(n_threads,sizeof(TerrainQueryBatch),MY_STOP);
+  threads = (pthread_t *)my_calloc(n_threads,sizeof(pthread_t),MY_STOP);
+  started = (int *)my_calloc(n_threads,sizeof(int),MY_STOP);
+
+  for (i=0; i<n_threads; ++i) {
+    batch[i].x       = x;
+    batch[i].y       = y;
+    batch[i].z_only  = z_only;
+    batch[i].idx     = idx;
+    batch[i].queries = queries;
+    batch[i].tinfo   = tinfo;
+    batch[i].start   = (int)(((long long)i*n_points)/n_threads);
+    batch[i].end     = (int)(((long long)(i+1)*n_points)/n_threads);
+  }
+
+  for (i=1; i<n_threads; ++i)
+    started[i] = (pthread_create(&threads[i],NULL,processTerrainQueries,
+				 (void *)&batch[i]) == 0);
+
+  // the calling thread processes the first part, and the parts of threads
+  // that could not be started
+  processTerrainQueries((void *)&batch[0]);
+  for (i=1; i<n_threads; ++i)
+    if (!started[i])
+      processTerrainQueries((void *)&batch[i]);
+
+  for (i=0; i<n_threads; ++i) {
+    if (started[i])
+      pthread_join(threads[i],NULL);
+    n_found += batch[i].n_found;
+  }
+
+  free(queries);
+  free(batch);
+  free(threads);
+  free(started);
+
+  return n_found;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  compareTerrainQueries
+\date  Oct 2026
+   
+\remarks 
+
+        qsort() comparison of queries by bucket and query index
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     a       : pointer to first query
+ \param[in]     b       : pointer to second query
+
+ ******************************************************************************/
+static int
+compareTerrainQueries(const void *a, const void *b)
+{
+  const TerrainQuery *qa = (const TerrainQuery *)a;
+  const TerrainQuery *qb = (const TerrainQuery *)b;
+
+  if (qa->bucket != qb->bucket)
+    return (qa->bucket < qb->bucket) ? -1 : 1;
+
+  return qa->q - qb->q;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  processTerrainQueries
+\date  Oct 2026
+   
+\remarks 
+
+        processes a part of the sorted queries of getTerrainInfoBatch(). For
+        every bucket, the boards of the bucket are visited in the same order
+        as in getTerrainInfoSwitched(). For each board, the cell indices of
+        all queries of the bucket are computed in one loop before the 
+        heights are compared with the same logic as for a single query.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out] dptr    : the TerrainQueryBatch with the part of the queries
+
+ ******************************************************************************/
+static void *
+processTerrainQueries(void *dptr)
+{
+  int                i,k,l,m,n,q;
+  int                c,cs,ce;
+  int                ls,le;
+  int                pad;
+  int                flag;
+  double             z,no_go;
+  float              cell[TERRAIN_TILE_N_LAYERS];
+  Terrain           *t;
+  TerrainInfo        ti;
+  TerrainQueryState *s;
+  TerrainQueryBatch *b   = (TerrainQueryBatch *)dptr;
+  TerrainInfoBatch  *out = b->tinfo;
+
+  b->n_found = 0;
+  if (b->end <= b->start)
+    return NULL;
+
+  // s is indexed with the position in the sorted queries
+  s  = (TerrainQueryState *)my_calloc(b->end-b->start,sizeof(TerrainQueryState),MY_STOP);
+  s -= b->start;
+
+  for (cs=b->start; cs<b->end; cs=ce) {
+
+    // the queries of one bucket
+    k = b->queries[cs].bucket;
+    for (ce=cs; ce<b->end && b->queries[ce].bucket == k; ++ce) {
+      s[ce].z          = EMPTY_TERRAIN;
+      s[ce].no_go      = FALSE;
+      s[ce].in_padding = FALSE;
+    }
+
+    if (b->idx != NULL) {
+      ls = b->idx->start[k];
+      le = b->idx->start[k+1];
+    } else
+      ls = le = 0;
+
+    for (l=ls; l<le; ++l) {
+
+      i = b->idx->ids[l];
+      t = TERRAIN_PTR(i);
+
+      if (!t->status)
+	continue;
+
+      // the cells of all queries in this board
+      for (c=cs; c<ce; ++c) {
+	q = b->queries[c].q;
+	s[c].m = rint((b->x[q] - t->xorg)/t->dx) + 1;
+	s[c].n = rint((b->y[q] - t->yorg)/t->dy) + 1;
+      }
+
+      for (c=cs; c<ce; ++c) {
+
+	m = s[c].m;
+	n = s[c].n;
+
+	if (m < 1 || m > t->nx || n < 1 || n > t->ny)
+	  continue;
 
+	if (TERRAIN_PRECOMPUTED(t)) {
+	  if (!readTerrainCell(i, FALSE, m, n, cell))
+	    continue;
+	  z     = (cell[TT_Z] == EMPTY_TERRAIN) ? EMPTY_TERRAIN : cell[TT_Z] + t->pos.x[_Z_];
+	  no_go = cell[TT_NO_GO];
+	} else {
+	  z     = t->z[m][n];
+	  no_go = t->no_go[m][n];
 	}
 
-	tinfo->slope  = fabs(acos(tinfo->n[_Z_]));
+	s[c].found = TRUE;
+
+	// data points on proper terrain boards superseed data points in the
+	// padding, as in getTerrainInfoSwitched()
+	pad  = (m <= t->padx || m > t->nx-t->padx || n <= t->pady || n > t->ny-t->pady);
+	flag = (s[c].win == 0 || s[c].in_padding);
+
+	if (z > s[c].z) {
+	  if (pad && !flag)
+	    continue;
+	} else if (!flag || pad)
+	  continue;
+
+	s[c].z          = z;
+	s[c].no_go      = no_go;
+	s[c].in_padding = pad;
+	s[c].win        = i;
+	s[c].win_m      = m;
+	s[c].win_n      = n;
 
       }
 
-      tinfo->ID = t->ID;
+    }
 
-    } // end in valid terrain area
+    // the terrain info only from the board that provides the height
+    for (c=cs; c<ce; ++c) {
+
+      q = b->queries[c].q;
+
+      ti.z          = s[c].z;
+      ti.pz         = EMPTY_TERRAIN;
+      ti.fz         = EMPTY_TERRAIN;
+      ti.n[_X_]     = 0;
+      ti.n[_Y_]     = 0;
+      ti.n[_Z_]     = 1.0;
+      ti.n_nMSE     = 0.0;
+      ti.slope      = 0.0;
+      ti.no_go      = s[c].no_go;
+      ti.ID         = 0;
+      ti.in_padding = s[c].in_padding;
+
+      if (s[c].win != 0) {
+	t = TERRAIN_PTR(s[c].win);
+	ti.ID = t->ID;
+	if (!b->z_only && (!TERRAIN_PRECOMPUTED(t) ||
+			   readTerrainCell(s[c].win, FALSE, s[c].win_m, s[c].win_n, cell)))
+	  getTerrainCellInfo(s[c].win, s[c].win_m, s[c].win_n, cell, &ti);
+      }
 
-  }
+      if (s[c].found)
+	++b->n_found;
+      else {
+	ti.z  = ground_level_z;
+	ti.pz = ground_level_z;
+	ti.fz = ground_level_z;
+      }
+
+      if (out->z != NULL)
+	out->z[q] = ti.z;
+      if (out->pz != NULL)
+	out->pz[q] = ti.pz;
+      if (out->fz != NULL)
+	out->fz[q] = ti.fz;
+      if (out->n_x != NULL)
+	out->n_x[q] = ti.n[_X_];
+      if (out->n_y != NULL)
+	out->n_y[q] = ti.n[_Y_];
+      if (out->n_z != NULL)
+	out->n_z[q] = ti.n[_Z_];
+      if (out->n_nMSE != NULL)
+	out->n_nMSE[q] = ti.n_nMSE;
+      if (out->slope != NULL)
+	out->slope[q] = ti.slope;
+      if (out->no_go != NULL)
+	out->no_go[q] = ti.no_go;
+      if (out->ID != NULL)
+	out->ID[q] = ti.ID;
+      if (out->in_padding != NULL)
+	out->in_padding[q] = ti.in_padding;
+      if (out->found != NULL)
+	out->found[q] = s[c].found;
+
+    }
 
-  if (!found_flag) {
-    tinfo->z      = ground_level_z;
-    tinfo->pz     = ground_level_z;
-    tinfo->fz     = ground_level_z;
   }
 
+  free(s + b->start);
 
-  return found_flag;
+  return NULL;
 }
 
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  getContactTerrainInfo
@@ -877,89 +1617,214 @@ int
 getContactTerrainInfo(double x, double y, char *tfname, double *z, double *norm,
 	double *no_go)
 {
-  int           i,j,m,n;
-  Terrain      *t;
-  TerrainInfo  tinfo;
-
-  // loop over all terrain boards and try to find whether query point is
-  // covered by the given board
-  for (i=1; i<=MAX_TERRAINS; ++i) {
-
-    // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+  return getContactTerrainInfoByHandle(getContactTerrainHandle(tfname),x,y,z,norm,no_go);
+}
 
-    if (!t->status)
-      continue;
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getContactTerrainHandle
+\date  Oct 2026
+   
+\remarks 
 
-    if (strcmp(t->tfname,tfname) != 0)
-      continue;
+        Returns the handle of the terrain board with a given terrain file 
+        name, which identifies the board in contact queries without a 
+        string comparison. The handle stays valid as long as the board
+        exists, and it becomes invalid when the board is removed, even if
+        its slot is reused by another board.
 
-    // determine index into terrain matrix
-    m = rint((x - t->c_dxorg)/t->dx) + 1;
-    n = rint((y - t->c_dyorg)/t->dy) + 1;
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-    if (m >= 1 && m <= t->c_nx && n >=1 && n <=t->c_ny) {
+ \param[in]     tfname   : terrain file name needed to identify the terrain
 
-      *z = t->c_z[m][n];
-      *no_go = t->c_no_go[m][n];
+     Returns the handle, or NO_TERRAIN_HANDLE if there is no such terrain.
 
-      // compute the normal
-      if (t->ccached[m][n]) {
-	norm[_X_] = t->cn_x[m][n];
-	norm[_Y_] = t->cn_y[m][n];
-	norm[_Z_] = t->cn_z[m][n];
-      } else {
-	pthread_mutex_lock( &mutex_terrain );
-	computeTerrainNormal(i, m, n, t->reg_crad, t->reg_crad, 1, TRUE, FALSE,&tinfo);
-	norm[_X_] = t->cn_x[m][n] = tinfo.n[_X_];
-	norm[_Y_] = t->cn_y[m][n] = tinfo.n[_Y_];
-	norm[_Z_] = t->cn_z[m][n] = tinfo.n[_Z_];
-	t->ccached[m][n] = TRUE;
-	pthread_mutex_unlock( &mutex_terrain );
-      }
-      return TRUE;
-    }
+ ******************************************************************************/
+int
+getContactTerrainHandle(char *tfname)
+{
+  int           i;
+  Terrain      *t;
 
+  for (i=1; i<=n_terrains; ++i) {
+    t = TERRAIN_PTR(i);
+    if (t->status && strcmp(t->tfname,tfname) == 0)
+      return i + TERRAIN_HANDLE_SLOTS*t->gen;
   }
 
-  return FALSE;
+  return NO_TERRAIN_HANDLE;
 }
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  computeTerrainNormal
-\date  April 2006
+\note  getContactTerrainInfoByHandle
+\date  Oct 2026
    
 \remarks 
 
-        Computes the terrain normal at a certain location in a terrain
-        using a certain neigborhod of points
+        Returns z position and normal of terrain for the purpose of 
+        contact checking. This function never blocks: a normal that is
+        not cached yet is computed by the calling thread, and published
+        in the cache unless another thread is writing it at the same time.
+        For a streamed board, only tiles that are already in the tile cache
+        are used, and no file is read. The tiles around the contact points
+        are loaded with loadContactTerrainTiles() before the queries.
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
- \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
- \param[in]     ix      : the integer index of the x coordinate of terrain location
- \param[in]     iy      : the integer index of the y coordinate of terrain location
- \param[in]     nx      : the number of x neighbors to consider for regression
- \param[in]     ny      : the number of y neighbors to consider for regression
- \param[in]     down    : 1=no down sampling, 2=every other point in
-                  x and y direction is chosen, etc.
- \param[in]     cflag   : compute for contact representation
- \param[in]     fflag   : compute for foothold representation
- \param[out]    tinfo   : the terrain info structure
-     
+ \param[in]     h        : handle of the terrain from getContactTerrainHandle()
+ \param[in]     x        : x position of query point (local coordinates)
+ \param[in]     y        : y position of query point (local coordinates)
+ \param[out]    z        : z position of query point (local coordinates)
+ \param[out]    norm     : terrain normal at this point
+ \param[out]    no_go    : no_go value at this point
+
+   
+     Returns TRUE if data found in terrains, or FALSE if not. 
+
  ******************************************************************************/
-#define MAX_NEIGHBORS  50
-#define USE_CACHE      TRUE
+int
+getContactTerrainInfoByHandle(int h, double x, double y, double *z, double *norm,
+			      double *no_go)
+{
+  int           m,n;
+  float         cell[TERRAIN_CTILE_N_LAYERS];
+  Terrain      *t;
+
+  if ((t = getTerrainByHandle(h)) == NULL)
+    return FALSE;
+
+  // determine index into terrain matrix
+  m = rint((x - t->c_dxorg)/t->dx) + 1;
+  n = rint((y - t->c_dyorg)/t->dy) + 1;
+
+  if (m < 1 || m > t->c_nx || n < 1 || n > t->c_ny)
+    return FALSE;
+
+  // the cell of a streamed or compact board is read with all layers, and 
+  // the height of the padding of a streamed board depends on the board 
+  // position
+  if (TERRAIN_PRECOMPUTED(t)) {
+    if (t->compact != NULL)
+      readTerrainCompactCell(h % TERRAIN_HANDLE_SLOTS, TRUE, m, n, cell);
+    else if (!readTerrainStreamCellPinned(h % TERRAIN_HANDLE_SLOTS, m, n, cell))
+      return FALSE;
+    if (t->stream != NULL &&
+	(m <= t->c_padx || m > t->c_nx-t->c_padx || n <= t->c_pady || n > t->c_ny-t->c_pady))
+      *z = ground_level_z - t->pos.x[_Z_];
+    else
+      *z = cell[TT_C_Z];
+    *no_go    = cell[TT_C_NO_GO];
+    norm[_X_] = cell[TT_CN_X];
+    norm[_Y_] = cell[TT_CN_Y];
+    norm[_Z_] = cell[TT_CN_Z];
+    return TRUE;
+  }
+
+  *z = t->c_z[m][n];
+  *no_go = t->c_no_go[m][n];
+
+  // get the normal
+  if (__atomic_load_n(&(t->ccached[m][n]),__ATOMIC_ACQUIRE) == TRUE) {
+    norm[_X_] = t->cn_x[m][n];
+    norm[_Y_] = t->cn_y[m][n];
+    norm[_Z_] = t->cn_z[m][n];
+  } else {
+    cacheContactTerrainCell(h % TERRAIN_HANDLE_SLOTS, m, n, norm);
+  }
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  loadContactTerrainTiles
+\date  Oct 2026
+   
+\remarks 
+
+        loads the tiles of the contact grid of a streamed board which overlap
+        with a region into the tile cache, such that 
+        getContactTerrainInfoByHandle() finds them. This can read the tiled
+        terrain file, and it should be called before the contact queries of
+        a simulation step. Nothing is done for other boards.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     h        : handle of the terrain from getContactTerrainHandle()
+ \param[in]     x_min    : min x of the region (local coordinates)
+ \param[in]     x_max    : max x of the region (local coordinates)
+ \param[in]     y_min    : min y of the region (local coordinates)
+ \param[in]     y_max    : max y of the region (local coordinates)
+
+ ******************************************************************************/
+void
+loadContactTerrainTiles(int h, double x_min, double x_max, double y_min, 
+			double y_max)
+{
+  int           sx,sy,ex,ey;
+  Terrain      *t;
+
+  if ((t = getTerrainByHandle(h)) == NULL || t->stream == NULL)
+    return;
+
+  sx = floor((x_min - t->c_dxorg)/t->dx) + 1;
+  ex = ceil((x_max - t->c_dxorg)/t->dx) + 1;
+  sy = floor((y_min - t->c_dyorg)/t->dy) + 1;
+  ey = ceil((y_max - t->c_dyorg)/t->dy) + 1;
+
+  if (sx < 1)
+    sx = 1;
+  if (sy < 1)
+    sy = 1;
+  if (ex > t->c_nx)
+    ex = t->c_nx;
+  if (ey > t->c_ny)
+    ey = t->c_ny;
+
+  if (sx <= ex && sy <= ey)
+    loadTerrainStreamTiles(h % TERRAIN_HANDLE_SLOTS,TRUE,sx,ex,sy,ey);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  computeTerrainNormal
+\date  April 2006
+   
+\remarks 
+
+        Computes the terrain normal at a certain location in a terrain
+        using a certain neigborhod of points
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     ix      : the integer index of the x coordinate of terrain location
+ \param[in]     iy      : the integer index of the y coordinate of terrain location
+ \param[in]     nx      : the number of x neighbors to consider for regression
+ \param[in]     ny      : the number of y neighbors to consider for regression
+ \param[in]     down    : 1=no down sampling, 2=every other point in
+                  x and y direction is chosen, etc.
+ \param[in]     cflag   : compute for contact representation
+ \param[in]     fflag   : compute for foothold representation
+ \param[out]    tinfo   : the terrain info structure
+     
+ ******************************************************************************/
+#define MAX_NEIGHBORS  50
+#define MAX_REGRESSION_DATA ((2*MAX_NEIGHBORS+1)*(2*MAX_NEIGHBORS+1))
+#define USE_CACHE      TRUE
 static int
 computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
 		     int cflag, int fflag, TerrainInfo *tinfo)
 {
-  static   int firsttime = TRUE;
-  static   int last_n_data = 0;
   static   Matrix **MatrixCache[MAX_NEIGHBORS+1][MAX_NEIGHBORS+1];
-  static   Vector   y;
+  Matrix **cache = NULL;
+  double   y[MAX_REGRESSION_DATA+1]; // local, as several threads can run this function
   Matrix   X;
   Matrix   XTX;
   Matrix   XTXinv;
@@ -980,15 +1845,7 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
   int      tnx,tny;
   double   std;
 
-  // initialize the cache
-  if (firsttime) {
-    firsttime = FALSE;
-    for (i=0; i<=MAX_NEIGHBORS; ++i)
-      for (j=0; j<=MAX_NEIGHBORS; ++j)
-	MatrixCache[i][j] = NULL;
-  }
-
-  t = &(terrains[ID]);
+  t = TERRAIN_PTR(ID);
 
   // default initialization
   tinfo->slope  = 0.0;
@@ -1041,12 +1898,6 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
   // the number of data to be used in the regression
   n_data   = ((ex-sx)/down+1) * ((ey-sy)/down+1);
 
-  // keep enough memory for y arround
-  if (last_n_data < n_data) {
-    my_free_vector(y,1,last_n_data);
-    y = my_vector(1,n_data);
-  }
-
   // the indices into the cache (written for a more general case,
   // one could just write ind1=nx ind2=ny, etc.)
   ind1 = ix-sx;
@@ -1059,25 +1910,43 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
     printf("Error in index computation!\n");
   }
 
+  // the regression cache is shared by all threads: cached regression models
+  // are looked up without locking, and new models are added under the mutex
+#if USE_CACHE
+  cache = __atomic_load_n(&(MatrixCache[ind1][ind2]),__ATOMIC_ACQUIRE);
+  if (cache != NULL)
+    XTXinvXT = __atomic_load_n(&(cache[ind3][ind4]),__ATOMIC_ACQUIRE);
+  if (XTXinvXT != NULL)
+    need_matrix = FALSE;
+#endif
+
+  if (need_matrix)
+    pthread_mutex_lock( &mutex_regression );
+
 #if USE_CACHE
   // check whether some compuations are already cached
-  if (MatrixCache[ind1][ind2] != NULL) {
-    need_memory = FALSE;
-    if (MatrixCache[ind1][ind2][ind3][ind4]!=NULL) {
-      XTXinvXT = MatrixCache[ind1][ind2][ind3][ind4];
-      need_matrix = FALSE;
-    } else
+  if (need_matrix) {
+    if (MatrixCache[ind1][ind2] != NULL) {
+      need_memory = FALSE;
+      if (MatrixCache[ind1][ind2][ind3][ind4]!=NULL) {
+	XTXinvXT = MatrixCache[ind1][ind2][ind3][ind4];
+	need_matrix = FALSE;
+	pthread_mutex_unlock( &mutex_regression );
+      } else
+	need_matrix = TRUE;
+    } else {
+      need_memory = TRUE;
       need_matrix = TRUE;
-  } else {
-    need_memory = TRUE;
-    need_matrix = TRUE;
-  }
+    }
+  } else
+    need_memory = FALSE;
 
-  // allocate a memory array if needed
+  // allocate a memory array if needed, which is complete before it is visible
   if (need_memory) {
-    MatrixCache[ind1][ind2] = (Matrix **)my_calloc(nx+1,sizeof(Matrix *),MY_STOP);
+    cache = (Matrix **)my_calloc(nx+1,sizeof(Matrix *),MY_STOP);
     for (i=0; i<=nx; ++i)
-      MatrixCache[ind1][ind2][i] = (Matrix *)my_calloc(ny+1,sizeof(Matrix),MY_STOP);
+      cache[i] = (Matrix *)my_calloc(ny+1,sizeof(Matrix),MY_STOP);
+    __atomic_store_n(&(MatrixCache[ind1][ind2]),cache,__ATOMIC_RELEASE);
   }
 #endif
   
@@ -1102,6 +1971,7 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
     
     if (count != n_data) {
       printf("Counting Error\n");
+      pthread_mutex_unlock( &mutex_regression );
       return FALSE;
     }
     
@@ -1114,11 +1984,11 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
     my_free_matrix(XTXinv,1,3,1,3);
 
 #if USE_CACHE
-    MatrixCache[ind1][ind2][ind3][ind4] = XTXinvXT;
-#else
-    my_free_matrix(XTXinvXT,1,3,1,n_data);
+    __atomic_store_n(&(MatrixCache[ind1][ind2][ind3][ind4]),XTXinvXT,__ATOMIC_RELEASE);
 #endif
 
+    pthread_mutex_unlock( &mutex_regression );
+
   }    
 
   // generate the y vector
@@ -1184,6 +2054,9 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
 
   // compute the regression results
   mat_vec_mult_size(XTXinvXT,3,n_data,y,n_data,beta);
+#if !USE_CACHE
+  my_free_matrix(XTXinvXT,1,3,1,n_data);
+#endif
 
   // compute nMSE value
   sum_e2 = 0.0;
@@ -1229,181 +2102,1496 @@ computeTerrainNormal(int ID, int ix, int iy, int nx, int ny, int down,
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  getNextTerrainID
-\date  April 2006
+\note  computeTerrainNormalSAT
+\date  Oct 2026
    
 \remarks 
 
-        Returns the ID of the next free terrain ID
+        Computes the same plane regression as computeTerrainNormal() for the
+        contact and the non-foothold representation, but from summed-area 
+        tables of the terrain, such that the cost is independent of the 
+        regression radius. As the regression neighborhood is symmetric,
+        the normal equations are diagonal, and all regression results follow
+        from the sums of z, x*z, y*z, and z^2 over the neighborhood.
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
-   returns the next free terrain ID or FALSE, if nothing available.
-
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     ix      : the integer index of the x coordinate of terrain location
+ \param[in]     iy      : the integer index of the y coordinate of terrain location
+ \param[in]     cflag   : compute for contact representation
+ \param[out]    tinfo   : the terrain info structure
+     
  ******************************************************************************/
-int
-getNextTerrainID(void)
+static int
+computeTerrainNormalSAT(int ID, int ix, int iy, int cflag, TerrainInfo *tinfo)
 {
-  int i;
+  int         ax,ay;
+  int         c[4];
+  int         kx,ky;
+  int         n_data;
+  long double sum_z,sum_xz,sum_yz,sum_zz;
+  double      suu,svv,suz,svz;
+  double      beta[3+1];
+  double      sum_e2;
+  double      aux;
+  Terrain    *t;
+  TerrainSAT *sat;
 
-  for (i=1; i<=MAX_TERRAINS; ++i)
-    if (terrains[i].status != TRUE)
-      return i;
+  t = TERRAIN_PTR(ID);
 
-  return FALSE;
+  // default initialization
+  tinfo->slope  = 0.0;
+  tinfo->n_nMSE = 0.0;
+  tinfo->n[_X_] = 0.0;
+  tinfo->n[_Y_] = 0.0;
+  tinfo->n[_Z_] = 1.0;
+
+  // check whether ix and iy dimension are OK
+  if ((cflag  && (ix < 1 || ix > t->c_nx || iy < 1 || iy > t->c_ny)) ||
+      (!cflag && (ix < 1 || ix > t->nx || iy < 1 || iy > t->ny))) {
+    printf("Error in terrain indices\n");
+    return FALSE;
+  }
+
+  if ((sat = getTerrainSAT(ID,cflag)) == NULL)
+    return FALSE;
+
+  // the corners of the neighborhood in the tables
+  ax = ix-1+sat->off;
+  ay = iy-1+sat->off;
+  c[0] = (ax+sat->rad_x)*sat->n_y + ay+sat->rad_y;
+  c[1] = (ax-sat->rad_x-sat->down)*sat->n_y + ay+sat->rad_y;
+  c[2] = (ax+sat->rad_x)*sat->n_y + ay-sat->rad_y-sat->down;
+  c[3] = (ax-sat->rad_x-sat->down)*sat->n_y + ay-sat->rad_y-sat->down;
+
+  sum_z  = sat->s_z[c[0]]  - sat->s_z[c[1]]  - sat->s_z[c[2]]  + sat->s_z[c[3]];
+  sum_xz = sat->s_xz[c[0]] - sat->s_xz[c[1]] - sat->s_xz[c[2]] + sat->s_xz[c[3]];
+  sum_yz = sat->s_yz[c[0]] - sat->s_yz[c[1]] - sat->s_yz[c[2]] + sat->s_yz[c[3]];
+  sum_zz = sat->s_zz[c[0]] - sat->s_zz[c[1]] - sat->s_zz[c[2]] + sat->s_zz[c[3]];
+
+  // the regression inputs are offsets from the query cell
+  kx     = sat->rad_x/sat->down;
+  ky     = sat->rad_y/sat->down;
+  n_data = (2*kx+1)*(2*ky+1);
+  suz    = (double)(sum_xz - ax*sum_z)*t->dx;
+  svz    = (double)(sum_yz - ay*sum_z)*t->dy;
+  suu    = sqr(t->dx*sat->down)*(2*ky+1)*kx*(kx+1)*(2*kx+1)/3.;
+  svv    = sqr(t->dy*sat->down)*(2*kx+1)*ky*(ky+1)*(2*ky+1)/3.;
+
+  beta[1] = (suu > 0) ? suz/suu : 0.0;
+  beta[2] = (svv > 0) ? svz/svv : 0.0;
+  beta[3] = (double)sum_z/(double)n_data;
+
+  // the nMSE from the residual sum of squares
+  sum_e2 = (double)sum_zz - beta[1]*suz - beta[2]*svz - beta[3]*(double)sum_z;
+  if (sum_e2 < 0)
+    sum_e2 = 0.0;
+  tinfo->n_nMSE = (sum_e2/(double)n_data)/sqr(0.01);
+
+  // the surface normal as in computeTerrainNormal()
+  aux = sqrt(sqr(beta[1])+sqr(beta[2])+1);
+  if (aux <= 1.e-10)
+    aux = 1.e-10;
+  tinfo->n[_X_] = -beta[1]/aux;
+  tinfo->n[_Y_] = -beta[2]/aux;
+  tinfo->n[_Z_] = 1./aux;
+
+  // the absolute slope angle
+  tinfo->slope = fabs(acos(tinfo->n[_Z_]));
+
+  // the predicted z coordinate from regression (smoothed z)
+  tinfo->pz  = beta[3] + sat->z_ref;
+
+  return TRUE;
 }
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  setTerrainGroundZ
-\date  April 2006
+\note  getTerrainSAT
+\date  Oct 2026
    
 \remarks 
 
-        sets the default z position of the floor
+        returns the summed-area tables of a terrain, which are built on 
+        first use
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
- \param[in]     z : z position of the floor
-
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : tables for contact representation
+     
  ******************************************************************************/
-void
-setTerrainGroundZ(double z)
+static TerrainSAT *
+getTerrainSAT(int ID, int cflag)
 {
-  ground_level_z = z;
-}
+  TerrainSAT **sat;
+  TerrainSAT  *new_sat;
+
+  if (cflag)
+    sat = &(TERRAIN_PTR(ID)->c_sat);
+  else
+    sat = &(TERRAIN_PTR(ID)->sat);
 
+  if ((new_sat = __atomic_load_n(sat,__ATOMIC_ACQUIRE)) == NULL) {
+    pthread_mutex_lock( &mutex_regression );
+    if ((new_sat = *sat) == NULL) {
+      new_sat = buildTerrainSAT(ID,cflag);
+      __atomic_store_n(sat,new_sat,__ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock( &mutex_regression );
+  }
+
+  return new_sat;
+}
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  cacheTerrainInfo
-\date  April 2006
+\note  buildTerrainSAT
+\date  Oct 2026
    
 \remarks 
 
-        This functions caches the terrain info for all existing boards
-        if necessary.
+        builds the summed-area tables of z, x*z, y*z, and z^2 of a terrain.
+        The tables extend beyond the terrain by the regression radius, where
+        z is filled in the same way as in computeTerrainNormal(). With down
+        sampling, the tables sum over every down-th cell, i.e., 
+        s[a][b] = f[a][b] + s[a-down][b] + s[a][b-down] - s[a-down][b-down].
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
-         none
-
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : tables for contact representation
+     
  ******************************************************************************/
-void
-cacheTerrainInfo(void)
+static TerrainSAT *
+buildTerrainSAT(int ID, int cflag)
 {
+  int          i,j,m,n,a,b,k;
+  int          tnx,tny;
+  int          rad;
+  int          count = 0;
+  double       z;
+  double       vl[N_CART+1];
+  Terrain     *t;
+  TerrainSAT  *sat;
+  TerrainInfo  taux;
 
-  /* initialize a thread for the caching processing to run in the background */
-  if (pthread_create( &cthread_terrain, NULL, cacheTerrainInfoThread, (void*) NULL) != 0)
-    return;
+  t = TERRAIN_PTR(ID);
 
-}
+  sat = (TerrainSAT *)my_calloc(1,sizeof(TerrainSAT),MY_STOP);
 
-static void *
-cacheTerrainInfoThread(void *dptr)
-{
+  // the regression parameters as in computeTerrainNormal()
+  if (cflag) {
+    tnx        = t->c_nx;
+    tny        = t->c_ny;
+    sat->down  = 1;
+    sat->rad_x = t->reg_crad;
+    sat->rad_y = t->reg_crad;
+  } else {
+    tnx        = t->nx;
+    tny        = t->ny;
+    sat->down  = (t->reg_down < 1) ? 1 : t->reg_down;
+    sat->rad_x = rint(((double)t->reg_rad)/((double)sat->down))*sat->down;
+    sat->rad_y = sat->rad_x;
+  }
 
-  int          i,j,m,n;
-  Terrain      *t;
-  TerrainInfo  tinfo;
-  int          ID;
-  
-  // loop over all terrain boards and try to find whether query point is
-  // covered by the given board
-  for (ID=1; ID<=MAX_TERRAINS; ++ID) {
+  rad      = (sat->rad_x > sat->rad_y) ? sat->rad_x : sat->rad_y;
+  sat->off = rad + sat->down;
+  sat->n_x = tnx + 2*sat->off;
+  sat->n_y = tny + 2*sat->off;
+
+  sat->s_z  = (long double *)my_calloc(sat->n_x*sat->n_y,sizeof(long double),MY_STOP);
+  sat->s_xz = (long double *)my_calloc(sat->n_x*sat->n_y,sizeof(long double),MY_STOP);
+  sat->s_yz = (long double *)my_calloc(sat->n_x*sat->n_y,sizeof(long double),MY_STOP);
+  sat->s_zz = (long double *)my_calloc(sat->n_x*sat->n_y,sizeof(long double),MY_STOP);
+
+  // the reference height keeps the sums small
+  sat->z_ref = 0.0;
+  for (i=1; i<=tnx; ++i)
+    for (j=1; j<=tny; ++j) {
+      sat->z_ref += cflag ? t->c_z[i][j] : t->z[i][j];
+      ++count;
+    }
+  if (count > 0)
+    sat->z_ref /= (double)count;
 
-    // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[ID]);
+  // the terrain heights, including the neighborhood of the terrain
+  for (i=1-rad; i<=tnx+rad; ++i)
+    for (j=1-rad; j<=tny+rad; ++j) {
 
-    if (!t->status)
-      continue;
+      if (i >= 1 && i <= tnx && j >= 1 && j <= tny) {
 
-    printf("Caching terrain %s started ...\n",t->tfname);
-    fflush(stdout);
+	z = cflag ? t->c_z[i][j] : t->z[i][j];
 
-    // pre-compute normal information
-    for (i=1; i<=t->nx; ++i) 
-      for (j=1; j<=t->ny; ++j) 
-	if (!t->cached[i][j]) {
-	  pthread_mutex_lock( &mutex_terrain );
-	  computeTerrainNormal(ID, i, j, t->reg_rad, t->reg_rad, t->reg_down, 
-			       FALSE, TRUE, &tinfo);
-	  t->fz[i][j]     = tinfo.fz;
-	  computeTerrainNormal(ID, i, j, t->reg_rad, t->reg_rad, t->reg_down, 
-			       FALSE, FALSE, &tinfo);
-	  t->n_nMSE[i][j] = tinfo.n_nMSE;
-	  t->pz[i][j]     = tinfo.pz;
-	  t->n_x[i][j]    = tinfo.n[_X_];
-	  t->n_y[i][j]    = tinfo.n[_Y_];
-	  t->n_z[i][j]    = tinfo.n[_Z_];
-	  t->cached[i][j]  = TRUE;
-	  pthread_mutex_unlock( &mutex_terrain );
-	}
+      } else if (cflag) { // the closest board coordinate
 
-    if (t->reg_crad != 0) 
-      for (i=1; i<=t->nx_local; ++i) 
-	for (j=1; j<=t->ny_local; ++j) 
-	  if (!t->ccached[i][j]) {
-	    pthread_mutex_lock( &mutex_terrain );
-	    computeTerrainNormal(ID, i, j, t->reg_crad, t->reg_crad, 1, TRUE, FALSE, &tinfo);
-	    t->cn_x[i][j]    = tinfo.n[_X_];
-	    t->cn_y[i][j]    = tinfo.n[_Y_];
-	    t->cn_z[i][j]    = tinfo.n[_Z_];
-	    t->ccached[i][j]  = TRUE;
-	    pthread_mutex_unlock( &mutex_terrain );
-	  }
+	m = (i < 1) ? 1 : ((i > tnx) ? tnx : i);
+	n = (j < 1) ? 1 : ((j > tny) ? tny : j);
+	z = t->c_z[m][n];
 
-    printf("Caching terrain %s finished\n",t->tfname);
-    
-  }
+      } else { // the query in world coordinates
 
-  return NULL;
+	vl[_X_] = (i-1)*t->dx+t->xorg;
+	vl[_Y_] = (j-1)*t->dy+t->yorg;
+	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &taux);
+	z = taux.z;
+
+      }
+
+      a = i-1+sat->off;
+      b = j-1+sat->off;
+      k = a*sat->n_y + b;
+      z -= sat->z_ref;
+      sat->s_z[k]  = z;
+      sat->s_xz[k] = a*(long double)z;
+      sat->s_yz[k] = b*(long double)z;
+      sat->s_zz[k] = z*(long double)z;
+
+    }
+
+  // the strided summation
+  for (a=0; a<sat->n_x; ++a)
+    for (b=0; b<sat->n_y; ++b) {
+      k = a*sat->n_y + b;
+      if (a >= sat->down) {
+	m = k - sat->down*sat->n_y;
+	sat->s_z[k]  += sat->s_z[m];
+	sat->s_xz[k] += sat->s_xz[m];
+	sat->s_yz[k] += sat->s_yz[m];
+	sat->s_zz[k] += sat->s_zz[m];
+      }
+      if (b >= sat->down) {
+	m = k - sat->down;
+	sat->s_z[k]  += sat->s_z[m];
+	sat->s_xz[k] += sat->s_xz[m];
+	sat->s_yz[k] += sat->s_yz[m];
+	sat->s_zz[k] += sat->s_zz[m];
+      }
+      if (a >= sat->down && b >= sat->down) {
+	m = k - sat->down*sat->n_y - sat->down;
+	sat->s_z[k]  -= sat->s_z[m];
+	sat->s_xz[k] -= sat->s_xz[m];
+	sat->s_yz[k] -= sat->s_yz[m];
+	sat->s_zz[k] -= sat->s_zz[m];
+      }
+    }
 
+  return sat;
 }
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  fillTerrainPadding
+\note  freeTerrainSAT
+\date  Oct 2026
+   
+\remarks 
+
+        frees summed-area tables and resets the pointer to NULL
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in,out] sat     : pointer to the tables
+     
+ ******************************************************************************/
+static void
+freeTerrainSAT(TerrainSAT **sat)
+{
+  if (*sat == NULL)
+    return;
+
+  free((*sat)->s_z);
+  free((*sat)->s_xz);
+  free((*sat)->s_yz);
+  free((*sat)->s_zz);
+  free(*sat);
+  *sat = NULL;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getNextTerrainID
 \date  April 2006
    
 \remarks 
 
-        Computes the z values for the padded terrain locations
+        Returns the ID of the next free terrain ID
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
-         none
+   returns the next free terrain ID or FALSE, if nothing available.
 
  ******************************************************************************/
-void
-fillTerrainPadding(void)
+int
+getNextTerrainID(void)
 {
+  int i;
 
-  int          i,j,m,n;
-  Terrain      *t;
-  TerrainInfo  tinfo;
-  int          ID;
-  double       vl[N_CART+1];
-  
-  // loop over all terrain boards and try to find whether query point is
-  // covered by the given board
-  for (ID=1; ID<=MAX_TERRAINS; ++ID) {
+  for (i=1; i<=n_terrains; ++i)
+    if (TERRAIN_PTR(i)->status != TRUE)
+      return i;
 
-    // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[ID]);
+  // all slots are used -- add another block of terrains
+  if (n_terrains < MAX_TERRAINS) {
+    i = n_terrains+1;
+    allocTerrainSlots(i);
+    return i;
+  }
 
-    if (!t->status)
-      continue;
+  return FALSE;
+}
 
-    printf("Padding board %s ...",t->tfname);
-    fflush(stdout);
+/*!*****************************************************************************
+ *******************************************************************************
+\note  allocTerrainSlots
+\date  Oct 2026
+   
+\remarks 
 
-    // loop over all padded terrain states
-    for (i=1; i<=t->padx; ++i) {
+        makes sure that at least n terrain slots are allocated. Slots are
+        added in blocks of TERRAIN_BLOCK_SIZE terrains, and existing slots
+        never move in memory.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     n       : the number of needed slots (at most MAX_TERRAINS)
+
+ ******************************************************************************/
+static void
+allocTerrainSlots(int n)
+{
+  while (n_terrains < n) {
+    terrain_blocks[n_terrains/TERRAIN_BLOCK_SIZE] = 
+      (Terrain *)my_calloc(TERRAIN_BLOCK_SIZE,sizeof(Terrain),MY_STOP);
+    n_terrains += TERRAIN_BLOCK_SIZE;
+  }
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainPtr
+\date  Oct 2026
+   
+\remarks 
+
+        returns a pointer to the terrain structure of a terrain array index,
+        or NULL if the index is out of range
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+ ******************************************************************************/
+Terrain *
+getTerrainPtr(int ID)
+{
+  if (ID < 1 || ID > n_terrains)
+    return NULL;
+
+  return TERRAIN_PTR(ID);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainByHandle
+\date  Oct 2026
+   
+\remarks 
+
+        returns the active terrain of a handle from getContactTerrainHandle(),
+        or NULL if the handle is invalid or its board was removed
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     h       : handle of the terrain
+
+ ******************************************************************************/
+static Terrain *
+getTerrainByHandle(int h)
+{
+  int      ID = h % TERRAIN_HANDLE_SLOTS;
+  Terrain *t;
+
+  if (h < 1 || ID < 1 || ID > n_terrains)
+    return NULL;
+
+  t = TERRAIN_PTR(ID);
+
+  if (!t->status || t->gen != h/TERRAIN_HANDLE_SLOTS)
+    return NULL;
+
+  return t;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  addTerrainBoard
+\date  Oct 2026
+   
+\remarks 
+
+        adds a terrain board in a free terrain slot, which can also be done
+        while the simulation is running. The terrain ID of the board is its
+        array index. Note that fillTerrainPadding() needs to be called again
+        if the board overlaps with the padding of other boards.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     tfname  : terrain file name (in the TERRAINS directory)
+ \param[in]     pos     : position of terrain origin in world coordinates
+ \param[in]     orient  : orientation of the terrain as unit quaternion
+ \param[in]     reg_rad : radius of points used in regression of normal
+ \param[in]     reg_down: down sampling for normal regression
+ \param[in]     reg_crad: radius of points used to comopute contact normal 
+
+     returns the terrain array index of the board, or FALSE for failure
+
+ ******************************************************************************/
+int
+addTerrainBoard(char *tfname, double *pos, double *orient,
+		int reg_rad, int reg_down, int reg_crad)
+{
+  int ID;
+
+  if ((ID = getNextTerrainID()) == FALSE) {
+    printf("No more terrains possible (max. %d)\n",MAX_TERRAINS);
+    return FALSE;
+  }
+
+  if (!setTerrainInfo(ID,ID,tfname,pos,orient,reg_rad,reg_down,reg_crad))
+    return FALSE;
+
+  return ID;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  removeTerrainBoard
+\date  Oct 2026
+   
+\remarks 
+
+        removes a terrain board and frees its memory. The caching threads
+        are paused while the board is removed, and its pending tiles are 
+        dropped. All handles of the board become invalid. Like adding a 
+        board, this must not be done while other threads query the terrain.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+     returns TRUE for success, and FALSE if there is no such board
+
+ ******************************************************************************/
+int
+removeTerrainBoard(int ID)
+{
+  TerrainIndex *old;
+  Terrain      *t;
+
+  if (ID < 1 || ID > n_terrains) {
+    printf("Terrain %d out of range of terrains from 1-%d\n",ID,n_terrains);
+    return FALSE;
+  }
+
+  t = TERRAIN_PTR(ID);
+
+  if (!t->status)
+    return FALSE;
+
+  pauseTerrainCache();
+  dropTerrainCacheJobs(ID);
+
+  t->status = FALSE;
+  old = terrain_index;
+  __atomic_store_n(&terrain_index,buildTerrainIndex(),__ATOMIC_RELEASE);
+
+  resumeTerrainCache();
+
+  freeTerrainIndex(old);
+  printf("Removed terrain board %d (%s)\n",ID,t->tfname);
+  freeTerrainBoard(ID);
+  updateTerrainBoundingBox();
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  removeTerrainBoardByHandle
+\date  Oct 2026
+   
+\remarks 
+
+        same as removeTerrainBoard(), but with a terrain handle
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     h       : handle of the terrain from getContactTerrainHandle()
+
+ ******************************************************************************/
+int
+removeTerrainBoardByHandle(int h)
+{
+  if (getTerrainByHandle(h) == NULL)
+    return FALSE;
+
+  return removeTerrainBoard(h % TERRAIN_HANDLE_SLOTS);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  updateTerrainBoundingBox
+\date  Oct 2026
+   
+\remarks 
+
+        computes the bounding box of all active terrain boards
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+static void
+updateTerrainBoundingBox(void)
+{
+  int      i;
+  Terrain *t;
+
+  for (i=1; i<=N_CART; ++i) {
+    terrain_bounding_box_max[i] = -1.e10;
+    terrain_bounding_box_min[i] =  1.e10;
+  }
+
+  for (i=1; i<=n_terrains; ++i) {
+
+    t = TERRAIN_PTR(i);
+
+    if (!t->status)
+      continue;
+
+    if (t->xorg < terrain_bounding_box_min[_X_])
+      terrain_bounding_box_min[_X_] = t->xorg;
+
+    if (t->xorg+(t->nx-1)*t->dx > terrain_bounding_box_max[_X_])
+      terrain_bounding_box_max[_X_] = t->xorg+(t->nx-1)*t->dx;
+
+    if (t->yorg < terrain_bounding_box_min[_Y_])
+      terrain_bounding_box_min[_Y_] = t->yorg;
+
+    if (t->yorg+(t->ny-1)*t->dy > terrain_bounding_box_max[_Y_])
+      terrain_bounding_box_max[_Y_] = t->yorg+(t->ny-1)*t->dy;
+
+    if (t->min_z < terrain_bounding_box_min[_Z_])
+      terrain_bounding_box_min[_Z_] = t->min_z;
+
+    if (t->max_z > terrain_bounding_box_max[_Z_])
+      terrain_bounding_box_max[_Z_] = t->max_z;
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  updateTerrainIndex
+\date  Oct 2026
+   
+\remarks 
+
+        rebuilds the spatial index over the active terrain boards. The index
+        is immutable and replaced as a whole, such that queries can use it 
+        without locking. The old index is freed while the caching threads,
+        which query the terrain for the padding, are paused.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+static void
+updateTerrainIndex(void)
+{
+  TerrainIndex *old;
+
+  pauseTerrainCache();
+  old = terrain_index;
+  __atomic_store_n(&terrain_index,buildTerrainIndex(),__ATOMIC_RELEASE);
+  resumeTerrainCache();
+
+  freeTerrainIndex(old);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  buildTerrainIndex
+\date  Oct 2026
+   
+\remarks 
+
+        builds a uniform grid over the footprints of all active terrain 
+        boards in world coordinates. The grid cells are hashed into buckets,
+        and every bucket lists the boards that overlap with its cells in 
+        ascending order, such that queries visit the boards in the same 
+        order as a loop over all boards. The cell size starts at 
+        TERRAIN_INDEX_CELL_SIZE and is doubled until a board covers at most 
+        16 cells on average.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+     returns the index, or NULL if there are no active boards
+
+ ******************************************************************************/
+static TerrainIndex *
+buildTerrainIndex(void)
+{
+  int           ID,b,ix,iy;
+  int           sx,ex,sy,ey;
+  int           n_entries;
+  int           n_boards;
+  int          *last;
+  int          *fill;
+  double        cell = TERRAIN_INDEX_CELL_SIZE;
+  Terrain      *t;
+  TerrainIndex *idx;
+
+  // find the cell size
+  while (TRUE) {
+    n_entries = 0;
+    n_boards  = 0;
+    for (ID=1; ID<=n_terrains; ++ID) {
+      t = TERRAIN_PTR(ID);
+      if (!t->status)
+	continue;
+      getTerrainIndexRange(t,cell,&sx,&ex,&sy,&ey);
+      n_entries += (ex-sx+1)*(ey-sy+1);
+      ++n_boards;
+    }
+    if (n_entries <= 16*n_boards)
+      break;
+    cell *= 2.0;
+  }
+
+  if (n_boards == 0)
+    return NULL;
+
+  idx = (TerrainIndex *)my_calloc(1,sizeof(TerrainIndex),MY_STOP);
+  idx->cell      = cell;
+  idx->n_buckets = 64;
+  while (idx->n_buckets < 2*n_entries)
+    idx->n_buckets *= 2;
+  idx->start = (int *)my_calloc(idx->n_buckets+1,sizeof(int),MY_STOP);
+  idx->ids   = (int *)my_calloc(n_entries,sizeof(int),MY_STOP);
+  last       = (int *)my_calloc(idx->n_buckets,sizeof(int),MY_STOP);
+  fill       = (int *)my_calloc(idx->n_buckets,sizeof(int),MY_STOP);
+
+  // count the boards of each bucket -- a board is listed only once in a
+  // bucket even if several of its cells fall into the bucket
+  for (ID=1; ID<=n_terrains; ++ID) {
+    t = TERRAIN_PTR(ID);
+    if (!t->status)
+      continue;
+    getTerrainIndexRange(t,cell,&sx,&ex,&sy,&ey);
+    for (ix=sx; ix<=ex; ++ix)
+      for (iy=sy; iy<=ey; ++iy) {
+	b = TERRAIN_INDEX_HASH(ix,iy,idx->n_buckets);
+	if (last[b] != ID) {
+	  last[b] = ID;
+	  ++idx->start[b+1];
+	}
+      }
+  }
+
+  for (b=0; b<idx->n_buckets; ++b) {
+    idx->start[b+1] += idx->start[b];
+    fill[b] = idx->start[b];
+    last[b] = 0;
+  }
+
+  // and fill the buckets
+  for (ID=1; ID<=n_terrains; ++ID) {
+    t = TERRAIN_PTR(ID);
+    if (!t->status)
+      continue;
+    getTerrainIndexRange(t,cell,&sx,&ex,&sy,&ey);
+    for (ix=sx; ix<=ex; ++ix)
+      for (iy=sy; iy<=ey; ++iy) {
+	b = TERRAIN_INDEX_HASH(ix,iy,idx->n_buckets);
+	if (last[b] != ID) {
+	  last[b] = ID;
+	  idx->ids[fill[b]++] = ID;
+	}
+      }
+  }
+
+  free(last);
+  free(fill);
+
+  return idx;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  freeTerrainIndex
+\date  Oct 2026
+   
+\remarks 
+
+        frees the memory of a spatial index
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     idx     : the index (can be NULL)
+
+ ******************************************************************************/
+static void
+freeTerrainIndex(TerrainIndex *idx)
+{
+  if (idx == NULL)
+    return;
+
+  free(idx->start);
+  free(idx->ids);
+  free(idx);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainIndexRange
+\date  Oct 2026
+   
+\remarks 
+
+        returns the range of index cells covered by a board in world 
+        coordinates, with a margin of one grid cell of the board
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     t       : the terrain
+ \param[in]     cell    : the cell size of the index
+ \param[out]    sx,ex   : first and last cell in x
+ \param[out]    sy,ey   : first and last cell in y
+
+ ******************************************************************************/
+static void
+getTerrainIndexRange(Terrain *t, double cell, int *sx, int *ex, int *sy, int *ey)
+{
+  *sx = floor((t->xorg - t->dx)/cell);
+  *ex = floor((t->xorg + t->nx*t->dx)/cell);
+  *sy = floor((t->yorg - t->dy)/cell);
+  *ey = floor((t->yorg + t->ny*t->dy)/cell);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainIndexBucket
+\date  Oct 2026
+   
+\remarks 
+
+        returns the bucket of the spatial index for a query point
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     idx     : the index
+ \param[in]     x       : x position of query point (world coordinates)
+ \param[in]     y       : y position of query point (world coordinates)
+
+ ******************************************************************************/
+static int
+getTerrainIndexBucket(TerrainIndex *idx, double x, double y)
+{
+  int ix = floor(x/idx->cell);
+  int iy = floor(y/idx->cell);
+
+  return TERRAIN_INDEX_HASH(ix,iy,idx->n_buckets);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  setTerrainGroundZ
+\date  April 2006
+   
+\remarks 
+
+        sets the default z position of the floor
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     z : z position of the floor
+
+ ******************************************************************************/
+void
+setTerrainGroundZ(double z)
+{
+  ground_level_z = z;
+}
+
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  cacheTerrainInfo
+\date  April 2006
+   
+\remarks 
+
+        This functions caches the terrain info for all existing boards
+        if necessary. The terrain grids are split into tiles, which are 
+        processed in the background by a pool of threads. The number of
+        threads is given by the parameter pool keyword "n_terrain_threads".
+        Queries to tiles that are not cached yet compute the terrain info 
+        on demand, and waitForTerrainCache() can be used to wait for the
+        caching of a given region.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+void
+cacheTerrainInfo(void)
+{
+  int          i,k,ID;
+  int          n_threads = N_TERRAIN_THREADS;
+  int          n_tiles;
+  Terrain     *t;
+  pthread_t    cthread_terrain;
+  TerrainTileJob *jobs;
+
+  if (read_parameter_pool_int(config_files[PARAMETERPOOL],"n_terrain_threads",&i))
+    n_threads = (i > 0) ? i : 1;
+
+  pthread_mutex_lock( &mutex_cache );
+
+  // add all pending tiles to the jobs
+  for (ID=1; ID<=n_terrains; ++ID) {
+
+    t = TERRAIN_PTR(ID);
+
+    // streamed and compact boards have all terrain info precomputed
+    if (!t->status || TERRAIN_PRECOMPUTED(t))
+      continue;
+
+    n_tiles = t->n_tx*t->n_ty;
+    if (t->reg_crad != 0)
+      n_tiles += t->c_n_tx*t->c_n_ty;
+
+    if (n_cache_jobs+n_tiles > max_cache_jobs) {
+      jobs = (TerrainTileJob *)my_calloc(n_cache_jobs+n_tiles,sizeof(TerrainTileJob),MY_STOP);
+      if (cache_jobs != NULL) {
+	memcpy(jobs,cache_jobs,n_cache_jobs*sizeof(TerrainTileJob));
+	free(cache_jobs);
+      }
+      cache_jobs     = jobs;
+      max_cache_jobs = n_cache_jobs+n_tiles;
+    }
+
+    printf("Caching terrain %s started ...\n",t->tfname);
+    fflush(stdout);
+
+    for (k=0; k<t->n_tx*t->n_ty; ++k) {
+      if (__atomic_load_n(&(t->tiles[k]),__ATOMIC_RELAXED) != TILE_PENDING)
+	continue;
+      cache_jobs[n_cache_jobs].ID    = ID;
+      cache_jobs[n_cache_jobs].cflag = FALSE;
+      cache_jobs[n_cache_jobs].tile  = k;
+      ++n_cache_jobs;
+    }
+
+    if (t->reg_crad != 0) {
+      for (k=0; k<t->c_n_tx*t->c_n_ty; ++k) {
+	if (__atomic_load_n(&(t->ctiles[k]),__ATOMIC_RELAXED) != TILE_PENDING)
+	  continue;
+	cache_jobs[n_cache_jobs].ID    = ID;
+	cache_jobs[n_cache_jobs].cflag = TRUE;
+	cache_jobs[n_cache_jobs].tile  = k;
+	++n_cache_jobs;
+      }
+    }
+
+  }
+
+  // start the threads, which terminate when all jobs are claimed
+  while (n_cache_threads < n_threads && next_cache_job < n_cache_jobs) {
+    if (pthread_create( &cthread_terrain, NULL, cacheTerrainInfoThread, (void*) NULL) != 0)
+      break;
+    pthread_detach(cthread_terrain);
+    ++n_cache_threads;
+  }
+
+  pthread_mutex_unlock( &mutex_cache );
+
+}
+
+static void *
+cacheTerrainInfoThread(void *dptr)
+{
+  TerrainTileJob job;
+
+  while (TRUE) {
+
+    // claim the next job
+    pthread_mutex_lock( &mutex_cache );
+    while (cache_paused)
+      pthread_cond_wait( &cond_cache, &mutex_cache );
+    if (next_cache_job >= n_cache_jobs) {
+      n_cache_jobs = next_cache_job = 0;
+      --n_cache_threads;
+      pthread_mutex_unlock( &mutex_cache );
+      break;
+    }
+    job = cache_jobs[next_cache_job++];
+    ++n_busy_tiles;
+    pthread_mutex_unlock( &mutex_cache );
+
+    // tiles that are claimed by a waiting thread are skipped
+    processTerrainTile(job.ID,job.cflag,job.tile);
+
+    pthread_mutex_lock( &mutex_cache );
+    if (--n_busy_tiles == 0 && cache_paused)
+      pthread_cond_broadcast( &cond_cache );
+    pthread_mutex_unlock( &mutex_cache );
+
+  }
+
+  return NULL;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  pauseTerrainCache
+\date  Oct 2026
+   
+\remarks 
+
+        stops the caching threads from claiming tiles, and returns after
+        the tiles in progress are done. Pending tiles remain in the jobs
+        until resumeTerrainCache() is called.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+static void
+pauseTerrainCache(void)
+{
+  pthread_mutex_lock( &mutex_cache );
+  cache_paused = TRUE;
+  while (n_busy_tiles > 0)
+    pthread_cond_wait( &cond_cache, &mutex_cache );
+  pthread_mutex_unlock( &mutex_cache );
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  resumeTerrainCache
+\date  Oct 2026
+   
+\remarks 
+
+        lets the caching threads continue after pauseTerrainCache()
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+static void
+resumeTerrainCache(void)
+{
+  pthread_mutex_lock( &mutex_cache );
+  cache_paused = FALSE;
+  pthread_cond_broadcast( &cond_cache );
+  pthread_mutex_unlock( &mutex_cache );
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  cacheTerrainCell
+\date  Oct 2026
+   
+\remarks 
+
+        computes the terrain info of one cell of the terrain grid, and 
+        caches it if no other thread is caching this cell. The cell is 
+        claimed with an atomic compare-and-swap of its cached flag, and the
+        flag is set to TRUE after all data of the cell is written. The 
+        returned values are rounded to the precision of the cache, such that
+        the results do not depend on whether a cell was cached.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     i       : x index of the cell
+ \param[in]     j       : y index of the cell
+ \param[out]    tinfo   : the terrain info of the cell (fz,pz,n,n_nMSE)
+
+ ******************************************************************************/
+static void
+cacheTerrainCell(int ID, int i, int j, TerrainInfo *tinfo)
+{
+  Terrain     *t = TERRAIN_PTR(ID);
+  TerrainInfo  taux;
+
+  computeTerrainNormal(ID, i, j, t->reg_rad, t->reg_rad, t->reg_down, 
+		       FALSE, TRUE, &taux);
+  tinfo->fz = (float) taux.fz;
+  if (use_sat_regression)
+    computeTerrainNormalSAT(ID, i, j, FALSE, &taux);
+  else
+    computeTerrainNormal(ID, i, j, t->reg_rad, t->reg_rad, t->reg_down, 
+			 FALSE, FALSE, &taux);
+  tinfo->n_nMSE = (float) taux.n_nMSE;
+  tinfo->pz     = (float) taux.pz;
+  tinfo->n[_X_] = (float) taux.n[_X_];
+  tinfo->n[_Y_] = (float) taux.n[_Y_];
+  tinfo->n[_Z_] = (float) taux.n[_Z_];
+
+  if (!__sync_bool_compare_and_swap(&(t->cached[i][j]),FALSE,CELL_BUSY))
+    return;
+
+  t->fz[i][j]     = tinfo->fz;
+  t->n_nMSE[i][j] = tinfo->n_nMSE;
+  t->pz[i][j]     = tinfo->pz;
+  t->n_x[i][j]    = tinfo->n[_X_];
+  t->n_y[i][j]    = tinfo->n[_Y_];
+  t->n_z[i][j]    = tinfo->n[_Z_];
+  __atomic_store_n(&(t->cached[i][j]),TRUE,__ATOMIC_RELEASE);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  cacheContactTerrainCell
+\date  Oct 2026
+   
+\remarks 
+
+        computes the contact normal of one cell of the contact grid, and 
+        caches it if no other thread is caching this cell, in the same way
+        as cacheTerrainCell()
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     i       : x index of the cell
+ \param[in]     j       : y index of the cell
+ \param[out]    norm    : the contact normal of the cell
+
+ ******************************************************************************/
+static void
+cacheContactTerrainCell(int ID, int i, int j, double *norm)
+{
+  Terrain     *t = TERRAIN_PTR(ID);
+  TerrainInfo  tinfo;
+
+  if (use_sat_regression)
+    computeTerrainNormalSAT(ID, i, j, TRUE, &tinfo);
+  else
+    computeTerrainNormal(ID, i, j, t->reg_crad, t->reg_crad, 1, TRUE, FALSE, &tinfo);
+  norm[_X_] = (float) tinfo.n[_X_];
+  norm[_Y_] = (float) tinfo.n[_Y_];
+  norm[_Z_] = (float) tinfo.n[_Z_];
+
+  if (!__sync_bool_compare_and_swap(&(t->ccached[i][j]),FALSE,CELL_BUSY))
+    return;
+
+  t->cn_x[i][j] = norm[_X_];
+  t->cn_y[i][j] = norm[_Y_];
+  t->cn_z[i][j] = norm[_Z_];
+  __atomic_store_n(&(t->ccached[i][j]),TRUE,__ATOMIC_RELEASE);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  processTerrainTile
+\date  Oct 2026
+   
+\remarks 
+
+        caches all cells of a tile, if the tile is still pending. The tile
+        is claimed with an atomic compare-and-swap, such that every tile is
+        processed by only one thread. Cells that were already cached on 
+        demand are skipped.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a tile of the contact grid
+ \param[in]     tile    : index of the tile
+
+ ******************************************************************************/
+static void
+processTerrainTile(int ID, int cflag, int tile)
+{
+  int      i,j;
+  int      sx,sy,ex,ey;
+  int      n_tiles;
+  int      n_tx;
+  int     *state;
+  double   norm[N_CART+1];
+  TerrainInfo tinfo;
+  Terrain *t = TERRAIN_PTR(ID);
+
+  if (cflag) {
+    state = &(t->ctiles[tile]);
+    n_tx  = t->c_n_tx;
+  } else {
+    state = &(t->tiles[tile]);
+    n_tx  = t->n_tx;
+  }
+
+  if (!__sync_bool_compare_and_swap(state,TILE_PENDING,TILE_BUSY))
+    return;
+
+  sx = (tile%n_tx)*TERRAIN_TILE_SIZE + 1;
+  sy = (tile/n_tx)*TERRAIN_TILE_SIZE + 1;
+  ex = sx + TERRAIN_TILE_SIZE - 1;
+  ey = sy + TERRAIN_TILE_SIZE - 1;
+
+  if (cflag) {
+
+    if (ex > t->c_nx)
+      ex = t->c_nx;
+    if (ey > t->c_ny)
+      ey = t->c_ny;
+
+    for (i=sx; i<=ex; ++i) 
+      for (j=sy; j<=ey; ++j) 
+	if (__atomic_load_n(&(t->ccached[i][j]),__ATOMIC_RELAXED) == FALSE)
+	  cacheContactTerrainCell(ID, i, j, norm);
+
+  } else {
+
+    if (ex > t->nx)
+      ex = t->nx;
+    if (ey > t->ny)
+      ey = t->ny;
+
+    for (i=sx; i<=ex; ++i) 
+      for (j=sy; j<=ey; ++j) 
+	if (__atomic_load_n(&(t->cached[i][j]),__ATOMIC_RELAXED) == FALSE)
+	  cacheTerrainCell(ID, i, j, &tinfo);
+
+  }
+
+  // mark the tile as done and report the progress
+  pthread_mutex_lock( &mutex_cache );
+
+  *state = TILE_DONE;
+  ++t->n_tiles_done;
+
+  n_tiles = t->n_tx*t->n_ty;
+  if (t->reg_crad != 0)
+    n_tiles += t->c_n_tx*t->c_n_ty;
+
+  if (t->n_tiles_done == n_tiles)
+    printf("Caching terrain %s finished\n",t->tfname);
+  else if ((4*t->n_tiles_done)/n_tiles != (4*(t->n_tiles_done-1))/n_tiles)
+    printf("Caching terrain %s %d%% done\n",t->tfname,(100*t->n_tiles_done)/n_tiles);
+
+  pthread_cond_broadcast( &cond_cache );
+  pthread_mutex_unlock( &mutex_cache );
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  waitForTerrainTile
+\date  Oct 2026
+   
+\remarks 
+
+        returns after a tile is cached. A pending tile is processed by the 
+        calling thread, and for a tile in progress, the function waits until
+        the processing thread is done.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a tile of the contact grid
+ \param[in]     tile    : index of the tile
+
+ ******************************************************************************/
+static void
+waitForTerrainTile(int ID, int cflag, int tile)
+{
+  int     *state;
+  Terrain *t = TERRAIN_PTR(ID);
+
+  if (cflag)
+    state = &(t->ctiles[tile]);
+  else
+    state = &(t->tiles[tile]);
+
+  processTerrainTile(ID,cflag,tile);
+
+  pthread_mutex_lock( &mutex_cache );
+  while (*state != TILE_DONE)
+    pthread_cond_wait( &cond_cache, &mutex_cache );
+  pthread_mutex_unlock( &mutex_cache );
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainCacheProgress
+\date  Oct 2026
+   
+\remarks 
+
+        returns the fraction of cached tiles of a terrain, or of all terrains
+        for ID=0
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID       : terrain array index (0 for all terrains)
+ \param[out]    progress : fraction of cached tiles in [0,1]
+
+     Returns TRUE if all tiles are cached, or FALSE otherwise.
+
+ ******************************************************************************/
+int
+getTerrainCacheProgress(int ID, double *progress)
+{
+  int      i;
+  int      n_tiles = 0;
+  int      n_done  = 0;
+  Terrain *t;
+
+  if (ID < 0 || ID > n_terrains) {
+    printf("Terrain %d out of range of terrains from 0-%d\n",ID,n_terrains);
+    *progress = 0.0;
+    return FALSE;
+  }
+
+  pthread_mutex_lock( &mutex_cache );
+
+  for (i=1; i<=n_terrains; ++i) {
+
+    t = TERRAIN_PTR(i);
+
+    if (!t->status || (ID != 0 && ID != i))
+      continue;
+
+    n_tiles += t->n_tx*t->n_ty;
+    if (t->reg_crad != 0)
+      n_tiles += t->c_n_tx*t->c_n_ty;
+    n_done  += t->n_tiles_done;
+
+  }
+
+  pthread_mutex_unlock( &mutex_cache );
+
+  if (n_tiles == 0)
+    *progress = 1.0;
+  else
+    *progress = (double)n_done/(double)n_tiles;
+
+  return (n_done == n_tiles);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  waitForTerrainCache
+\date  Oct 2026
+   
+\remarks 
+
+        returns after the terrain info of all terrain boards is cached in
+        a given region in world coordinates, including the contact info
+        of the boards. Pending tiles in the region are processed by the 
+        calling thread, such that the function can also be used without
+        calling cacheTerrainInfo() before. For streamed boards, the tiles
+        of the region are loaded into the tile cache. Compact boards are
+        always cached.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     x_min    : min x of the region (world coordinates)
+ \param[in]     x_max    : max x of the region (world coordinates)
+ \param[in]     y_min    : min y of the region (world coordinates)
+ \param[in]     y_max    : max y of the region (world coordinates)
+
+     Returns TRUE if the region overlaps with any terrain board, or FALSE
+     if not.
+
+ ******************************************************************************/
+int
+waitForTerrainCache(double x_min, double x_max, double y_min, double y_max)
+{
+  int      i,j,k,ID;
+  int      sx,sy,ex,ey;
+  double   xl,yl,zl;
+  double   xl_min,xl_max,yl_min,yl_max;
+  double   cx[4],cy[4];
+  int      found_flag = FALSE;
+  Terrain *t;
+
+  cx[0] = x_min; cy[0] = y_min;
+  cx[1] = x_max; cy[1] = y_min;
+  cx[2] = x_min; cy[2] = y_max;
+  cx[3] = x_max; cy[3] = y_max;
+
+  for (ID=1; ID<=n_terrains; ++ID) {
+
+    t = TERRAIN_PTR(ID);
+
+    if (!t->status)
+      continue;
+
+    // the tiles of the terrain grid in world coordinates
+    sx = floor((x_min - t->xorg)/t->dx) + 1;
+    ex = ceil((x_max - t->xorg)/t->dx) + 1;
+    sy = floor((y_min - t->yorg)/t->dy) + 1;
+    ey = ceil((y_max - t->yorg)/t->dy) + 1;
+
+    if (sx < 1)
+      sx = 1;
+    if (sy < 1)
+      sy = 1;
+    if (ex > t->nx)
+      ex = t->nx;
+    if (ey > t->ny)
+      ey = t->ny;
+
+    if (sx <= ex && sy <= ey) {
+      found_flag = TRUE;
+      if (t->stream != NULL)
+	loadTerrainStreamTiles(ID,FALSE,sx,ex,sy,ey);
+      else if (t->compact == NULL)
+	for (i=(sx-1)/TERRAIN_TILE_SIZE; i<=(ex-1)/TERRAIN_TILE_SIZE; ++i)
+	  for (j=(sy-1)/TERRAIN_TILE_SIZE; j<=(ey-1)/TERRAIN_TILE_SIZE; ++j)
+	    waitForTerrainTile(ID,FALSE,i+j*t->n_tx);
+    }
+
+    if (t->reg_crad == 0)
+      continue;
+
+    // the tiles of the contact grid from the bounding box of the region in
+    // local board coordinates
+    xl_min = yl_min =  1.e10;
+    xl_max = yl_max = -1.e10;
+    for (k=0; k<4; ++k) {
+      getTerrainLocalCoordinatesID(cx[k],cy[k],t->pos.x[_Z_],t->ID,&xl,&yl,&zl);
+      if (xl < xl_min)
+	xl_min = xl;
+      if (xl > xl_max)
+	xl_max = xl;
+      if (yl < yl_min)
+	yl_min = yl;
+      if (yl > yl_max)
+	yl_max = yl;
+    }
+
+    sx = floor((xl_min - t->c_dxorg)/t->dx) + 1;
+    ex = ceil((xl_max - t->c_dxorg)/t->dx) + 1;
+    sy = floor((yl_min - t->c_dyorg)/t->dy) + 1;
+    ey = ceil((yl_max - t->c_dyorg)/t->dy) + 1;
+
+    if (sx < 1)
+      sx = 1;
+    if (sy < 1)
+      sy = 1;
+    if (ex > t->c_nx)
+      ex = t->c_nx;
+    if (ey > t->c_ny)
+      ey = t->c_ny;
+
+    if (sx <= ex && sy <= ey) {
+      found_flag = TRUE;
+      if (t->stream != NULL)
+	loadTerrainStreamTiles(ID,TRUE,sx,ex,sy,ey);
+      else if (t->compact == NULL)
+	for (i=(sx-1)/TERRAIN_TILE_SIZE; i<=(ex-1)/TERRAIN_TILE_SIZE; ++i)
+	  for (j=(sy-1)/TERRAIN_TILE_SIZE; j<=(ey-1)/TERRAIN_TILE_SIZE; ++j)
+	    waitForTerrainTile(ID,TRUE,i+j*t->c_n_tx);
+    }
+
+  }
+
+  return found_flag;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  fillTerrainPadding
+\date  April 2006
+   
+\remarks 
+
+        Computes the z values for the padded terrain locations. The 
+        caching threads are paused meanwhile, as boards can be added
+        while the terrain info is cached.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+         none
+
+ ******************************************************************************/
+void
+fillTerrainPadding(void)
+{
+
+  int          i,j,m,n;
+  Terrain      *t;
+  TerrainInfo  tinfo;
+  int          ID;
+  double       vl[N_CART+1];
+
+  pauseTerrainCache();
+  
+  // loop over all terrain boards and try to find whether query point is
+  // covered by the given board
+  for (ID=1; ID<=n_terrains; ++ID) {
+
+    // use a simpler variable for convenience and check for active terrain board
+    t = TERRAIN_PTR(ID);
+
+    // streamed and compact boards cannot be modified
+    if (!t->status || TERRAIN_PRECOMPUTED(t))
+      continue;
+
+    printf("Padding board %s ...",t->tfname);
+    fflush(stdout);
+
+    // loop over all padded terrain states
+    for (i=1; i<=t->padx; ++i) {
       for (j=1; j<=t->ny; ++j) {
 	// get terrain z 
 	vl[_X_] = (i-1)*t->dx+t->xorg;
@@ -1414,273 +3602,2223 @@ fillTerrainPadding(void)
 	//t->z[i][j] = ground_level_z;
       }
     }
-    
-    for (i=t->nx-t->padx+1; i<=t->nx; ++i) {
-      for (j=1; j<=t->ny; ++j) {
-	// compute query in world coordinates
-	vl[_X_] = (i-1)*t->dx+t->xorg;
-	vl[_Y_] = (j-1)*t->dy+t->yorg;
-	vl[_Z_] = 0.0;
-	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
-	t->z[i][j] = tinfo.z;
-	//t->z[i][j] = ground_level_z;
-      }
+    
+    for (i=t->nx-t->padx+1; i<=t->nx; ++i) {
+      for (j=1; j<=t->ny; ++j) {
+	// compute query in world coordinates
+	vl[_X_] = (i-1)*t->dx+t->xorg;
+	vl[_Y_] = (j-1)*t->dy+t->yorg;
+	vl[_Z_] = 0.0;
+	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
+	t->z[i][j] = tinfo.z;
+	//t->z[i][j] = ground_level_z;
+      }
+    }
+
+    for (i=t->padx+1; i<=t->nx-t->padx; ++i) {
+      for (j=1; j<=t->pady; ++j) {
+	// compute query in world coordinates
+	vl[_X_] = (i-1)*t->dx+t->xorg;
+	vl[_Y_] = (j-1)*t->dy+t->yorg;
+	vl[_Z_] = 0.0;
+	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
+	t->z[i][j] = tinfo.z;
+	//t->z[i][j] = ground_level_z;
+      }
+    }
+    
+    for (i=t->padx+1; i<=t->nx-t->padx; ++i) {
+      for (j=t->ny-t->pady+1; j<=t->ny; ++j) {
+	// compute query in world coordinates
+	vl[_X_] = (i-1)*t->dx+t->xorg;
+	vl[_Y_] = (j-1)*t->dy+t->yorg;
+	vl[_Z_] = 0.0;
+	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
+	t->z[i][j] = tinfo.z;
+	//t->z[i][j] = ground_level_z;
+      }
+    }
+
+    // the regression tables of z need to be rebuilt with the padding
+    freeTerrainSAT(&(t->sat));
+
+    printf(" done\n");
+    
+  }
+
+  resumeTerrainCache();
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  read_terrain_file
+\date  April 2006
+   
+\remarks 
+
+        reads a terrain file into a temporary array, and returns admin
+        variables
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : terrain file name
+ \param[in,out] array   : pointer to array -- memory will be allocated 
+ \param[out]    nx      : number of x values in array
+ \param[out]    ny      : number of y values in array
+ \param[out]    min_x,max_x,min_y,max_y : min max values of array
+ \param[in]     flag    : if TRUE binary terrain file is created if needed
+                     but nothing else is done or returned (i.e., array
+                     will not be allocated)
+ \param[out]    count   : the number elements in array
+
+ ******************************************************************************/
+int
+read_terrain_file(char *fname, Matrix *array,
+		  int *nx, int *ny, double *min_x, double *max_x,
+		  double *min_y, double *max_y, int flag, int *count)
+
+{
+  int     i,j,rc;
+  FILE   *fp;
+  double  x,y,z,no_go;
+  char    string[100];
+  char    command[1000];
+  Matrix  temp;
+  int     temp_size = 500000;
+  char    c;
+  int     ic;
+  int     n_line_items=3;
+  struct  stat sobj;
+  struct  stat s;
+  struct  stat sbin;
+
+
+  // try to open the ascii version of file and check how many columns exist
+  fp = fopen(fname,"r");
+  if (fp != NULL) {
+    // test whether a no-go column exists
+    ic = 0;
+    while (ic < 100 && (string[ic++]=fgetc(fp)) != '\n')
+      ;
+    string[ic-1] = '\0';
+    if (sscanf(string,"%lf %lf %lf %lf",&x,&y,&z,&no_go) == 3)
+      n_line_items = 3;
+    else
+      n_line_items = 4;
+    fclose(fp);
+  }
+
+  // try to open the noisy .xyz file
+  strcpy(string,fname);
+  i=strlen(string);
+  string[i-3]='x';
+  string[i-2]='y';
+  string[i-1]='z';
+  
+  if (stat(string,&sobj) == 0) { // the file exists
+
+    // check date in comparison to .asc file and regenerate .asc if needed
+    stat(fname,&s);
+    if (sobj.st_mtime > s.st_mtime || n_line_items != 4) // need update
+    {
+      snprintf(command, 1000, "xundegrade %s %s", string, fname);
+      printf("Trying to process noisy file with command: %s\n", command);
+      rc=system(command);
+    }
+  }
+
+  // try to open *.obj version of file
+  strcpy(string,fname);
+  i=strlen(string);
+  string[i-3]='o';
+  string[i-2]='b';
+  string[i-1]='j';
+
+  if (stat(string,&sobj) == 0) { // the file exists
+
+    // check date in comparison to .asc file and regenerate .asc if needed
+    stat(fname,&s);
+    if (sobj.st_mtime > s.st_mtime || n_line_items != 4) // need update
+      convertObj2Asc(string);
+  }
+
+  // try to open binary version of file
+  sprintf(string,"%s.bin",fname);
+  fp = fopen(string,"r");
+
+  if (fp != NULL) {
+
+    // check whether the .bin file is still up to date 
+    stat(fname,&s);
+    stat(string,&sbin);
+
+    if (s.st_mtime > sbin.st_mtime) { // process asc file
+
+      fclose(fp);
+
+    } else { // continue processing bin file
+
+      if (flag) {
+	fclose(fp);
+	return TRUE;
+      }
+
+      rc=fscanf(fp,"%d %d %d %lf %lf %lf %lf",
+	     count,nx,ny,min_x,max_x,min_y,max_y);
+      fgetc(fp);
+      temp = my_matrix(1,*count,1,4);
+      fread_mat(fp,temp);
+      fclose(fp);
+      
+      *array = temp;
+
+      return TRUE;
+
+    }
+
+  }
+
+  // try to open the ascii version of file
+  fp = fopen(fname,"r");
+  if (fp == NULL) {
+    if (!flag)
+      printf("Cannot read terrain file >%s<\n",fname);
+    return FALSE;
+  }
+
+  *count = 0;
+  *max_x = -1.e10;
+  *min_x =  1.e10;
+  *max_y = -1.e10;
+  *min_y =  1.e10;
+
+  temp    = my_matrix(1,temp_size,1,4);
+
+  // test whether a no-go column exists
+  ic = 0;
+  while (ic < 100 && (string[ic++]=fgetc(fp)) != '\n')
+    ;
+  string[ic-1] = '\0';
+  if (sscanf(string,"%lf %lf %lf %lf",&x,&y,&z,&no_go) == 3)
+    n_line_items = 3;
+  else
+    n_line_items = 4;
+
+  //printf("string = >%s< %d\n",string,n_line_items);
+
+  rewind(fp);
+
+
+  while (TRUE) {
+
+    if (n_line_items == 3) {
+      if ((rc=fscanf(fp,"%lf %lf %lf",&x,&y,&z)) == EOF)
+	break;
+      no_go = FALSE;
+    } else {
+      if ((rc=fscanf(fp,"%lf %lf %lf %lf",&x,&y,&z,&no_go)) == EOF)
+	break;
+    }
+
+    if (++(*count) > temp_size) {
+      mat_add_shape(&temp,100000,0);
+      temp_size += 100000;
+    }
+    temp[*count][1] = x;
+    temp[*count][2] = y;
+    temp[*count][3] = z;
+    temp[*count][4] = no_go;
+
+    if (x > *max_x)
+      *max_x = x;
+    if (x < *min_x)
+      *min_x = x;
+    if (y > *max_y)
+      *max_y = y;
+    if (y < *min_y)
+      *min_y = y;
+
+  }
+
+  fclose(fp);
+
+  // determine the correct dimensions of the terrain file assuming a mm raster
+  *nx = rint(*max_x - *min_x) + 1;
+  *ny = rint(*max_y - *min_y) + 1;
+
+  // fudge the matrix size -- this won't hurt anybody
+  temp[0][0] = *count;
+
+  // write terrain file as binary file for quicker future processing
+  sprintf(string,"%s.bin",fname);
+  fp = fopen(string,"w");
+  if (fp == NULL) {
+    printf("Cannot write terrain file >%s<\n",string);
+    return FALSE;
+  }
+
+  fprintf(fp,"%d %d %d %lf %lf %lf %lf\n",
+	  *count,*nx,*ny,*min_x,*max_x,*min_y,*max_y);
+  fwrite_mat(fp,temp);
+  fclose(fp);
+
+  if (flag) {
+    my_free_matrix(temp,1,*count,1,4);
+    return TRUE;
+  }
+
+
+  *array = temp;
+
+
+  return TRUE;
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  checkTerrainGridFile
+\date  Oct 2026
+   
+\remarks 
+
+        checks whether a terrain grid file exists and is up to date w.r.t.
+        the terrain file, and the .xyz and .obj files from which the terrain
+        file can be generated. A grid file without terrain file is valid.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : terrain file name
+ \param[in]     gname   : terrain grid file name
+
+        returns TRUE if the grid file can be used
+
+ ******************************************************************************/
+static int
+checkTerrainGridFile(char *fname, char *gname)
+{
+#ifdef UNIX
+  int         i;
+  char        string[200];
+  struct stat sgrid;
+  struct stat s;
+
+  if (stat(gname,&sgrid) != 0)
+    return FALSE;
+
+  if (stat(fname,&s) == 0 && s.st_mtime > sgrid.st_mtime)
+    return FALSE;
+
+  strcpy(string,fname);
+  i=strlen(string);
+  if (i < 3)
+    return TRUE;
+
+  string[i-3]='x';
+  string[i-2]='y';
+  string[i-1]='z';
+  if (stat(string,&s) == 0 && s.st_mtime > sgrid.st_mtime)
+    return FALSE;
+
+  string[i-3]='o';
+  string[i-2]='b';
+  string[i-1]='j';
+  if (stat(string,&s) == 0 && s.st_mtime > sgrid.st_mtime)
+    return FALSE;
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainGridLayer
+\date  Oct 2026
+   
+\remarks 
+
+        returns a matrix view of a layer of a memory mapped terrain grid 
+        file, or NULL if the file has no such layer. Only the row pointers
+        are allocated, and they need to be freed with free().
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     g       : the memory mapped terrain grid file
+ \param[in]     layer   : the layer (TG_Z, TG_NO_GO, ...)
+
+ ******************************************************************************/
+static fMatrix
+getTerrainGridLayer(TerrainGrid *g, int layer)
+{
+  int      i;
+  float   *data;
+  fMatrix  m;
+
+  if (g->h->offset[layer] == 0)
+    return NULL;
+
+  data = (float *)((char *)g->base + g->h->offset[layer]);
+  m    = (fMatrix)my_calloc(g->h->nx+1,sizeof(float *),MY_STOP);
+  for (i=1; i<=g->h->nx; ++i)
+    m[i] = data + (i-1)*g->h->ny - 1;
+
+  return m;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  mapTerrainGrid
+\date  Oct 2026
+   
+\remarks 
+
+        maps a terrain grid file into memory and initializes the local
+        board of a terrain from it. The mapping is private and copy-on-write,
+        such that all processes using the same file share its pages as long
+        as they do not modify the terrain.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     gname   : terrain grid file name
+ \param[in,out] t       : the terrain 
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+static int
+mapTerrainGrid(char *gname, Terrain *t)
+{
+#ifdef UNIX
+  int                k;
+  int                fd;
+  void              *base;
+  struct stat        s;
+  TerrainGridHeader *h;
+  TerrainGrid       *g;
+
+  if ((fd = open(gname,O_RDONLY)) < 0)
+    return FALSE;
+
+  if (fstat(fd,&s) != 0 || s.st_size < (off_t)sizeof(TerrainGridHeader)) {
+    close(fd);
+    return FALSE;
+  }
+
+  base = mmap(NULL,s.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    printf("Cannot map terrain grid file >%s<\n",gname);
+    return FALSE;
+  }
+
+  // check the header and the layers
+  h = (TerrainGridHeader *)base;
+  if (strncmp(h->magic,TERRAIN_GRID_MAGIC,8) != 0 || 
+      h->version != TERRAIN_GRID_VERSION ||
+      h->byte_order != 0x01020304 || 
+      h->header_size != sizeof(TerrainGridHeader) ||
+      h->nx < 2 || h->ny < 2 ||
+      h->offset[TG_Z] == 0 || h->offset[TG_NO_GO] == 0) {
+    printf("Terrain grid file >%s< has an incompatible format\n",gname);
+    munmap(base,s.st_size);
+    return FALSE;
+  }
+
+  for (k=0; k<TERRAIN_GRID_N_LAYERS; ++k)
+    if (h->offset[k] != 0 && 
+	(h->offset[k] < h->header_size || 
+	 h->offset[k] + (long long)h->nx*h->ny*(long long)sizeof(float) > (long long)s.st_size)) {
+      printf("Terrain grid file >%s< is truncated\n",gname);
+      munmap(base,s.st_size);
+      return FALSE;
+    }
+
+  g = (TerrainGrid *)my_calloc(1,sizeof(TerrainGrid),MY_STOP);
+  g->base = base;
+  g->size = s.st_size;
+  g->h    = h;
+
+  t->grid        = g;
+  t->nx_local    = h->nx;
+  t->ny_local    = h->ny;
+  t->dx          = h->dx;
+  t->dy          = h->dy;
+  t->dxorg_local = h->dxorg;
+  t->dyorg_local = h->dyorg;
+  t->z_local     = getTerrainGridLayer(g,TG_Z);
+  t->no_go_local = getTerrainGridLayer(g,TG_NO_GO);
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  writeTerrainGrid
+\date  Oct 2026
+   
+\remarks 
+
+        writes the local board of a terrain as terrain grid file, optionally 
+        with precomputed layers. The file is written under a temporary name
+        and renamed afterwards, such that existing mappings of the file 
+        remain valid.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     gname   : terrain grid file name
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     layers  : the precomputed layers in local board coordinates
+                          (NULL or NULL entries for none)
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+static int
+writeTerrainGrid(char *gname, int ID, fMatrix *layers)
+{
+  int                i,k;
+  long long          pos;
+  long long          size;
+  char               tname[200];
+  char               zeros[TERRAIN_GRID_ALIGN];
+  FILE              *fp;
+  fMatrix            m[TERRAIN_GRID_N_LAYERS];
+  TerrainGridHeader  h;
+  Terrain           *t = TERRAIN_PTR(ID);
+
+  bzero((void *)&h,sizeof(h));
+  bzero((void *)zeros,sizeof(zeros));
+  strncpy(h.magic,TERRAIN_GRID_MAGIC,8);
+  h.version     = TERRAIN_GRID_VERSION;
+  h.byte_order  = 0x01020304;
+  h.header_size = sizeof(TerrainGridHeader);
+  h.nx          = t->nx_local;
+  h.ny          = t->ny_local;
+  h.dx          = t->dx;
+  h.dy          = t->dy;
+  h.dxorg       = t->dxorg_local;
+  h.dyorg       = t->dyorg_local;
+  if (layers != NULL) {
+    h.reg_rad   = t->reg_rad;
+    h.reg_down  = t->reg_down;
+    h.reg_crad  = t->reg_crad;
+  }
+
+  // the layout of the file
+  size = (((long long)h.nx*h.ny*sizeof(float)+TERRAIN_GRID_ALIGN-1)/TERRAIN_GRID_ALIGN)*
+    TERRAIN_GRID_ALIGN;
+  pos  = ((sizeof(h)+TERRAIN_GRID_ALIGN-1)/TERRAIN_GRID_ALIGN)*TERRAIN_GRID_ALIGN;
+  for (k=0; k<TERRAIN_GRID_N_LAYERS; ++k) {
+    if (k == TG_Z)
+      m[k] = t->z_local;
+    else if (k == TG_NO_GO)
+      m[k] = t->no_go_local;
+    else
+      m[k] = (layers != NULL) ? layers[k] : NULL;
+    if (m[k] != NULL) {
+      h.offset[k] = pos;
+      pos += size;
+    }
+  }
+
+  sprintf(tname,"%s.tmp",gname);
+  fp = fopen(tname,"w");
+  if (fp == NULL) {
+    printf("Cannot write terrain grid file >%s<\n",tname);
+    return FALSE;
+  }
+
+  fwrite(&h,sizeof(h),1,fp);
+  pos = sizeof(h);
+  for (k=0; k<TERRAIN_GRID_N_LAYERS; ++k) {
+    if (m[k] == NULL)
+      continue;
+    fwrite(zeros,1,h.offset[k]-pos,fp);
+    for (i=1; i<=h.nx; ++i)
+      fwrite(&(m[k][i][1]),sizeof(float),h.ny,fp);
+    pos = h.offset[k] + (long long)h.nx*h.ny*sizeof(float);
+  }
+
+  if (fclose(fp) != 0 || rename(tname,gname) != 0) {
+    printf("Cannot write terrain grid file >%s<\n",gname);
+    remove(tname);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  applyTerrainGridLayers
+\date  Oct 2026
+   
+\remarks 
+
+        initializes the terrain info cache from the precomputed layers of a
+        terrain grid file. Only cells whose regression neighborhood is inside
+        the local board are used, as the info of the other cells depends on
+        the padding. The foothold layers can only be used if the board is
+        not rotated, in which case the terrain in world coordinates is a 
+        shifted copy of the local board. All layers require that they were
+        computed with the regression parameters of the terrain.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+ ******************************************************************************/
+static void
+applyTerrainGridLayers(int ID)
+{
+  int                i,j,m,n,k;
+  int                r,ox,oy;
+  int                count = 0;
+  float             *l[TERRAIN_GRID_N_LAYERS];
+  Terrain           *t = TERRAIN_PTR(ID);
+  TerrainGridHeader *h = t->grid->h;
+
+  for (k=0; k<TERRAIN_GRID_N_LAYERS; ++k)
+    l[k] = (h->offset[k] == 0) ? NULL : (float *)((char *)t->grid->base + h->offset[k]);
+
+  // the contact normals
+  if (l[TG_CN_X] != NULL && l[TG_CN_Y] != NULL && l[TG_CN_Z] != NULL &&
+      h->reg_crad == t->reg_crad && t->reg_crad > 0) {
+
+    r = t->reg_crad;
+    for (i=1+r; i<=t->nx_local-r; ++i)
+      for (j=1+r; j<=t->ny_local-r; ++j) {
+	k = (i-1)*t->ny_local + j-1;
+	m = i+t->c_padx;
+	n = j+t->c_pady;
+	t->cn_x[m][n]    = l[TG_CN_X][k];
+	t->cn_y[m][n]    = l[TG_CN_Y][k];
+	t->cn_z[m][n]    = l[TG_CN_Z][k];
+	t->ccached[m][n] = TRUE;
+	++count;
+      }
+
+  }
+
+  // the foothold info
+  if (l[TG_FZ] != NULL && l[TG_PZ] != NULL && l[TG_N_X] != NULL && l[TG_N_Y] != NULL &&
+      l[TG_N_Z] != NULL && l[TG_N_NMSE] != NULL &&
+      h->reg_rad == t->reg_rad && h->reg_down == t->reg_down && t->reg_down > 0 &&
+      fabs(t->orient.q[_Q0_]) >= 1.0-1.e-12) {
+
+    r = rint(((double)t->reg_rad)/((double)t->reg_down))*t->reg_down;
+    if (r < t->reg_frad)
+      r = t->reg_frad;
+
+    // the offset of the local board in the terrain in world coordinates
+    ox = rint((t->dxorg_local + t->pos.x[_X_] - t->xorg)/t->dx);
+    oy = rint((t->dyorg_local + t->pos.x[_Y_] - t->yorg)/t->dy);
+
+    for (i=1+r; i<=t->nx_local-r; ++i)
+      for (j=1+r; j<=t->ny_local-r; ++j) {
+	m = i+ox;
+	n = j+oy;
+	if (m-r <= t->padx || m+r > t->nx-t->padx || n-r <= t->pady || n+r > t->ny-t->pady)
+	  continue;
+	k = (i-1)*t->ny_local + j-1;
+	t->fz[m][n]     = l[TG_FZ][k] + t->pos.x[_Z_];
+	t->pz[m][n]     = l[TG_PZ][k] + t->pos.x[_Z_];
+	t->n_x[m][n]    = l[TG_N_X][k];
+	t->n_y[m][n]    = l[TG_N_Y][k];
+	t->n_z[m][n]    = l[TG_N_Z][k];
+	t->n_nMSE[m][n] = l[TG_N_NMSE][k];
+	t->cached[m][n] = TRUE;
+	++count;
+      }
+
+  }
+
+  if (count > 0)
+    printf("Used %d precomputed cells of terrain %s\n",count,t->tfname);
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  convertTerrainBoard
+\date  Oct 2026
+   
+\remarks 
+
+        converts a terrain file into a terrain grid file, which includes the 
+        contact normals and foothold info precomputed for the given 
+        regression parameters. These layers are used by setTerrainInfo() if
+        the regression parameters agree. Boards with holes at the fringe 
+        are written without precomputed layers, as the terrain info around 
+        holes depends on the pose of the board.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     tfname  : terrain file name (in the TERRAINS directory)
+ \param[in]     reg_rad : radius used for regression on terrain (0: no foothold info)
+ \param[in]     reg_down: down sampling for computing the regression
+ \param[in]     reg_crad: regression radius used for contacts (0: no contact normals)
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+int
+convertTerrainBoard(char *tfname, int reg_rad, int reg_down, int reg_crad)
+{
+  int          i,j,k,m,n;
+  int          ID;
+  int          ox,oy;
+  int          holes = FALSE;
+  char         string[200];
+  char         gname[200];
+  double       pos[N_CART+1];
+  double       orient[N_QUAT+1];
+  double       norm[N_CART+1];
+  fMatrix      layers[TERRAIN_GRID_N_LAYERS];
+  Terrain     *t;
+  TerrainInfo  tinfo;
+
+  if ((ID = getNextTerrainID()) == FALSE) {
+    printf("No free terrain for the conversion of %s\n",tfname);
+    return FALSE;
+  }
+  t = TERRAIN_PTR(ID);
+
+  if (reg_rad > 0 && reg_down < 1) {
+    printf("Invalid down sampling %d for terrain %s\n",reg_down,tfname);
+    return FALSE;
+  }
+
+  // read the board, which writes a terrain grid file without precomputed
+  // layers, and check for holes
+  sprintf(string,"%s%s",TERRAINS,tfname);
+  sprintf(gname,"%s%s",string,TERRAIN_GRID_EXT);
+  if (!readTerrainBoard(string,ID))
+    return FALSE;
+  for (i=1; i<=t->nx_local; ++i)
+    for (j=1; j<=t->ny_local; ++j)
+      if (t->z_local[i][j] == EMPTY_TERRAIN)
+	holes = TRUE;
+  freeTerrainBoard(ID);
+
+  if (holes) {
+    printf("Terrain %s has holes -- wrote %s without precomputed layers\n",tfname,gname);
+    return TRUE;
+  }
+
+  // create the board at the origin -- it is removed again below
+  for (i=1; i<=N_CART; ++i)
+    pos[i] = 0.0;
+  for (i=1; i<=N_QUAT; ++i)
+    orient[i] = 0.0;
+  orient[_Q0_] = 1.0;
+
+  if (!setTerrainInfoSwitched(ID,ID,tfname,pos,orient,reg_rad,reg_down,reg_crad,FALSE))
+    return FALSE;
+
+  for (k=0; k<TERRAIN_GRID_N_LAYERS; ++k)
+    layers[k] = NULL;
+
+  // the contact normals
+  if (reg_crad > 0) {
+    for (k=TG_CN_X; k<=TG_CN_Z; ++k)
+      layers[k] = my_fmatrix(1,t->nx_local,1,t->ny_local);
+    for (i=1; i<=t->nx_local; ++i)
+      for (j=1; j<=t->ny_local; ++j) {
+	cacheContactTerrainCell(ID,i+t->c_padx,j+t->c_pady,norm);
+	layers[TG_CN_X][i][j] = norm[_X_];
+	layers[TG_CN_Y][i][j] = norm[_Y_];
+	layers[TG_CN_Z][i][j] = norm[_Z_];
+      }
+  }
+
+  // the foothold info on the local board
+  if (reg_rad > 0) {
+    for (k=TG_FZ; k<=TG_N_NMSE; ++k)
+      layers[k] = my_fmatrix(1,t->nx_local,1,t->ny_local);
+    ox = rint((t->dxorg_local - t->xorg)/t->dx);
+    oy = rint((t->dyorg_local - t->yorg)/t->dy);
+    for (i=1; i<=t->nx_local; ++i)
+      for (j=1; j<=t->ny_local; ++j) {
+	m = i+ox;
+	n = j+oy;
+	if (m < 1 || m > t->nx || n < 1 || n > t->ny)
+	  continue;
+	cacheTerrainCell(ID,m,n,&tinfo);
+	layers[TG_FZ][i][j]     = tinfo.fz;
+	layers[TG_PZ][i][j]     = tinfo.pz;
+	layers[TG_N_X][i][j]    = tinfo.n[_X_];
+	layers[TG_N_Y][i][j]    = tinfo.n[_Y_];
+	layers[TG_N_Z][i][j]    = tinfo.n[_Z_];
+	layers[TG_N_NMSE][i][j] = tinfo.n_nMSE;
+      }
+  }
+
+  k = writeTerrainGrid(gname,ID,layers);
+  if (k)
+    printf("Wrote terrain grid file >%s<\n",gname);
+
+  for (i=0; i<TERRAIN_GRID_N_LAYERS; ++i)
+    if (layers[i] != NULL)
+      my_free_fmatrix(layers[i],1,t->nx_local,1,t->ny_local);
+  removeTerrainBoard(ID);
+
+  return k;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  convertTerrainTiles
+\date  Oct 2026
+   
+\remarks 
+
+        converts a terrain file into a tiled terrain file, from which 
+        setTerrainInfo() streams the board if the regression parameters 
+        agree and the board is not rotated. All terrain info is precomputed
+        for the board at the origin, which needs the whole board in memory
+        once. Streamed boards only keep the tiles around the recent queries
+        in memory, within the budget of the tile cache. Boards with holes 
+        at the fringe cannot be converted, as their terrain info depends on
+        the pose of the board.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     tfname  : terrain file name (in the TERRAINS directory)
+ \param[in]     reg_rad : radius used for regression on terrain
+ \param[in]     reg_down: down sampling for computing the regression
+ \param[in]     reg_crad: regression radius used for contacts
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+int
+convertTerrainTiles(char *tfname, int reg_rad, int reg_down, int reg_crad)
+{
+  int          i,j,k;
+  int          ID;
+  int          holes = FALSE;
+  char         string[200];
+  char         tname[200];
+  double       pos[N_CART+1];
+  double       orient[N_QUAT+1];
+  Terrain     *t;
+
+  if (reg_down < 1) {
+    printf("Invalid down sampling %d for terrain %s\n",reg_down,tfname);
+    return FALSE;
+  }
+
+  if ((ID = getNextTerrainID()) == FALSE) {
+    printf("No free terrain for the conversion of %s\n",tfname);
+    return FALSE;
+  }
+  t = TERRAIN_PTR(ID);
+
+  // check for holes
+  sprintf(string,"%s%s",TERRAINS,tfname);
+  sprintf(tname,"%s%s",string,TERRAIN_TILES_EXT);
+  if (!readTerrainBoard(string,ID))
+    return FALSE;
+  for (i=1; i<=t->nx_local; ++i)
+    for (j=1; j<=t->ny_local; ++j)
+      if (t->z_local[i][j] == EMPTY_TERRAIN)
+	holes = TRUE;
+  freeTerrainBoard(ID);
+
+  if (holes) {
+    printf("Terrain %s has holes and cannot be streamed\n",tfname);
+    return FALSE;
+  }
+
+  // create the board at the origin -- it is removed again below
+  for (i=1; i<=N_CART; ++i)
+    pos[i] = 0.0;
+  for (i=1; i<=N_QUAT; ++i)
+    orient[i] = 0.0;
+  orient[_Q0_] = 1.0;
+
+  if (!setTerrainInfoSwitched(ID,ID,tfname,pos,orient,reg_rad,reg_down,reg_crad,FALSE))
+    return FALSE;
+
+  // cache all terrain info with the caching threads and this thread
+  cacheTerrainInfo();
+  for (k=0; k<t->n_tx*t->n_ty; ++k)
+    waitForTerrainTile(ID,FALSE,k);
+  for (k=0; k<t->c_n_tx*t->c_n_ty; ++k)
+    waitForTerrainTile(ID,TRUE,k);
+
+  k = writeTerrainTiles(tname,ID);
+  if (k)
+    printf("Wrote tiled terrain file >%s<\n",tname);
+
+  removeTerrainBoard(ID);
+
+  return k;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  writeTerrainTiles
+\date  Oct 2026
+   
+\remarks 
+
+        writes the cached terrain info of a board at the origin without 
+        rotation as tiled terrain file. The file is written under a 
+        temporary name and renamed afterwards, such that streamed boards 
+        can keep reading the old file.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : tiled terrain file name
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+static int
+writeTerrainTiles(char *fname, int ID)
+{
+  int                i,j,k,m,n;
+  int                tx,ty,cflag;
+  int                nx,ny,n_tx,n_ty,n_layers;
+  char               tname[200];
+  char               zeros[TERRAIN_TILES_ALIGN];
+  float             *buf;
+  FILE              *fp;
+  fMatrix           *l;
+  fMatrix            layers[TERRAIN_TILE_N_LAYERS];
+  fMatrix            clayers[TERRAIN_CTILE_N_LAYERS];
+  TerrainTilesHeader h;
+  Terrain           *t = TERRAIN_PTR(ID);
+
+  layers[TT_Z]       = t->z;
+  layers[TT_NO_GO]   = t->no_go;
+  layers[TT_FZ]      = t->fz;
+  layers[TT_PZ]      = t->pz;
+  layers[TT_N_X]     = t->n_x;
+  layers[TT_N_Y]     = t->n_y;
+  layers[TT_N_Z]     = t->n_z;
+  layers[TT_N_NMSE]  = t->n_nMSE;
+  clayers[TT_C_Z]     = t->c_z;
+  clayers[TT_C_NO_GO] = t->c_no_go;
+  clayers[TT_CN_X]    = t->cn_x;
+  clayers[TT_CN_Y]    = t->cn_y;
+  clayers[TT_CN_Z]    = t->cn_z;
+
+  bzero((void *)&h,sizeof(h));
+  bzero((void *)zeros,sizeof(zeros));
+  strncpy(h.magic,TERRAIN_TILES_MAGIC,8);
+  h.version     = TERRAIN_TILES_VERSION;
+  h.byte_order  = 0x01020304;
+  h.header_size = sizeof(TerrainTilesHeader);
+  h.tile_size   = TERRAIN_STREAM_TILE;
+  h.nx          = t->nx;
+  h.ny          = t->ny;
+  h.padx        = t->padx;
+  h.pady        = t->pady;
+  h.c_nx        = t->c_nx;
+  h.c_ny        = t->c_ny;
+  h.c_padx      = t->c_padx;
+  h.c_pady      = t->c_pady;
+  h.reg_rad     = t->reg_rad;
+  h.reg_down    = t->reg_down;
+  h.reg_crad    = t->reg_crad;
+  h.dx          = t->dx;
+  h.dy          = t->dy;
+  h.xorg        = t->xorg;
+  h.yorg        = t->yorg;
+  h.c_dxorg     = t->c_dxorg;
+  h.c_dyorg     = t->c_dyorg;
+  h.min_z       = t->min_z;
+  h.max_z       = t->max_z;
+  h.ground_z    = ground_level_z;
+
+  // the max height of the contact grid without padding, as the height of 
+  // the padding depends on the board position
+  h.c_max_z = -1.e10;
+  for (i=1+t->c_padx; i<=t->c_nx-t->c_padx; ++i)
+    for (j=1+t->c_pady; j<=t->c_ny-t->c_pady; ++j)
+      if (t->c_z[i][j] > h.c_max_z)
+	h.c_max_z = t->c_z[i][j];
+
+  // the layout of the file
+  n_tx = (h.nx+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+  n_ty = (h.ny+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+  h.offset   = ((sizeof(h)+TERRAIN_TILES_ALIGN-1)/TERRAIN_TILES_ALIGN)*TERRAIN_TILES_ALIGN;
+  h.c_offset = h.offset + (long long)n_tx*n_ty*TERRAIN_TILE_N_LAYERS*
+    TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE*sizeof(float);
+
+  sprintf(tname,"%s.tmp",fname);
+  fp = fopen(tname,"w");
+  if (fp == NULL) {
+    printf("Cannot write tiled terrain file >%s<\n",tname);
+    return FALSE;
+  }
+
+  fwrite(&h,sizeof(h),1,fp);
+  fwrite(zeros,1,h.offset-sizeof(h),fp);
+
+  // the tiles of the terrain grid and of the contact grid
+  buf = (float *)my_calloc(TERRAIN_TILE_N_LAYERS*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE,
+			   sizeof(float),MY_STOP);
+
+  for (cflag=FALSE; cflag<=TRUE; ++cflag) {
+
+    if (cflag) {
+      l        = clayers;
+      n_layers = TERRAIN_CTILE_N_LAYERS;
+      nx       = h.c_nx;
+      ny       = h.c_ny;
+    } else {
+      l        = layers;
+      n_layers = TERRAIN_TILE_N_LAYERS;
+      nx       = h.nx;
+      ny       = h.ny;
+    }
+    n_tx = (nx+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+    n_ty = (ny+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+
+    for (ty=0; ty<n_ty; ++ty)
+      for (tx=0; tx<n_tx; ++tx) {
+	for (k=0; k<n_layers; ++k)
+	  for (i=0; i<TERRAIN_STREAM_TILE; ++i)
+	    for (j=0; j<TERRAIN_STREAM_TILE; ++j) {
+	      m = tx*TERRAIN_STREAM_TILE + i + 1;
+	      n = ty*TERRAIN_STREAM_TILE + j + 1;
+	      buf[(k*TERRAIN_STREAM_TILE+i)*TERRAIN_STREAM_TILE+j] = 
+		(m <= nx && n <= ny) ? l[k][m][n] : 0.0;
+	    }
+	fwrite(buf,sizeof(float),n_layers*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE,fp);
+      }
+
+  }
+
+  free(buf);
+
+  if (fclose(fp) != 0 || rename(tname,fname) != 0) {
+    printf("Cannot write tiled terrain file >%s<\n",fname);
+    remove(tname);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  openTerrainTiles
+\date  Oct 2026
+   
+\remarks 
+
+        initializes a terrain as streamed board from a tiled terrain file. 
+        No layers are allocated, and the tiles are read into the tile cache
+        when they are queried. The file needs to be computed with the given 
+        regression parameters, and the board must not be rotated, such that
+        the board is a shifted copy of the board in the file.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     fname   : tiled terrain file name
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     pos     : 3D position vector of terrain origin
+ \param[in]     orient  : 4D unit quaternion vector of terrain origin.
+ \param[in]     reg_rad : radius of points used in regression of normal
+ \param[in]     reg_down: down sampling for normal regression
+ \param[in]     reg_crad: radius of points used to comopute contact normal 
+
+        returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+static int
+openTerrainTiles(char *fname, int ID, double *pos, double *orient,
+		 int reg_rad, int reg_down, int reg_crad)
+{
+#ifdef UNIX
+  int                i;
+  int                fd;
+  int                gen;
+  long long          size;
+  struct stat        s;
+  TerrainTilesHeader h;
+  TerrainStream     *ts;
+  Terrain           *t = TERRAIN_PTR(ID);
+
+  if ((fd = open(fname,O_RDONLY)) < 0)
+    return FALSE;
+
+  if (fstat(fd,&s) != 0 || pread(fd,&h,sizeof(h),0) != (ssize_t)sizeof(h)) {
+    close(fd);
+    return FALSE;
+  }
+
+  // check the header and the size of the file
+  if (strncmp(h.magic,TERRAIN_TILES_MAGIC,8) != 0 || 
+      h.version != TERRAIN_TILES_VERSION ||
+      h.byte_order != 0x01020304 || 
+      h.header_size != sizeof(TerrainTilesHeader) ||
+      h.tile_size != TERRAIN_STREAM_TILE ||
+      h.nx < 1 || h.ny < 1 || h.c_nx < 1 || h.c_ny < 1) {
+    printf("Tiled terrain file >%s< has an incompatible format\n",fname);
+    close(fd);
+    return FALSE;
+  }
+
+  ts = (TerrainStream *)my_calloc(1,sizeof(TerrainStream),MY_STOP);
+  ts->n_tx   = (h.nx+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+  ts->n_ty   = (h.ny+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+  ts->c_n_tx = (h.c_nx+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+  ts->c_n_ty = (h.c_ny+TERRAIN_STREAM_TILE-1)/TERRAIN_STREAM_TILE;
+
+  size = (long long)TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE*sizeof(float);
+  if (h.offset < h.header_size ||
+      h.c_offset < h.offset + (long long)ts->n_tx*ts->n_ty*TERRAIN_TILE_N_LAYERS*size ||
+      s.st_size < h.c_offset + (long long)ts->c_n_tx*ts->c_n_ty*TERRAIN_CTILE_N_LAYERS*size) {
+    printf("Tiled terrain file >%s< is truncated\n",fname);
+    free(ts);
+    close(fd);
+    return FALSE;
+  }
+
+  if (h.reg_rad != reg_rad || h.reg_down != reg_down || h.reg_crad != reg_crad) {
+    printf("Tiled terrain file >%s< was computed with reg_rad=%d reg_down=%d reg_crad=%d\n",
+	   fname,h.reg_rad,h.reg_down,h.reg_crad);
+    free(ts);
+    close(fd);
+    return FALSE;
+  }
+
+  if (fabs(orient[_Q0_]) < 1.0-1.e-12) {
+    printf("Tiled terrain file >%s< cannot be used for a rotated board\n",fname);
+    free(ts);
+    close(fd);
+    return FALSE;
+  }
+
+  if (fabs(ground_level_z - pos[_Z_] - h.ground_z) > 1.e-6)
+    printf("Tiled terrain file >%s< assumes the ground at z=%f in the padding\n",
+	   fname,h.ground_z+pos[_Z_]);
+
+  ts->fd     = fd;
+  ts->h      = h;
+  ts->slot   = (int *)my_calloc(ts->n_tx*ts->n_ty,sizeof(int),MY_STOP);
+  ts->c_slot = (int *)my_calloc(ts->c_n_tx*ts->c_n_ty,sizeof(int),MY_STOP);
+  for (i=0; i<ts->n_tx*ts->n_ty; ++i)
+    ts->slot[i] = -1;
+  for (i=0; i<ts->c_n_tx*ts->c_n_ty; ++i)
+    ts->c_slot[i] = -1;
+
+  if (max_stream_slots == 0)
+    setTerrainTileCacheSize(stream_budget_mb);
+
+  // the board in world coordinates is a shifted copy of the board in the file
+  gen = t->gen;
+  bzero((void *)t,sizeof(Terrain));
+  t->gen    = gen;
+  t->stream = ts;
+
+  for (i=1; i<=N_CART; ++i)
+    t->pos.x[i] = pos[i];
+  for (i=1; i<=N_QUAT; ++i)
+    t->orient.q[i] = orient[i];
+
+  t->reg_rad     = reg_rad;
+  t->reg_down    = reg_down;
+  t->reg_crad    = reg_crad;
+  t->reg_frad    = RADIUS_FZ;
+  t->dx          = h.dx;
+  t->dy          = h.dy;
+  t->nx          = h.nx;
+  t->ny          = h.ny;
+  t->padx        = h.padx;
+  t->pady        = h.pady;
+  t->xorg        = h.xorg + pos[_X_];
+  t->yorg        = h.yorg + pos[_Y_];
+  t->min_z       = h.min_z + pos[_Z_];
+  t->max_z       = h.max_z + pos[_Z_];
+  t->c_nx        = h.c_nx;
+  t->c_ny        = h.c_ny;
+  t->c_padx      = h.c_padx;
+  t->c_pady      = h.c_pady;
+  t->c_dxorg     = h.c_dxorg;
+  t->c_dyorg     = h.c_dyorg;
+  t->nx_local    = h.c_nx - 2*h.c_padx;
+  t->ny_local    = h.c_ny - 2*h.c_pady;
+  t->dxorg_local = h.c_dxorg + h.dx*h.c_padx;
+  t->dyorg_local = h.c_dyorg + h.dy*h.c_pady;
+
+  // the padding of the contact grid is at the ground level
+  t->c_max_z = h.c_max_z;
+  if ((h.c_padx > 0 || h.c_pady > 0) && ground_level_z - pos[_Z_] > t->c_max_z)
+    t->c_max_z = ground_level_z - pos[_Z_];
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  closeTerrainTiles
+\date  Oct 2026
+   
+\remarks 
+
+        removes the tiles of a streamed board from the tile cache and 
+        closes its tiled terrain file. Like removing a board, this must not
+        be done while other threads query the terrain.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+ ******************************************************************************/
+static void
+closeTerrainTiles(int ID)
+{
+  int            k;
+  TerrainStream *ts = TERRAIN_PTR(ID)->stream;
+
+  pthread_mutex_lock( &mutex_stream );
+  for (k=0; k<n_stream_slots; ++k)
+    if (stream_slots[k].ID == ID) {
+      releaseTerrainStreamSlot(k);
+      free(stream_slots[k].data);
+      stream_slots[k].data = NULL;
+    }
+  pthread_mutex_unlock( &mutex_stream );
+
+#ifdef UNIX
+  close(ts->fd);
+#endif
+  free(ts->slot);
+  free(ts->c_slot);
+  free(ts);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  setTerrainTileCacheSize
+\date  Oct 2026
+   
+\remarks 
+
+        sets the memory budget of the tile cache of streamed boards. If the
+        loaded tiles exceed the new budget, the least recently used tiles 
+        are dropped. The default budget is TERRAIN_TILE_CACHE_MB, or the 
+        parameter pool keyword "terrain_tile_cache_mb". This must not be 
+        called while contact queries run, as the slots can be reallocated.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     mbytes  : the memory budget in MB
+
+ ******************************************************************************/
+void
+setTerrainTileCacheSize(double mbytes)
+{
+  int              k,n;
+  TerrainTileSlot *slots;
+
+  n = mbytes*1024.0*1024.0/
+    ((double)TERRAIN_TILE_N_LAYERS*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE*sizeof(float));
+  if (n < 1)
+    n = 1;
+
+  pthread_mutex_lock( &mutex_stream );
+
+  stream_budget_mb = mbytes;
+
+  // drop the least recently used tiles beyond the budget
+  while (n_stream_loaded > n)
+    if (!releaseTerrainStreamSlot(stream_lru_last))
+      break;
+
+  for (k=0; k<n_stream_slots; ++k)
+    if (stream_slots[k].ID == 0 && stream_slots[k].data != NULL) {
+      free(stream_slots[k].data);
+      stream_slots[k].data = NULL;
+    }
+
+  if (n > n_stream_slots) {
+    slots = (TerrainTileSlot *)my_calloc(n,sizeof(TerrainTileSlot),MY_STOP);
+    if (stream_slots != NULL) {
+      memcpy(slots,stream_slots,n_stream_slots*sizeof(TerrainTileSlot));
+      free(stream_slots);
+    }
+    stream_slots   = slots;
+    n_stream_slots = n;
+  }
+  max_stream_slots = n;
+
+  pthread_mutex_unlock( &mutex_stream );
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainStreamSlot
+\date  Oct 2026
+   
+\remarks 
+
+        returns the slot of a tile of a streamed board in the tile cache, 
+        and reads the tile from the tiled terrain file if it is not loaded.
+        If the budget is exhausted, the least recently used tile that is 
+        not pinned by a contact query is replaced. The tile becomes the most
+        recently used tile. Must be called with mutex_stream locked.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a tile of the contact grid
+ \param[in]     tile    : index of the tile
+
+        returns the slot, or -1 if the tile cannot be read
+
+ ******************************************************************************/
+static int
+getTerrainStreamSlot(int ID, int cflag, int tile)
+{
+  int            k;
+  int           *slot;
+  size_t         size;
+  long long      offset;
+  TerrainStream *ts = TERRAIN_PTR(ID)->stream;
+
+  size = (size_t)TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE*sizeof(float);
+  if (cflag) {
+    slot    = &(ts->c_slot[tile]);
+    size   *= TERRAIN_CTILE_N_LAYERS;
+    offset  = ts->h.c_offset;
+  } else {
+    slot    = &(ts->slot[tile]);
+    size   *= TERRAIN_TILE_N_LAYERS;
+    offset  = ts->h.offset;
+  }
+
+  k = *slot;
+
+  if (k < 0) {
+
+    // a free slot, or the slot of the least recently used tile
+    if (n_stream_loaded < max_stream_slots) {
+      for (k=0; stream_slots[k].ID != 0; ++k)
+	;
+      if (stream_slots[k].data == NULL)
+	stream_slots[k].data = (float *)
+	  my_calloc(TERRAIN_TILE_N_LAYERS*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE,
+		    sizeof(float),MY_STOP);
+    } else {
+      for (k=stream_lru_last; k>=0; k=stream_slots[k].prev)
+	if (releaseTerrainStreamSlot(k))
+	  break;
+      if (k < 0) {
+	printf("All tiles of the tile cache are pinned by contact queries\n");
+	return -1;
+      }
+    }
+
+#ifdef UNIX
+    if (pread(ts->fd,stream_slots[k].data,size,offset+(long long)tile*size) != (ssize_t)size) {
+#else
+    {
+#endif
+      printf("Cannot read tile %d of terrain %s\n",tile,TERRAIN_PTR(ID)->tfname);
+      return -1;
+    }
+
+    stream_slots[k].ID    = ID;
+    stream_slots[k].cflag = cflag;
+    stream_slots[k].tile  = tile;
+    stream_slots[k].prev  = -1;
+    stream_slots[k].next  = -1;
+    ++n_stream_loaded;
+
+    // publish the tile after its data is read
+    __atomic_store_n(slot,k,__ATOMIC_SEQ_CST);
+
+  } else if (k != stream_lru_first) {
+
+    // unlink the slot from the LRU list
+    stream_slots[stream_slots[k].prev].next = stream_slots[k].next;
+    if (stream_slots[k].next >= 0)
+      stream_slots[stream_slots[k].next].prev = stream_slots[k].prev;
+    else
+      stream_lru_last = stream_slots[k].prev;
+
+  } else
+
+    return k;
+
+  // the slot becomes the most recently used slot
+  stream_slots[k].prev = -1;
+  stream_slots[k].next = stream_lru_first;
+  if (stream_lru_first >= 0)
+    stream_slots[stream_lru_first].prev = k;
+  else
+    stream_lru_last = k;
+  stream_lru_first = k;
+
+  return k;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  releaseTerrainStreamSlot
+\date  Oct 2026
+   
+\remarks 
+
+        removes the tile of a slot from the tile cache, but keeps the memory
+        of the slot. The tile is withdrawn before the pins of the slot are
+        checked, and readTerrainStreamCellPinned() pins the slot before it
+        checks that the tile is still there. Thus, either the tile is kept 
+        for a contact query that pins it, or the query sees that the tile 
+        is gone. Must be called with mutex_stream locked.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     k       : the slot
+
+     returns TRUE if the tile was removed, or FALSE if the slot is pinned
+
+ ******************************************************************************/
+static int
+releaseTerrainStreamSlot(int k)
+{
+  int             *slot;
+  TerrainTileSlot *s = &(stream_slots[k]);
+  TerrainStream   *ts = TERRAIN_PTR(s->ID)->stream;
+
+  slot = s->cflag ? &(ts->c_slot[s->tile]) : &(ts->slot[s->tile]);
+
+  __atomic_store_n(slot,-1,__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&(s->pins),__ATOMIC_SEQ_CST) != 0) {
+    __atomic_store_n(slot,k,__ATOMIC_SEQ_CST);
+    return FALSE;
+  }
+
+  if (s->prev >= 0)
+    stream_slots[s->prev].next = s->next;
+  else
+    stream_lru_first = s->next;
+
+  if (s->next >= 0)
+    stream_slots[s->next].prev = s->prev;
+  else
+    stream_lru_last = s->prev;
+
+  s->ID = 0;
+  --n_stream_loaded;
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readTerrainStreamCell
+\date  Oct 2026
+   
+\remarks 
+
+        returns all layers of a cell of a streamed board, and loads the tile
+        of the cell if needed
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a cell of the contact grid
+ \param[in]     m       : x index of the cell
+ \param[in]     n       : y index of the cell
+ \param[out]    v       : the layers of the cell (TT_Z, ... or TT_C_Z, ...)
+
+        returns TRUE for success, and FALSE if the tile cannot be read
+
+ ******************************************************************************/
+static int
+readTerrainStreamCell(int ID, int cflag, int m, int n, float *v)
+{
+  int            k,l;
+  int            off;
+  int            n_layers;
+  int            tile;
+  float         *data;
+  TerrainStream *ts = TERRAIN_PTR(ID)->stream;
+
+  if (cflag) {
+    tile     = (m-1)/TERRAIN_STREAM_TILE + ((n-1)/TERRAIN_STREAM_TILE)*ts->c_n_tx;
+    n_layers = TERRAIN_CTILE_N_LAYERS;
+  } else {
+    tile     = (m-1)/TERRAIN_STREAM_TILE + ((n-1)/TERRAIN_STREAM_TILE)*ts->n_tx;
+    n_layers = TERRAIN_TILE_N_LAYERS;
+  }
+  off = ((m-1)%TERRAIN_STREAM_TILE)*TERRAIN_STREAM_TILE + (n-1)%TERRAIN_STREAM_TILE;
+
+  pthread_mutex_lock( &mutex_stream );
+
+  if ((k = getTerrainStreamSlot(ID,cflag,tile)) >= 0) {
+    data = stream_slots[k].data + off;
+    for (l=0; l<n_layers; ++l)
+      v[l] = data[l*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE];
+  }
+
+  pthread_mutex_unlock( &mutex_stream );
+
+  return (k >= 0);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readTerrainStreamCellPinned
+\date  Oct 2026
+   
+\remarks 
+
+        returns all layers of a cell of the contact grid of a streamed board
+        if its tile is in the tile cache. The tile is pinned while the cell
+        is copied, such that this function neither locks mutex_stream nor 
+        reads the file, and it can be used by the contact threads during a
+        simulation step.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     m       : x index of the cell
+ \param[in]     n       : y index of the cell
+ \param[out]    v       : the layers of the cell (TT_C_Z, ...)
+
+        returns TRUE for success, and FALSE if the tile is not loaded
+
+ ******************************************************************************/
+static int
+readTerrainStreamCellPinned(int ID, int m, int n, float *v)
+{
+  int            k,l;
+  int            tile;
+  int           *slot;
+  float         *data;
+  TerrainStream *ts = TERRAIN_PTR(ID)->stream;
+
+  tile = (m-1)/TERRAIN_STREAM_TILE + ((n-1)/TERRAIN_STREAM_TILE)*ts->c_n_tx;
+  slot = &(ts->c_slot[tile]);
+
+  if ((k = __atomic_load_n(slot,__ATOMIC_SEQ_CST)) < 0)
+    return FALSE;
+
+  // pin the slot, and check that it still holds the tile
+  __atomic_add_fetch(&(stream_slots[k].pins),1,__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(slot,__ATOMIC_SEQ_CST) != k) {
+    __atomic_sub_fetch(&(stream_slots[k].pins),1,__ATOMIC_SEQ_CST);
+    return FALSE;
+  }
+
+  data = stream_slots[k].data + 
+    ((m-1)%TERRAIN_STREAM_TILE)*TERRAIN_STREAM_TILE + (n-1)%TERRAIN_STREAM_TILE;
+  for (l=0; l<TERRAIN_CTILE_N_LAYERS; ++l)
+    v[l] = data[l*TERRAIN_STREAM_TILE*TERRAIN_STREAM_TILE];
+
+  __atomic_sub_fetch(&(stream_slots[k].pins),1,__ATOMIC_RELEASE);
+
+  return TRUE;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  loadTerrainStreamTiles
+\date  Oct 2026
+   
+\remarks 
+
+        loads all tiles of a streamed board which overlap with a range of 
+        cells into the tile cache
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for the contact grid
+ \param[in]     sx,ex   : range of x indices of the cells
+ \param[in]     sy,ey   : range of y indices of the cells
+
+ ******************************************************************************/
+static void
+loadTerrainStreamTiles(int ID, int cflag, int sx, int ex, int sy, int ey)
+{
+  int            i,j;
+  int            n_tx;
+  TerrainStream *ts = TERRAIN_PTR(ID)->stream;
+
+  n_tx = cflag ? ts->c_n_tx : ts->n_tx;
+
+  sx = (sx-1)/TERRAIN_STREAM_TILE;
+  ex = (ex-1)/TERRAIN_STREAM_TILE;
+  sy = (sy-1)/TERRAIN_STREAM_TILE;
+  ey = (ey-1)/TERRAIN_STREAM_TILE;
+
+  pthread_mutex_lock( &mutex_stream );
+
+  if ((ex-sx+1)*(ey-sy+1) > max_stream_slots)
+    printf("Region of %d tiles of terrain %s exceeds the tile cache of %d tiles\n",
+	   (ex-sx+1)*(ey-sy+1),TERRAIN_PTR(ID)->tfname,max_stream_slots);
+
+  for (i=sx; i<=ex; ++i)
+    for (j=sy; j<=ey; ++j)
+      getTerrainStreamSlot(ID,cflag,i+j*n_tx);
+
+  pthread_mutex_unlock( &mutex_stream );
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  compactTerrainBoard
+\date  Oct 2026
+   
+\remarks 
+
+        converts the layers of a terrain board into compact layers. All
+        terrain info of the board is cached first. Heights, normals, and 
+        the nMSE are quantized to 16 bit, the z component of the normals is
+        derived from the x and y components, the heights of the padding of
+        the contact grid are derived from a plane, and no_go layers with only
+        0 and 1 are kept as bitsets. The float layers and the local board
+        are freed, which reduces the memory of the board by about a factor
+        of four. Compact boards cannot be modified anymore, such that 
+        fillTerrainPadding() should be called before. Like adding a board, 
+        this must not be done while other threads query the terrain.
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+     returns TRUE for success, and FALSE for failure
+
+ ******************************************************************************/
+int
+compactTerrainBoard(int ID)
+{
+  int             i,j,k,l;
+  double          z[3];
+  double          z_min,z_max;
+  double          e_min,e_max;
+  double          c_min,c_max;
+  double          mb_float,mb_compact;
+  Terrain        *t;
+  TerrainCompact *tc;
+
+  if (ID < 1 || ID > n_terrains) {
+    printf("Terrain %d out of range of terrains from 1-%d\n",ID,n_terrains);
+    return FALSE;
+  }
+
+  t = TERRAIN_PTR(ID);
+
+  if (!t->status)
+    return FALSE;
+
+  if (t->compact != NULL)
+    return TRUE;
+
+  if (t->stream != NULL) {
+    printf("Terrain %d is streamed and cannot be compacted\n",ID);
+    return FALSE;
+  }
+
+  // cache all terrain info with the caching threads and this thread
+  cacheTerrainInfo();
+  for (k=0; k<t->n_tx*t->n_ty; ++k)
+    waitForTerrainTile(ID,FALSE,k);
+  for (k=0; k<t->c_n_tx*t->c_n_ty; ++k)
+    waitForTerrainTile(ID,TRUE,k);
+
+  // the ranges of the quantized layers
+  z_min = e_min = c_min =  1.e10;
+  z_max = e_max = c_max = -1.e10;
+
+  for (i=1; i<=t->nx; ++i)
+    for (j=1; j<=t->ny; ++j) {
+      z[0] = t->z[i][j];
+      z[1] = t->pz[i][j];
+      z[2] = t->fz[i][j];
+      for (l=0; l<3; ++l) {
+	if (z[l] == EMPTY_TERRAIN)
+	  continue;
+	if (z[l]-t->pos.x[_Z_] < z_min)
+	  z_min = z[l]-t->pos.x[_Z_];
+	if (z[l]-t->pos.x[_Z_] > z_max)
+	  z_max = z[l]-t->pos.x[_Z_];
+      }
+      if (t->n_nMSE[i][j] < e_min)
+	e_min = t->n_nMSE[i][j];
+      if (t->n_nMSE[i][j] > e_max)
+	e_max = t->n_nMSE[i][j];
+    }
+
+  for (i=1+t->c_padx; i<=t->c_nx-t->c_padx; ++i)
+    for (j=1+t->c_pady; j<=t->c_ny-t->c_pady; ++j) {
+      if (t->c_z[i][j] < c_min)
+	c_min = t->c_z[i][j];
+      if (t->c_z[i][j] > c_max)
+	c_max = t->c_z[i][j];
     }
 
-    for (i=t->padx+1; i<=t->nx-t->padx; ++i) {
-      for (j=1; j<=t->pady; ++j) {
-	// compute query in world coordinates
-	vl[_X_] = (i-1)*t->dx+t->xorg;
-	vl[_Y_] = (j-1)*t->dy+t->yorg;
-	vl[_Z_] = 0.0;
-	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
-	t->z[i][j] = tinfo.z;
-	//t->z[i][j] = ground_level_z;
-      }
+  tc = (TerrainCompact *)my_calloc(1,sizeof(TerrainCompact),MY_STOP);
+  setTerrainQuant(&(tc->q_z),z_min,z_max);
+  setTerrainQuant(&(tc->q_n),-1.0,1.0);
+  setTerrainQuant(&(tc->q_nMSE),e_min,e_max);
+  setTerrainQuant(&(tc->q_cz),c_min,c_max);
+
+  // the terrain grid
+  tc->cells = (TerrainCompactCell *)
+    my_calloc(t->nx*t->ny,sizeof(TerrainCompactCell),MY_STOP);
+
+  for (i=1; i<=t->nx; ++i)
+    for (j=1; j<=t->ny; ++j) {
+      k = (i-1)*t->ny + j-1;
+      z[0] = t->z[i][j];
+      z[1] = t->pz[i][j];
+      z[2] = t->fz[i][j];
+      for (l=0; l<3; ++l)
+	if (z[l] != EMPTY_TERRAIN)
+	  z[l] -= t->pos.x[_Z_];
+      tc->cells[k].z      = quantizeTerrain(&(tc->q_z),z[0]);
+      tc->cells[k].pz     = quantizeTerrain(&(tc->q_z),z[1]);
+      tc->cells[k].fz     = quantizeTerrain(&(tc->q_z),z[2]);
+      tc->cells[k].n_x    = quantizeTerrain(&(tc->q_n),t->n_x[i][j]);
+      tc->cells[k].n_y    = quantizeTerrain(&(tc->q_n),t->n_y[i][j]);
+      tc->cells[k].n_nMSE = quantizeTerrain(&(tc->q_nMSE),t->n_nMSE[i][j]);
     }
-    
-    for (i=t->padx+1; i<=t->nx-t->padx; ++i) {
-      for (j=t->ny-t->pady+1; j<=t->ny; ++j) {
-	// compute query in world coordinates
-	vl[_X_] = (i-1)*t->dx+t->xorg;
-	vl[_Y_] = (j-1)*t->dy+t->yorg;
-	vl[_Z_] = 0.0;
-	getTerrainInfoSwitched(vl[_X_], vl[_Y_], TRUE, TRUE, &tinfo);
-	t->z[i][j] = tinfo.z;
-	//t->z[i][j] = ground_level_z;
-      }
+
+  compactTerrainNoGo(t->no_go,t->nx,t->ny,&(tc->no_go));
+
+  // the contact grid
+  tc->c_cells = (TerrainCompactCCell *)
+    my_calloc(t->c_nx*t->c_ny,sizeof(TerrainCompactCCell),MY_STOP);
+
+  for (i=1; i<=t->c_nx; ++i)
+    for (j=1; j<=t->c_ny; ++j) {
+      k = (i-1)*t->c_ny + j-1;
+      if (i > t->c_padx && i <= t->c_nx-t->c_padx &&
+	  j > t->c_pady && j <= t->c_ny-t->c_pady)
+	tc->c_cells[k].c_z = quantizeTerrain(&(tc->q_cz),t->c_z[i][j]);
+      tc->c_cells[k].cn_x = quantizeTerrain(&(tc->q_n),t->cn_x[i][j]);
+      tc->c_cells[k].cn_y = quantizeTerrain(&(tc->q_n),t->cn_y[i][j]);
     }
 
-    printf(" done\n");
-    
+  compactTerrainNoGo(t->c_no_go,t->c_nx,t->c_ny,&(tc->c_no_go));
+
+  // the padding of the contact grid is a plane through the ground in world
+  // coordinates, which is recovered from its corners
+  if (t->c_padx > 0 || t->c_pady > 0) {
+    tc->c_z0 = t->c_z[1][1];
+    tc->c_zx = (t->c_z[t->c_nx][1] - t->c_z[1][1])/(double)(t->c_nx-1);
+    tc->c_zy = (t->c_z[1][t->c_ny] - t->c_z[1][1])/(double)(t->c_ny-1);
   }
 
+  // the memory of the layers before and after
+  mb_float = ((double)t->nx*t->ny*(8*sizeof(float)+sizeof(int)) +
+	      (double)t->c_nx*t->c_ny*(5*sizeof(float)+sizeof(int)) +
+	      (double)t->nx_local*t->ny_local*2*sizeof(float))/1.e6;
+  mb_compact = ((double)t->nx*t->ny*sizeof(TerrainCompactCell) + 
+		(double)t->c_nx*t->c_ny*sizeof(TerrainCompactCCell))/1.e6;
+  mb_compact += ((tc->no_go.bits != NULL) ? 
+		 (double)((t->nx*t->ny+31)/32)*sizeof(unsigned int) :
+		 (double)t->nx*t->ny*sizeof(unsigned short))/1.e6;
+  mb_compact += ((tc->c_no_go.bits != NULL) ? 
+		 (double)((t->c_nx*t->c_ny+31)/32)*sizeof(unsigned int) :
+		 (double)t->c_nx*t->c_ny*sizeof(unsigned short))/1.e6;
+
+  // replace the layers while the caching threads are paused
+  pauseTerrainCache();
+  dropTerrainCacheJobs(ID);
+  freeTerrainLayers(ID);
+  t->compact = tc;
+  resumeTerrainCache();
+
+  printf("Compacted terrain board %d (%s) from %.2f MB to %.2f MB\n",
+	 ID,t->tfname,mb_float,mb_compact);
+
+  return TRUE;
 }
 
 /*!*****************************************************************************
  *******************************************************************************
-\note  read_terrain_file
-\date  April 2006
+\note  readTerrainCell
+\date  Oct 2026
    
 \remarks 
 
-        reads a terrain file into a temporary array, and returns admin
-        variables
+        returns all layers of a cell of a streamed or compact board, with 
+        heights relative to the board origin
 
  *******************************************************************************
  Function Parameters: [in]=input,[out]=output
 
- \param[in]     fname   : terrain file name
- \param[in,out] array   : pointer to array -- memory will be allocated 
- \param[out]    nx      : number of x values in array
- \param[out]    ny      : number of y values in array
- \param[out]    min_x,max_x,min_y,max_y : min max values of array
- \param[in]     flag    : if TRUE binary terrain file is created if needed
-                     but nothing else is done or returned (i.e., array
-                     will not be allocated)
- \param[out]    count   : the number elements in array
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a cell of the contact grid
+ \param[in]     m       : x index of the cell
+ \param[in]     n       : y index of the cell
+ \param[out]    v       : the layers of the cell (TT_Z, ... or TT_C_Z, ...)
+
+        returns TRUE for success, and FALSE if the cell cannot be read
 
  ******************************************************************************/
-int
-read_terrain_file(char *fname, Matrix *array,
-		  int *nx, int *ny, double *min_x, double *max_x,
-		  double *min_y, double *max_y, int flag, int *count)
+static int
+readTerrainCell(int ID, int cflag, int m, int n, float *v)
+{
+  if (TERRAIN_PTR(ID)->compact != NULL) {
+    readTerrainCompactCell(ID,cflag,m,n,v);
+    return TRUE;
+  }
+
+  return readTerrainStreamCell(ID,cflag,m,n,v);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  readTerrainCompactCell
+\date  Oct 2026
+   
+\remarks 
 
+        returns all layers of a cell of a compact board, including the 
+        derived layers
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+ \param[in]     cflag   : TRUE for a cell of the contact grid
+ \param[in]     m       : x index of the cell
+ \param[in]     n       : y index of the cell
+ \param[out]    v       : the layers of the cell (TT_Z, ... or TT_C_Z, ...)
+
+ ******************************************************************************/
+static void
+readTerrainCompactCell(int ID, int cflag, int m, int n, float *v)
 {
-  int     i,j,rc;
-  FILE   *fp;
-  double  x,y,z,no_go;
-  char    string[100];
-  char    command[1000];
-  Matrix  temp;
-  int     temp_size = 500000;
-  char    c;
-  int     ic;
-  int     n_line_items=3;
-  struct  stat sobj;
-  struct  stat s;
-  struct  stat sbin;
+  int                  k;
+  double               n_x,n_y,aux;
+  Terrain             *t  = TERRAIN_PTR(ID);
+  TerrainCompact      *tc = t->compact;
+  TerrainCompactCell  *c;
+  TerrainCompactCCell *cc;
+
+  if (cflag) {
+
+    k  = (m-1)*t->c_ny + n-1;
+    cc = &(tc->c_cells[k]);
+
+    if (m <= t->c_padx || m > t->c_nx-t->c_padx || n <= t->c_pady || n > t->c_ny-t->c_pady)
+      v[TT_C_Z] = tc->c_z0 + tc->c_zx*(m-1) + tc->c_zy*(n-1);
+    else
+      v[TT_C_Z] = dequantizeTerrain(&(tc->q_cz),cc->c_z);
+    v[TT_C_NO_GO] = getTerrainNoGo(&(tc->c_no_go),k);
+
+    n_x = dequantizeTerrain(&(tc->q_n),cc->cn_x);
+    n_y = dequantizeTerrain(&(tc->q_n),cc->cn_y);
+    aux = 1.0 - n_x*n_x - n_y*n_y;
+    v[TT_CN_X] = n_x;
+    v[TT_CN_Y] = n_y;
+    v[TT_CN_Z] = (aux > 0.0) ? sqrt(aux) : 0.0;
+
+  } else {
+
+    k = (m-1)*t->ny + n-1;
+    c = &(tc->cells[k]);
+
+    v[TT_Z]      = dequantizeTerrain(&(tc->q_z),c->z);
+    v[TT_PZ]     = dequantizeTerrain(&(tc->q_z),c->pz);
+    v[TT_FZ]     = dequantizeTerrain(&(tc->q_z),c->fz);
+    v[TT_NO_GO]  = getTerrainNoGo(&(tc->no_go),k);
+    v[TT_N_NMSE] = dequantizeTerrain(&(tc->q_nMSE),c->n_nMSE);
+
+    n_x = dequantizeTerrain(&(tc->q_n),c->n_x);
+    n_y = dequantizeTerrain(&(tc->q_n),c->n_y);
+    aux = 1.0 - n_x*n_x - n_y*n_y;
+    v[TT_N_X] = n_x;
+    v[TT_N_Y] = n_y;
+    v[TT_N_Z] = (aux > 0.0) ? sqrt(aux) : 0.0;
+
+  }
+
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  setTerrainQuant
+\date  Oct 2026
+   
+\remarks 
+
+        sets the 16 bit quantization of a layer for a range of values
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[out]    q       : the quantization
+ \param[in]     min     : min value of the layer
+ \param[in]     max     : max value of the layer
+
+ ******************************************************************************/
+static void
+setTerrainQuant(TerrainQuant *q, double min, double max)
+{
+  if (max < min) // no values
+    min = max = 0.0;
+
+  q->off   = min;
+  q->scale = (max - min)/(double)TERRAIN_QUANT_MAX;
+  if (q->scale == 0.0)
+    q->scale = 1.0;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  quantizeTerrain
+\date  Oct 2026
+   
+\remarks 
+
+        returns the 16 bit code of a value, where EMPTY_TERRAIN has its own
+        code
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     q       : the quantization
+ \param[in]     v       : the value
+
+ ******************************************************************************/
+static unsigned short
+quantizeTerrain(TerrainQuant *q, double v)
+{
+  double c;
+
+  if (v == EMPTY_TERRAIN)
+    return TERRAIN_QUANT_EMPTY;
+
+  c = rint((v - q->off)/q->scale);
+  if (c < 0.0)
+    c = 0.0;
+  if (c > TERRAIN_QUANT_MAX)
+    c = TERRAIN_QUANT_MAX;
+
+  return (unsigned short) c;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  dequantizeTerrain
+\date  Oct 2026
+   
+\remarks 
+
+        returns the value of a 16 bit code
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     q       : the quantization
+ \param[in]     c       : the code
+
+ ******************************************************************************/
+static double
+dequantizeTerrain(TerrainQuant *q, unsigned short c)
+{
+  if (c == TERRAIN_QUANT_EMPTY)
+    return EMPTY_TERRAIN;
+
+  return q->off + q->scale*c;
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  compactTerrainNoGo
+\date  Oct 2026
+   
+\remarks 
 
+        converts a no_go layer into a bitset if it only contains 0 and 1, 
+        and quantizes it to 16 bit otherwise, e.g., for boards with 
+        interpolated no_go values
 
-  // try to open the ascii version of file and check how many columns exist
-  fp = fopen(fname,"r");
-  if (fp != NULL) {
-    // test whether a no-go column exists
-    ic = 0;
-    while (ic < 100 && (string[ic++]=fgetc(fp)) != '\n')
-      ;
-    string[ic-1] = '\0';
-    if (sscanf(string,"%lf %lf %lf %lf",&x,&y,&z,&no_go) == 3)
-      n_line_items = 3;
-    else
-      n_line_items = 4;
-    fclose(fp);
-  }
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-  // try to open the noisy .xyz file
-  strcpy(string,fname);
-  i=strlen(string);
-  string[i-3]='x';
-  string[i-2]='y';
-  string[i-1]='z';
-  
-  if (stat(string,&sobj) == 0) { // the file exists
+ \param[in]     no_go   : the no_go layer
+ \param[in]     nx      : number of cells in x direction
+ \param[in]     ny      : number of cells in y direction
+ \param[out]    l       : the compact no_go layer
 
-    // check date in comparison to .asc file and regenerate .asc if needed
-    stat(fname,&s);
-    if (sobj.st_mtime > s.st_mtime || n_line_items != 4) // need update
-    {
-      snprintf(command, 1000, "xundegrade %s %s", string, fname);
-      printf("Trying to process noisy file with command: %s\n", command);
-      rc=system(command);
+ ******************************************************************************/
+static void
+compactTerrainNoGo(fMatrix no_go, int nx, int ny, TerrainNoGoLayer *l)
+{
+  int    i,j,k;
+  int    binary = TRUE;
+  double min =  1.e10;
+  double max = -1.e10;
+
+  for (i=1; i<=nx; ++i)
+    for (j=1; j<=ny; ++j) {
+      if (no_go[i][j] != 0.0 && no_go[i][j] != 1.0)
+	binary = FALSE;
+      if (no_go[i][j] < min)
+	min = no_go[i][j];
+      if (no_go[i][j] > max)
+	max = no_go[i][j];
     }
+
+  if (binary) {
+    l->bits = (unsigned int *)my_calloc((nx*ny+31)/32,sizeof(unsigned int),MY_STOP);
+    for (i=1; i<=nx; ++i)
+      for (j=1; j<=ny; ++j) {
+	k = (i-1)*ny + j-1;
+	if (no_go[i][j] != 0.0)
+	  l->bits[k/32] |= 1u << (k%32);
+      }
+  } else {
+    setTerrainQuant(&(l->q),min,max);
+    l->v = (unsigned short *)my_calloc(nx*ny,sizeof(unsigned short),MY_STOP);
+    for (i=1; i<=nx; ++i)
+      for (j=1; j<=ny; ++j)
+	l->v[(i-1)*ny + j-1] = quantizeTerrain(&(l->q),no_go[i][j]);
   }
 
-  // try to open *.obj version of file
-  strcpy(string,fname);
-  i=strlen(string);
-  string[i-3]='o';
-  string[i-2]='b';
-  string[i-1]='j';
+}
 
-  if (stat(string,&sobj) == 0) { // the file exists
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getTerrainNoGo
+\date  Oct 2026
+   
+\remarks 
 
-    // check date in comparison to .asc file and regenerate .asc if needed
-    stat(fname,&s);
-    if (sobj.st_mtime > s.st_mtime || n_line_items != 4) // need update
-      convertObj2Asc(string);
-  }
+        returns the no_go value of a cell of a compact no_go layer
 
-  // try to open binary version of file
-  sprintf(string,"%s.bin",fname);
-  fp = fopen(string,"r");
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-  if (fp != NULL) {
+ \param[in]     l       : the compact no_go layer
+ \param[in]     k       : index of the cell
 
-    // check whether the .bin file is still up to date 
-    stat(fname,&s);
-    stat(string,&sbin);
+ ******************************************************************************/
+static double
+getTerrainNoGo(TerrainNoGoLayer *l, int k)
+{
+  if (l->bits != NULL)
+    return (l->bits[k/32] >> (k%32)) & 1u;
 
-    if (s.st_mtime > sbin.st_mtime) { // process asc file
+  return dequantizeTerrain(&(l->q),l->v[k]);
+}
 
-      fclose(fp);
+/*!*****************************************************************************
+ *******************************************************************************
+\note  freeTerrainCompact
+\date  Oct 2026
+   
+\remarks 
 
-    } else { // continue processing bin file
+        frees the compact layers of a board
 
-      if (flag) {
-	fclose(fp);
-	return TRUE;
-      }
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-      rc=fscanf(fp,"%d %d %d %lf %lf %lf %lf",
-	     count,nx,ny,min_x,max_x,min_y,max_y);
-      fgetc(fp);
-      temp = my_matrix(1,*count,1,4);
-      fread_mat(fp,temp);
-      fclose(fp);
-      
-      *array = temp;
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
 
-      return TRUE;
+ ******************************************************************************/
+static void
+freeTerrainCompact(int ID)
+{
+  Terrain        *t  = TERRAIN_PTR(ID);
+  TerrainCompact *tc = t->compact;
+
+  free(tc->cells);
+  free(tc->c_cells);
+  if (tc->no_go.bits != NULL)
+    free(tc->no_go.bits);
+  if (tc->no_go.v != NULL)
+    free(tc->no_go.v);
+  if (tc->c_no_go.bits != NULL)
+    free(tc->c_no_go.bits);
+  if (tc->c_no_go.v != NULL)
+    free(tc->c_no_go.v);
+  free(tc);
+  t->compact = NULL;
 
-    }
+}
 
-  }
+/*!*****************************************************************************
+ *******************************************************************************
+\note  freeTerrainBoard
+\date  Oct 2026
+   
+\remarks 
 
-  // try to open the ascii version of file
-  fp = fopen(fname,"r");
-  if (fp == NULL) {
-    if (!flag)
-      printf("Cannot read terrain file >%s<\n",fname);
-    return FALSE;
-  }
+        frees all memory of a terrain board and marks it as inactive
 
-  *count = 0;
-  *max_x = -1.e10;
-  *min_x =  1.e10;
-  *max_y = -1.e10;
-  *min_y =  1.e10;
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-  temp    = my_matrix(1,temp_size,1,4);
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
 
-  // test whether a no-go column exists
-  ic = 0;
-  while (ic < 100 && (string[ic++]=fgetc(fp)) != '\n')
-    ;
-  string[ic-1] = '\0';
-  if (sscanf(string,"%lf %lf %lf %lf",&x,&y,&z,&no_go) == 3)
-    n_line_items = 3;
-  else
-    n_line_items = 4;
+ ******************************************************************************/
+static void
+freeTerrainBoard(int ID)
+{
+  int      gen;
+  Terrain *t = TERRAIN_PTR(ID);
 
-  //printf("string = >%s< %d\n",string,n_line_items);
+  t->status = FALSE;
 
-  rewind(fp);
+  freeTerrainLayers(ID);
+  if (t->stream != NULL)
+    closeTerrainTiles(ID);
+  if (t->compact != NULL)
+    freeTerrainCompact(ID);
 
+  // a new generation of the slot invalidates all handles of the board
+  gen = (t->gen+1) % (INT_MAX/TERRAIN_HANDLE_SLOTS);
+  bzero((void *)t,sizeof(Terrain));
+  t->gen = gen;
 
-  while (TRUE) {
+}
 
-    if (n_line_items == 3) {
-      if ((rc=fscanf(fp,"%lf %lf %lf",&x,&y,&z)) == EOF)
-	break;
-      no_go = FALSE;
-    } else {
-      if ((rc=fscanf(fp,"%lf %lf %lf %lf",&x,&y,&z,&no_go)) == EOF)
-	break;
-    }
+/*!*****************************************************************************
+ *******************************************************************************
+\note  freeTerrainLayers
+\date  Oct 2026
+   
+\remarks 
 
-    if (++(*count) > temp_size) {
-      mat_add_shape(&temp,100000,0);
-      temp_size += 100000;
-    }
-    temp[*count][1] = x;
-    temp[*count][2] = y;
-    temp[*count][3] = z;
-    temp[*count][4] = no_go;
+        frees the float layers of a terrain board, the local board, and the
+        caching state, but keeps the geometry of the board
 
-    if (x > *max_x)
-      *max_x = x;
-    if (x < *min_x)
-      *min_x = x;
-    if (y > *max_y)
-      *max_y = y;
-    if (y < *min_y)
-      *min_y = y;
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
+
+ ******************************************************************************/
+static void
+freeTerrainLayers(int ID)
+{
+  Terrain *t = TERRAIN_PTR(ID);
 
+  // the local board
+  if (t->grid != NULL) {
+    free(t->z_local);
+    free(t->no_go_local);
+#ifdef UNIX
+    munmap(t->grid->base,t->grid->size);
+#endif
+    free(t->grid);
+    t->grid = NULL;
+  } else {
+    if (t->z_local != NULL)
+      my_free_fmatrix(t->z_local,1,t->nx_local,1,t->ny_local);
+    if (t->no_go_local != NULL)
+      my_free_fmatrix(t->no_go_local,1,t->nx_local,1,t->ny_local);
+  }
+  t->z_local     = NULL;
+  t->no_go_local = NULL;
+
+  // the terrain in world coordinates
+  if (t->z != NULL) {
+    my_free_fmatrix(t->z,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->pz,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->fz,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->n_nMSE,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->n_x,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->n_y,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->n_z,1,t->nx,1,t->ny);
+    my_free_fmatrix(t->no_go,1,t->nx,1,t->ny);
+    my_free_imatrix(t->cached,1,t->nx,1,t->ny);
+    t->z = t->pz = t->fz = t->n_nMSE = t->n_x = t->n_y = t->n_z = t->no_go = NULL;
+    t->cached = NULL;
   }
 
-  fclose(fp);
+  // the contact terrain
+  if (t->c_z != NULL) {
+    my_free_fmatrix(t->c_z,1,t->c_nx,1,t->c_ny);
+    my_free_fmatrix(t->c_no_go,1,t->c_nx,1,t->c_ny);
+    my_free_fmatrix(t->cn_x,1,t->c_nx,1,t->c_ny);
+    my_free_fmatrix(t->cn_y,1,t->c_nx,1,t->c_ny);
+    my_free_fmatrix(t->cn_z,1,t->c_nx,1,t->c_ny);
+    my_free_imatrix(t->ccached,1,t->c_nx,1,t->c_ny);
+    t->c_z = t->c_no_go = t->cn_x = t->cn_y = t->cn_z = NULL;
+    t->ccached = NULL;
+  }
 
-  // determine the correct dimensions of the terrain file assuming a mm raster
-  *nx = rint(*max_x - *min_x) + 1;
-  *ny = rint(*max_y - *min_y) + 1;
+  if (t->tiles != NULL)
+    free(t->tiles);
+  if (t->ctiles != NULL)
+    free(t->ctiles);
+  t->tiles  = t->ctiles = NULL;
+  t->n_tx   = t->n_ty   = 0;
+  t->c_n_tx = t->c_n_ty = 0;
+  t->n_tiles_done = 0;
 
-  // fudge the matrix size -- this won't hurt anybody
-  temp[0][0] = *count;
+  freeTerrainSAT(&(t->sat));
+  freeTerrainSAT(&(t->c_sat));
 
-  // write terrain file as binary file for quicker future processing
-  sprintf(string,"%s.bin",fname);
-  fp = fopen(string,"w");
-  if (fp == NULL) {
-    printf("Cannot write terrain file >%s<\n",string);
-    return FALSE;
-  }
+}
 
-  fprintf(fp,"%d %d %d %lf %lf %lf %lf\n",
-	  *count,*nx,*ny,*min_x,*max_x,*min_y,*max_y);
-  fwrite_mat(fp,temp);
-  fclose(fp);
+/*!*****************************************************************************
+ *******************************************************************************
+\note  dropTerrainCacheJobs
+\date  Oct 2026
+   
+\remarks 
 
-  if (flag) {
-    my_free_matrix(temp,1,*count,1,4);
-    return TRUE;
-  }
+        removes the pending tiles of a board from the jobs of the caching 
+        threads. Must be called while the caching threads are paused.
 
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
 
-  *array = temp;
+ \param[in]     ID      : terrain array index ( between 1 and MAX_TERRAIN)
 
+ ******************************************************************************/
+static void
+dropTerrainCacheJobs(int ID)
+{
+  int i,k;
 
-  return TRUE;
+  pthread_mutex_lock( &mutex_cache );
+  for (i=k=next_cache_job; i<n_cache_jobs; ++i)
+    if (cache_jobs[i].ID != ID)
+      cache_jobs[k++] = cache_jobs[i];
+  n_cache_jobs = k;
+  pthread_mutex_unlock( &mutex_cache );
 
 }
 
@@ -1705,12 +5843,12 @@ getTerrainFileName(int ID, char *tfname)
   Terrain *t;  
 
   // check for validity of terrain index
-  if (ID < 1 || ID > MAX_TERRAINS) {
-    printf("Terrain %d out of range of terrains from 1-%d\n",ID,MAX_TERRAINS);
+  if (ID < 1 || ID > n_terrains) {
+    printf("Terrain %d out of range of terrains from 1-%d\n",ID,n_terrains);
     return FALSE;
   }
 
-  t = &(terrains[ID]);
+  t = TERRAIN_PTR(ID);
 
   if (!t->status)
     return FALSE;
@@ -1743,12 +5881,12 @@ setTerrainID(int ID, int tID)
   Terrain *t;  
 
   // check for validity of terrain index
-  if (ID < 1 || ID > MAX_TERRAINS) {
-    printf("Terrain %d out of range of terrains from 1-%d\n",ID,MAX_TERRAINS);
+  if (ID < 1 || ID > n_terrains) {
+    printf("Terrain %d out of range of terrains from 1-%d\n",ID,n_terrains);
     return FALSE;
   }
 
-  t = &(terrains[ID]);
+  t = TERRAIN_PTR(ID);
 
   if (!t->status)
     return FALSE;
@@ -1805,10 +5943,10 @@ getTerrainLocalCoordinatesID(double x, double y, double z, int tID,
 
   // loop over all terrain boards and try to find whether query point is
   // covered by the given board
-  for (i=1; i<=MAX_TERRAINS; ++i) {
+  for (i=1; i<=n_terrains; ++i) {
 
     // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+    t = TERRAIN_PTR(i);
 
     if (!t->status)
       continue;
@@ -1861,11 +5999,14 @@ getTerrainLocalCoordinatesID(double x, double y, double z, int tID,
 int
 getTerrainLocalCoordinates(double x, double y, int *tID, double *xl, double *yl)
 {
-  int           i,j,m,n,r;
+  int           j,k,m,n,r;
+  int           ks,ke;
   Terrain      *t;
+  TerrainIndex *idx;
   static int    firsttime = TRUE;
   static Matrix R;
   double        z;
+  float         cell[TERRAIN_TILE_N_LAYERS];
   static Vector v,vv;
 
   if (firsttime) {
@@ -1877,12 +6018,20 @@ getTerrainLocalCoordinates(double x, double y, int *tID, double *xl, double *yl)
 
   *tID = 0;
 
-  // loop over all terrain boards and try to find whether query point is
-  // covered by the given board
-  for (i=1; i<=MAX_TERRAINS; ++i) {
+  // loop over the terrain boards from the spatial index and try to find 
+  // whether query point is covered by the given board
+  idx = __atomic_load_n(&terrain_index,__ATOMIC_ACQUIRE);
+  if (idx != NULL) {
+    k  = getTerrainIndexBucket(idx,x,y);
+    ks = idx->start[k];
+    ke = idx->start[k+1];
+  } else
+    ks = ke = 0;
+
+  for (k=ks; k<ke; ++k) {
 
     // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+    t = TERRAIN_PTR(idx->ids[k]);
 
     if (!t->status)
       continue;
@@ -1892,9 +6041,15 @@ getTerrainLocalCoordinates(double x, double y, int *tID, double *xl, double *yl)
     n = rint((y - t->yorg)/t->dy) + 1;
     
     if (m >= 1 && m <= t->nx && n >=1 && n <=t->ny) {
+
+      if (TERRAIN_PRECOMPUTED(t)) {
+	if (!readTerrainCell(idx->ids[k], FALSE, m, n, cell))
+	  continue;
+	z = (cell[TT_Z] == EMPTY_TERRAIN) ? EMPTY_TERRAIN : cell[TT_Z] + t->pos.x[_Z_];
+      } else
+	z = t->z[m][n];
       
       *tID = t->ID;
-      z   = t->z[m][n];
       quatToRotMat(&(t->orient),R);      
       
       v[_X_] = x - t->pos.x[_X_];
@@ -1961,10 +6116,10 @@ getTerrainWorldCoordinatesID(double xl, double yl, double zl, int tID,
 
   // loop over all terrain boards and try to find whether query point is
   // covered by the given board
-  for (i=1; i<=MAX_TERRAINS; ++i) {
+  for (i=1; i<=n_terrains; ++i) {
 
     // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+    t = TERRAIN_PTR(i);
 
     if (!t->status)
       continue;
@@ -2022,10 +6177,10 @@ getContactTerrainMinMax(char *tfname,
   TerrainInfo  tinfo;
 
   // loop over all terrain boards 
-  for (i=1; i<=MAX_TERRAINS; ++i) {
+  for (i=1; i<=n_terrains; ++i) {
 
     // use a simpler variable for convenience and check for active terrain board
-    t = &(terrains[i]);
+    t = TERRAIN_PTR(i);
 
     if (!t->status)
       continue;
@@ -2046,6 +6201,58 @@ getContactTerrainMinMax(char *tfname,
   return FALSE;
 }
 
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getContactTerrainMaxZ
+\date  Oct 2026
+   
+\remarks 
+
+        returns the max height of the contact terrain in local coordinates,
+        i.e., no point above this height can be in contact with the terrain
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     tfname   : terrain file name
+ \param[out]    z_max    : max height
+
+ ******************************************************************************/
+int
+getContactTerrainMaxZ(char *tfname, double *z_max)
+{
+  return getContactTerrainMaxZByHandle(getContactTerrainHandle(tfname),z_max);
+}
+
+/*!*****************************************************************************
+ *******************************************************************************
+\note  getContactTerrainMaxZByHandle
+\date  Oct 2026
+   
+\remarks 
+
+        same as getContactTerrainMaxZ(), but with a terrain handle
+
+ *******************************************************************************
+ Function Parameters: [in]=input,[out]=output
+
+ \param[in]     h        : handle of the terrain from getContactTerrainHandle()
+ \param[out]    z_max    : max height
+
+ ******************************************************************************/
+int
+getContactTerrainMaxZByHandle(int h, double *z_max)
+{
+  Terrain *t;
+
+  if ((t = getTerrainByHandle(h)) == NULL)
+    return FALSE;
+
+  *z_max = t->c_max_z;
+
+  return TRUE;
+}
+
 /*!*****************************************************************************
  *******************************************************************************
 \note  computeMedian
@@ -2068,20 +6275,14 @@ static double
 computeMedian(double *v, int n_v) 
 {
   int i,j,n;
-  static Vector lv = NULL;
-  static int    n_lv = 0;
+  double lv[MAX_REGRESSION_DATA+1]; // local, as several threads can run this function
   double aux;
 
-  if (lv == NULL) {
-    lv   = my_vector(1,n_v);
-    n_lv = n_v;
+  if (n_v > MAX_REGRESSION_DATA) {
+    printf("Too many values for median computation\n");
+    return 0.0;
   }
 
-  if (n_lv < n_v) {
-    vec_add_shape(&lv, n_v-n_lv);
-    n_lv = n_v;
-  }
-  
   if (n_v%2 == 0)
     n = n_v/2+1;
   else
@@ -672,7 +672,8 @@ parseOptions(int argc, char**argv)
   // check for no-graphics flag
   no_graphics_flag = FALSE;
   for (i=1; i<argc; ++i) {
-    if (strcmp(argv[i],"-ng")==0) {
+    if (strcmp(argv[i],"-ng")==0 || strcmp(argv[i],"-no-graphics")==0 ||
+	strcmp(argv[i],"-headless")==0) {
       no_graphics_flag = TRUE;
       break;
     }
@@ -942,6 +942,10 @@ int
 sendUserGraphics(char *name, void *buf, int n_bytes)
 {
   int i,j;
+
+  // no graphics process to read the data
+  if (no_graphics_flag)
+    return TRUE;
   
   // send the user graphics data
   if (semTake(sm_user_graphics_sem,ns2ticks(1000000)) == ERROR) {